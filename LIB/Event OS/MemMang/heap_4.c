@@ -90,12 +90,12 @@
 /* 添加中断保护或者任务切换保护,由于OSAL无任务转换,故只需要屏蔽中断就行 */
 void vTaskSuspendAll( void )/* 禁止任务转换 */
 {
-	DISABLE_IRQ();
+	ENTER_CRITICAL();
 }
 
 void xTaskResumeAll( void )/* 使能任务切换 */
 {
-	ENABLE_IRQ();
+	EXIT_CRITICAL();
 }
 
 
@@ -156,6 +156,138 @@ static size_t xBlockAllocatedBit = 0;
 
 /*-----------------------------------------------------------*/
 
+#if( HEAP_TRACE == 1 )
+/*
+ * 二进制分配跟踪。记录按发生顺序存放在环形缓冲区中，由 vHeapTraceDump() 连同文件头一起导出，
+ * 格式与 tools/heap_replay.c 一致，字段均为小端。
+ */
+#define heapTRACE_MAGIC			0x43525448UL	/* "HTRC" */
+#define heapTRACE_VERSION		1
+#define heapTRACE_MALLOC		0
+#define heapTRACE_FREE			1
+
+typedef struct
+{
+	uint32_t ulMagic;
+	uint16_t usVersion;
+	uint16_t usRecordSize;
+	uint32_t ulHeapSize;		/* configTOTAL_HEAP_SIZE */
+	uint32_t ulHeapStart;		/* 对齐后的堆起始地址 */
+	uint16_t usHeaderSize;		/* 块头大小 xHeapStructSize */
+	uint16_t usAlignment;		/* portBYTE_ALIGNMENT */
+	uint32_t ulCount;			/* 后续记录条数 */
+	uint32_t ulDropped;			/* 缓冲区满而丢弃(或被覆盖)的记录数 */
+	uint32_t ulCycleHz;			/* 周期计数频率 */
+} HeapTraceHeader_t;
+
+typedef struct
+{
+	uint32_t ulTime;			/* 系统节拍(ms) */
+	uint32_t ulAddress;			/* 返回的地址,分配失败时为0 */
+	uint32_t ulCaller;			/* 调用者地址 */
+	uint16_t usSize;			/* 分配:申请的字节数;释放:块大小(含块头) */
+	uint16_t usCycles;			/* 调用耗时(周期),超过65535时饱和 */
+	uint8_t ucOp;				/* heapTRACE_MALLOC / heapTRACE_FREE */
+	uint8_t ucReserved[ 3 ];
+} HeapTraceRecord_t;
+
+static HeapTraceRecord_t xTraceRing[ HEAP_TRACE_DEPTH ];
+static uint32_t ulTraceCount = 0;		/* 已记录的条数(含被覆盖的) */
+static uint32_t ulTraceDropped = 0;
+static uint8_t ucTraceOn = 0;
+
+/* 记录一次分配或释放 */
+static void prvHeapTraceRecord( uint8_t ucOp, void *pv, size_t xSize, uint32_t ulCaller, uint32_t ulStart )
+{
+	HeapTraceRecord_t *pxRecord;
+	uint32_t ulCycles = HEAP_TRACE_CYCLES() - ulStart;
+
+	ENTER_CRITICAL();
+	if( ucTraceOn != 0 )
+	{
+		#if( HEAP_TRACE_WRAP == 0 )
+		if( ulTraceCount >= HEAP_TRACE_DEPTH )
+		{
+			ulTraceDropped++;
+			EXIT_CRITICAL();
+			return;
+		}
+		#else
+		if( ulTraceCount >= HEAP_TRACE_DEPTH )
+		{
+			ulTraceDropped++;
+		}
+		#endif
+		pxRecord = &xTraceRing[ ulTraceCount % HEAP_TRACE_DEPTH ];
+		ulTraceCount++;
+
+		pxRecord->ulTime = HEAP_TRACE_TIME();
+		pxRecord->ulAddress = ( uint32_t ) ( size_t ) pv;
+		pxRecord->ulCaller = ulCaller;
+		pxRecord->usSize = ( uint16_t ) xSize;
+		pxRecord->usCycles = ( ulCycles > 0xFFFFUL ) ? 0xFFFFU : ( uint16_t ) ulCycles;
+		pxRecord->ucOp = ucOp;
+	}
+	EXIT_CRITICAL();
+}
+
+/* 清空记录并开始跟踪,同时打开DWT周期计数 */
+void vHeapTraceStart( void )
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	ENTER_CRITICAL();
+	ulTraceCount = 0;
+	ulTraceDropped = 0;
+	ucTraceOn = 1;
+	EXIT_CRITICAL();
+}
+
+/* 停止跟踪,已有记录保留 */
+void vHeapTraceStop( void )
+{
+	ucTraceOn = 0;
+}
+
+/*
+ * 导出跟踪:先输出文件头,再按发生顺序输出记录,由 pfWrite 写到串口、文件等.
+ * 导出期间暂停跟踪,结束后恢复原状态.
+ */
+void vHeapTraceDump( void (*pfWrite)( const void *pvData, uint16_t usLen ) )
+{
+	HeapTraceHeader_t xHeader;
+	uint32_t ulFirst, ulCount, i;
+	uint8_t ucWasOn = ucTraceOn;
+
+	ucTraceOn = 0;
+
+	ulCount = ( ulTraceCount < HEAP_TRACE_DEPTH ) ? ulTraceCount : HEAP_TRACE_DEPTH;
+	ulFirst = ulTraceCount - ulCount;
+
+	xHeader.ulMagic = heapTRACE_MAGIC;
+	xHeader.usVersion = heapTRACE_VERSION;
+	xHeader.usRecordSize = sizeof( HeapTraceRecord_t );
+	xHeader.ulHeapSize = configTOTAL_HEAP_SIZE;
+	xHeader.ulHeapStart = ( ( uint32_t ) ( size_t ) ucHeap + ( portBYTE_ALIGNMENT - 1 ) ) & ~( ( uint32_t ) portBYTE_ALIGNMENT_MASK );
+	xHeader.usHeaderSize = ( uint16_t ) xHeapStructSize;
+	xHeader.usAlignment = portBYTE_ALIGNMENT;
+	xHeader.ulCount = ulCount;
+	xHeader.ulDropped = ulTraceDropped;
+	xHeader.ulCycleHz = SystemCoreClock;
+	pfWrite( &xHeader, sizeof( xHeader ) );
+
+	for( i = 0; i < ulCount; i++ )
+	{
+		pfWrite( &xTraceRing[ ( ulFirst + i ) % HEAP_TRACE_DEPTH ], sizeof( HeapTraceRecord_t ) );
+	}
+
+	ucTraceOn = ucWasOn;
+}
+#endif /* HEAP_TRACE */
+
+/*-----------------------------------------------------------*/
+
 /* 
 * pvPortMalloc函数用于从动态内存堆中分配指定大小的内存块
 * 参数xWantedSize指定所需内存块的大小
@@ -165,6 +297,10 @@ void *pvPortMalloc( size_t xWantedSize )
 {
     BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
     void *pvReturn = NULL;
+    #if( HEAP_TRACE == 1 )
+    uint32_t ulTraceStart = HEAP_TRACE_CYCLES();
+    size_t xRequestedSize = xWantedSize;
+    #endif
 
     // 关闭中断，确保原子操作
     vTaskSuspendAll();
@@ -241,6 +377,10 @@ void *pvPortMalloc( size_t xWantedSize )
     // 恢复中断状态
     ( void ) xTaskResumeAll();
 
+    #if( HEAP_TRACE == 1 )
+    prvHeapTraceRecord( heapTRACE_MALLOC, pvReturn, xRequestedSize, HEAP_TRACE_CALLER(), ulTraceStart );
+    #endif
+
     // 打印内存分配信息
     HEAP_PRINTF("\nMalloc->total:%d,size:%d\n",xFreeBytesRemaining,xWantedSize);
 
@@ -275,6 +415,10 @@ void vPortFree( void *pv )
     uint8_t *puc = ( uint8_t * ) pv;
     // 定义一个BlockLink_t类型的指针，用于指向内存块的管理信息。
     BlockLink_t *pxLink;
+    #if( HEAP_TRACE == 1 )
+    uint32_t ulTraceStart = HEAP_TRACE_CYCLES();
+    size_t xFreedSize;
+    #endif
 
     // 检查传入的指针是否为NULL，如果为NULL，则直接返回。
     if( pv != NULL )
@@ -292,6 +436,10 @@ void vPortFree( void *pv )
             {
                 // 清除内存块的已分配标记。
                 pxLink->xBlockSize &= ~xBlockAllocatedBit;
+                #if( HEAP_TRACE == 1 )
+                // 插入空闲链表时可能与后一块合并，先记下块大小。
+                xFreedSize = pxLink->xBlockSize;
+                #endif
 
                 // 暂停任务调度，以防止在更新内存管理结构时发生中断。
                 vTaskSuspendAll();
@@ -306,6 +454,10 @@ void vPortFree( void *pv )
                 // 恢复任务调度。
                 ( void ) xTaskResumeAll();
 
+                #if( HEAP_TRACE == 1 )
+                prvHeapTraceRecord( heapTRACE_FREE, pv, xFreedSize, HEAP_TRACE_CALLER(), ulTraceStart );
+                #endif
+
                 // 打印释放内存后的总可用内存和释放的内存块大小。
                 HEAP_PRINTF("\nFree->total:%d,size:%d\n",xFreeBytesRemaining,pxLink->xBlockSize);    
             }
@@ -30,6 +30,197 @@
 tsEvent gtEvent;
 volatile uint32_t gTimes=0;
 static uint8_t gFirstCreate = 0;
+
+/* 回调函数哈希 */
+#define EVNT_HASH(pf)	((uint16_t)(((size_t)(pf) >> 2) % EVNT_HASH_SIZE))
+
+/* 到期时刻a是否早于b,按差值比较,gTimes回绕后仍然正确 */
+#define EVNT_BEFORE(a, b)	((int32_t)((a) - (b)) < 0)
+
+/* 初始化事件表:全部槽放入空闲链,清空哈希表 */
+static void prvEventInit(void)
+{
+	uint16_t i;
+	
+	memset((uint8_t *)&gtEvent,0x00,sizeof(gtEvent));
+	for(i=0; i < EVNT_CONCURRENT; i++)
+		gtEvent.link[i] = i + 1;
+	gtEvent.link[EVNT_CONCURRENT - 1] = EVNT_NONE;
+	for(i=0; i < EVNT_HASH_SIZE; i++)
+		gtEvent.hash[i] = EVNT_NONE;
+	gtEvent.freeSlot = 0;
+}
+
+/* 把槽放到堆中的pos位置并记录其位置 */
+static void prvHeapPlace(uint16_t pos, uint16_t slot, uint32_t due)
+{
+	gtEvent.heap[pos] = slot;
+	gtEvent.heapDue[pos] = due;
+	gtEvent.heapPos[slot] = pos;
+}
+
+/* 堆中pos位置的槽向上调整 */
+static void prvHeapUp(uint16_t pos)
+{
+	uint16_t slot = gtEvent.heap[pos];
+	uint32_t due = gtEvent.heapDue[pos];
+	uint16_t parent;
+	
+	while(pos)
+	{
+		parent = (pos - 1) >> 1;
+		if(!EVNT_BEFORE(due, gtEvent.heapDue[parent]))
+			break;
+		prvHeapPlace(pos, gtEvent.heap[parent], gtEvent.heapDue[parent]);
+		pos = parent;
+	}
+	prvHeapPlace(pos, slot, due);
+}
+
+/* 堆中pos位置的槽向下调整 */
+static void prvHeapDown(uint16_t pos)
+{
+	uint16_t slot = gtEvent.heap[pos];
+	uint32_t due = gtEvent.heapDue[pos];
+	uint16_t count = gtEvent.count;
+	uint16_t child;
+	
+	while((child = (pos << 1) + 1) < count)
+	{
+		if((child + 1 < count) && EVNT_BEFORE(gtEvent.heapDue[child + 1], gtEvent.heapDue[child]))
+			child++;
+		if(!EVNT_BEFORE(gtEvent.heapDue[child], due))
+			break;
+		prvHeapPlace(pos, gtEvent.heap[child], gtEvent.heapDue[child]);
+		pos = child;
+	}
+	prvHeapPlace(pos, slot, due);
+}
+
+/* 重新设定槽的到期时刻并调整其在堆中的位置 */
+static void prvEventReschedule(uint16_t slot, uint32_t delay)
+{
+	uint16_t pos = gtEvent.heapPos[slot];
+	
+	gtEvent.heapDue[pos] = gTimes + delay;
+	prvHeapUp(pos);
+	prvHeapDown(gtEvent.heapPos[slot]);
+}
+
+/* 按回调函数查找事件,返回槽号,没有时返回EVNT_NONE */
+static uint16_t prvEventFind(tpEventFunc pFunction)
+{
+	uint16_t i = gtEvent.hash[EVNT_HASH(pFunction)];
+	
+	while((i != EVNT_NONE) && (gtEvent.pfFunc[i] != pFunction))
+		i = gtEvent.link[i];
+	return i;
+}
+
+/* 取一个空闲槽加入哈希表和堆,返回槽号,没有空闲槽时返回EVNT_NONE */
+static uint16_t prvEventAlloc(uint32_t delay, tpEventFunc pFunction, uint32_t param)
+{
+	uint16_t i = gtEvent.freeSlot;
+	uint16_t h = EVNT_HASH(pFunction);
+	
+	if(i == EVNT_NONE)
+		return EVNT_NONE;
+	gtEvent.freeSlot = gtEvent.link[i];
+	
+	gtEvent.id[i] = (gTimes<<12) | i;
+	gtEvent.pfFunc[i] = pFunction;
+	gtEvent.param[i] = param;
+	
+	gtEvent.link[i] = gtEvent.hash[h];	/* 加入哈希链首 */
+	gtEvent.prev[i] = EVNT_NONE;
+	if(gtEvent.hash[h] != EVNT_NONE)
+		gtEvent.prev[gtEvent.hash[h]] = i;
+	gtEvent.hash[h] = i;
+	
+	prvHeapPlace(gtEvent.count, i, gTimes + delay);	/* 加入堆尾再向上调整 */
+	gtEvent.count++;
+	prvHeapUp(gtEvent.heapPos[i]);
+	
+	#if (EN_IDLE_TASK == 1) && (DEFAULT_IDLE_TASK == 1) && \
+		(OS_DEBUG_LEVEL != CLOSE) && (OS_DEBUG_LEVEL != ERROR)
+		if(gtEvent.maxEvent < gtEvent.count)
+		{
+			gtEvent.maxEvent = gtEvent.count;
+			OS_DEBUG_PRINTF("MaxEvent=%d,UsePercentage=%d%%\r\n\r\n",gtEvent.maxEvent,(gtEvent.maxEvent*100)/EVNT_CONCURRENT);
+		}
+	#endif
+	return i;
+}
+
+/* 把槽从哈希表和堆中移除并放回空闲链 */
+static void prvEventFree(uint16_t slot)
+{
+	uint16_t next = gtEvent.link[slot];
+	uint16_t pos = gtEvent.heapPos[slot];
+	uint16_t last;
+	
+	if(gtEvent.prev[slot] == EVNT_NONE)	/* 从哈希链中摘除 */
+		gtEvent.hash[EVNT_HASH(gtEvent.pfFunc[slot])] = next;
+	else
+		gtEvent.link[gtEvent.prev[slot]] = next;
+	if(next != EVNT_NONE)
+		gtEvent.prev[next] = gtEvent.prev[slot];
+	
+	gtEvent.count--;					/* 用堆尾的槽填补空位 */
+	if(pos != gtEvent.count)
+	{
+		last = gtEvent.heap[gtEvent.count];
+		prvHeapPlace(pos, last, gtEvent.heapDue[gtEvent.count]);
+		prvHeapUp(pos);
+		prvHeapDown(gtEvent.heapPos[last]);
+	}
+	
+	gtEvent.pfFunc[slot] = NULL;
+	gtEvent.id[slot] = 0;
+	gtEvent.param[slot] = 0;
+	gtEvent.link[slot] = gtEvent.freeSlot;
+	gtEvent.freeSlot = slot;
+}
+
+/* 按ID查找事件,返回槽号,没有时返回EVNT_NONE */
+static uint16_t prvEventForId(uint32_t eventId)
+{
+	uint16_t id;
+	
+	id = eventId&0xfff;
+	
+	if(id >= EVNT_CONCURRENT)
+		return EVNT_NONE;
+	
+	if(gtEvent.id[id] != eventId)	/* 无事件 */
+		return EVNT_NONE;
+	
+	if(gtEvent.pfFunc[id] == NULL)	/* 事件未被创建 */
+		return EVNT_NONE;
+	
+	return id;
+}
+
+/* 将以mS为单位的延时转换为TICK数 */
+static uint32_t prvEventTicks(uint32_t delayMs)
+{
+	uint32_t tempDelay;
+	
+	/* 将绝对延时时间转换为相对延时 */	
+	#if(TICK_CYCLICITY_US == 1000u)		/* ==1mS */			
+		tempDelay = delayMs;
+	#elif(TICK_CYCLICITY_US > 1000u)	/* 大于1mS */
+		tempDelay = delayMs / (TICK_CYCLICITY_US / 1000u);	
+	#else								/* 小于1mS */
+		tempDelay = delayMs * (1000u / TICK_CYCLICITY_US);	
+	#endif
+	
+	/* 检查延时周期是否为1,如果为1,再加1,防止运行时间严重变短,程序异常 */
+	if(tempDelay == 1)
+		tempDelay++;
+	return tempDelay;
+}
+
 /**
 *	function:	Create Event 
 *	采用回调函数方式操作事件,同一个回调函数不能被创建多次
@@ -49,54 +240,38 @@ bool create_event(uint32_t delayMs, tpEventFunc pFunction, uint32_t param)
 	uint16_t i;
 	uint32_t tempDelay;	
 	
-	/* 将绝对延时时间转换为相对延时 */	
-	#if(TICK_CYCLICITY_US == 1000u)		/* ==1mS */			
-		tempDelay = delayMs;
-	#elif(TICK_CYCLICITY_US > 1000u)	/* 大于1mS */
-		tempDelay = delayMs / (TICK_CYCLICITY_US / 1000u);	
-	#else								/* 小于1mS */
-		tempDelay = delayMs * (1000u / TICK_CYCLICITY_US);	
-	#endif
-	
-	/* 检查延时周期是否为1,如果为1,再加1,防止运行时间严重变短,程序异常 */
-	if(tempDelay == 1)
-		tempDelay++;
+	tempDelay = prvEventTicks(delayMs);
 	
 	if(NULL == pFunction)				/* 空指针返回错误  */
 		return false;
 	
+	ENTER_CRITICAL();
 	/* 第一次创建事件,初始化事件相关标识  */	
 	if(!gFirstCreate)	
 	{
 		/* 初始化任务相关标识 */
 		gFirstCreate = 1;
-		memset((uint8_t *)&gtEvent,0x00,sizeof(gtEvent));
+		prvEventInit();
 	}
 	
 	/* 创建事件之前先查找是否有正在运行的事件,如果有事件重置延时,不允许同一事件被多次创建 */
-	for(i=0; i < EVNT_CONCURRENT; i++)
+	i = prvEventFind(pFunction);
+	if(i != EVNT_NONE)	/* 此位置的事件是我们要找的事件 */
 	{
-		if(gtEvent.pfFunc[i] == pFunction)	/* 此位置的事件是我们要找的事件 */
-		{
-			OS_INFO_PRINTF("resettingEvent,Id=%d,pFunction=%x\r\n",i,(uint32_t)pFunction);
-			gtEvent.delayTime[i] = tempDelay;	/*  重置运行时间 	*/
-			gtEvent.param[i] = param;
-			return true	;
-		}
-	}	
-	/* 创建事件之前先查找是否有正在运行的事件,如果有事件重置延时,不允许同一事件被多次创建 */
-	for(i=0; i < EVNT_CONCURRENT; i++)
+		OS_INFO_PRINTF("resettingEvent,Id=%d,pFunction=%x\r\n",i,(uint32_t)pFunction);
+		prvEventReschedule(i, tempDelay);	/*  重置运行时间 	*/
+		gtEvent.param[i] = param;
+		EXIT_CRITICAL();
+		return true	;
+	}
+	/* 创建新的事件 */
+	i = prvEventAlloc(tempDelay, pFunction, param);
+	EXIT_CRITICAL();
+	if(i != EVNT_NONE)
 	{
-		if(gtEvent.pfFunc[i] == NULL)	/* 创建新的事件 */
-		{
-			OS_INFO_PRINTF("\r\ncreateEventSuccess,Id=%d,pFunction=%x\r\n",i,(uint32_t)pFunction);	
-			gtEvent.id[i] = (gTimes<<12) | i;				
-			gtEvent.delayTime[i] = tempDelay;	
-			gtEvent.pfFunc[i] = pFunction;
-			gtEvent.param[i] = param;
-			return true;		
-		}
-	}		
+		OS_INFO_PRINTF("\r\ncreateEventSuccess,Id=%d,pFunction=%x\r\n",i,(uint32_t)pFunction);	
+		return true;		
+	}
 	OS_ERR_PRINTF("\r\n\r\ncreateEventFalse,pleaseCheck \"EVNT_CONCURRENT\"=%d\r\n\r\n",EVNT_CONCURRENT);
 	return false;
 }
@@ -117,18 +292,16 @@ bool clean_event(tpEventFunc pFunction)
 	/* 不允许创建空指针回调函数 */
 	if(pFunction == NULL)
 		return false;		
-	for(i=0; i<EVNT_CONCURRENT; i++)
+	ENTER_CRITICAL();
+	i = gFirstCreate ? prvEventFind(pFunction) : EVNT_NONE;
+	if(i != EVNT_NONE)	/* 事件已经被创建 */
 	{
-		if(gtEvent.pfFunc[i] == pFunction)	/* 事件已经被创建 */
-		{
-			OS_INFO_PRINTF("CleanEventSuccess,Id=%d,pFunction=%x\r\n",i,(uint32_t)pFunction);			
-			gtEvent.pfFunc[i] = NULL;
-			gtEvent.id[i] = 0;
-			gtEvent.delayTime[i] = 0;
-			gtEvent.param[i] = 0;			
-			return true;			
-		}
+		prvEventFree(i);
+		EXIT_CRITICAL();
+		OS_INFO_PRINTF("CleanEventSuccess,Id=%d,pFunction=%x\r\n",i,(uint32_t)pFunction);			
+		return true;			
 	}
+	EXIT_CRITICAL();
 	OS_DEBUG_PRINTF("EventIsNotCreated\r\n");
 	return false;
 }
@@ -150,44 +323,30 @@ bool clean_event(tpEventFunc pFunction)
 uint32_t create_events(uint32_t delayMs, tpEventFunc pFunction, uint32_t param)
 {
 	uint16_t i;
-	uint32_t tempDelay;	
+	uint32_t tempDelay, id;	
 	
-	/* 将绝对延时时间转换为相对延时 */	
-	#if(TICK_CYCLICITY_US == 1000u)		/* ==1mS */			
-		tempDelay = delayMs;
-	#elif(TICK_CYCLICITY_US > 1000u)	/* 大于1mS */
-		tempDelay = delayMs / (TICK_CYCLICITY_US / 1000u);	
-	#else								/* 小于1mS */
-		tempDelay = delayMs * (1000u / TICK_CYCLICITY_US);	
-	#endif
-	
-	/* 检查延时周期是否为1,如果为1,再加1,防止运行时间严重变短,程序异常 */
-	if(tempDelay == 1)
-		tempDelay++;
+	tempDelay = prvEventTicks(delayMs);
 	
 	if(NULL == pFunction)				/* 空指针返回错误  */
 		return false;
 	
+	ENTER_CRITICAL();
 	/* 第一次创建事件,初始化事件相关标识  */	
 	if(!gFirstCreate)	
 	{
 		/* 初始化任务相关标识 */
 		gFirstCreate = 1;
-		memset((uint8_t *)&gtEvent,0x00,sizeof(gtEvent));
+		prvEventInit();
 	}
 	
 	/* 创建新的事件 */
-	for(i=0; i < EVNT_CONCURRENT; i++)
+	i = prvEventAlloc(tempDelay, pFunction, param);
+	id = (i != EVNT_NONE) ? gtEvent.id[i] : 0;
+	EXIT_CRITICAL();
+	if(i != EVNT_NONE)
 	{
-		if(gtEvent.pfFunc[i] == NULL)	/* 此位置的事件是我们要找的事件 */
-		{
-			OS_INFO_PRINTF("\r\ncreateEventSuccess,Id=%d,pFunction=%x\r\n",i,(uint32_t)pFunction);
-			gtEvent.id[i] = (gTimes<<12) | i;		
-			gtEvent.delayTime[i] = tempDelay;	
-			gtEvent.pfFunc[i] = pFunction;
-			gtEvent.param[i] = param;
-			return gtEvent.id[i];
-		}
+		OS_INFO_PRINTF("\r\ncreateEventSuccess,Id=%d,pFunction=%x\r\n",i,(uint32_t)pFunction);
+		return id;
 	}	
 	OS_ERR_PRINTF("\r\n\r\ncreateEventFalse,pleaseCheck \"EVNT_CONCURRENT\"=%d\r\n\r\n",EVNT_CONCURRENT);
 	return 0;
@@ -203,20 +362,7 @@ uint32_t create_events(uint32_t delayMs, tpEventFunc pFunction, uint32_t param)
 **/
 bool search_event_for_id(uint32_t eventId)
 {
-	uint16_t id;
-	
-	id = eventId&0xfff;
-	
-	if(id >= EVNT_CONCURRENT)
-		return false;
-	
-	if(gtEvent.id[id] != eventId)	/* 无事件 */
-		return false;			
-	
-	if(gtEvent.pfFunc[id] != NULL)		/* 事件已经被创建 */
-		return true;			
-	
-	return false;
+	return prvEventForId(eventId) != EVNT_NONE;
 }
 
 /**
@@ -231,20 +377,12 @@ bool rst_event_for_id(uint32_t eventId, uint32_t delayMs)
 {
 	uint16_t id;
 	
-	id = eventId&0xfff;
-	
-	if(id >= EVNT_CONCURRENT)
-		return false;
-	
-	if(gtEvent.id[id] != eventId)	/* 无事件 */
-		return false;			
-	
-	if(gtEvent.pfFunc[id] != NULL)	/* 事件已经被创建 */
-	{		
-		gtEvent.delayTime[id] = delayMs;	
-		return true;			
-	}
-	return false;
+	ENTER_CRITICAL();
+	id = prvEventForId(eventId);
+	if(id != EVNT_NONE)	/* 事件已经被创建 */
+		prvEventReschedule(id, delayMs);
+	EXIT_CRITICAL();
+	return id != EVNT_NONE;
 }
 
 /**
@@ -259,27 +397,17 @@ bool clean_event_for_id(uint32_t eventId)
 {
 	uint16_t id;
 	
-	id = eventId&0xfff;
-	
-	if(id >= EVNT_CONCURRENT)
-		return false;
-	
-	if(gtEvent.id[id] != eventId)	/* 无事件 */
-		return false;	
-	
-	if(gtEvent.pfFunc[id] != NULL)	/* 事件已经被创建 */
-	{	
-		gtEvent.pfFunc[id] = NULL;
-		gtEvent.id[id] = 0;
-		gtEvent.delayTime[id] = 0;
-		gtEvent.param[id] = 0;
-		return true;			
-	}
-	return false;
+	ENTER_CRITICAL();
+	id = prvEventForId(eventId);
+	if(id != EVNT_NONE)	/* 事件已经被创建 */
+		prvEventFree(id);
+	EXIT_CRITICAL();
+	return id != EVNT_NONE;
 }
 /**
 *	function:	evnt Scheduler
-*	作用:	事件调度 
+*	作用:	事件调度,依次运行堆顶已到期的事件 
+*	每次最多运行进入时的事件数,回调中以0延时重新创建自身的事件留到下一次调度
 *	parame :	void
 *	参数:	空
 *	return :	not return
@@ -287,33 +415,33 @@ bool clean_event_for_id(uint32_t eventId)
 **/
 void event_scheduler(void)
 {
-	uint16_t i;	
+	uint16_t i, n;	
 	tpEventFunc pfFunc;
 	uint32_t id,param;
 	
-	for(i=0; i<EVNT_CONCURRENT; i++)
+	n = gtEvent.count;
+	while(n--)
 	{
-		if(gtEvent.pfFunc[i] != NULL)		/* 查找到事件 */
+		ENTER_CRITICAL();
+		if(!gtEvent.count || EVNT_BEFORE(gTimes, gtEvent.heapDue[0]))	/* 堆顶未到期 */
 		{
-			if(!gtEvent.delayTime[i])		/* 延时时间到 */
-			{
-				pfFunc  = gtEvent.pfFunc[i];	/* 取出事件 */
-				id    = gtEvent.id[i];
-				param = gtEvent.param[i];
-				
-				gtEvent.pfFunc[i]  = NULL;	/* 删除当前事件 */
-				gtEvent.id[i]    = 0;
-				gtEvent.param[i] = 0;
-				
-				pfFunc(id,param);		/* 运行已经就绪的事件 */
-				
-				#if (EN_IDLE_TASK == 1) && (DEFAULT_IDLE_TASK == 1) && \
-					(OS_DEBUG_LEVEL != CLOSE) && (OS_DEBUG_LEVEL != ERROR)
-					if(gCpuRunBase < 0xffffffff)
-						gCpuRunBase++;
-				#endif						
-			}
+			EXIT_CRITICAL();
+			break;
 		}
+		i = gtEvent.heap[0];
+		pfFunc  = gtEvent.pfFunc[i];	/* 取出事件 */
+		id    = gtEvent.id[i];
+		param = gtEvent.param[i];
+		prvEventFree(i);				/* 删除当前事件 */
+		EXIT_CRITICAL();
+		
+		pfFunc(id,param);		/* 运行已经就绪的事件 */
+		
+		#if (EN_IDLE_TASK == 1) && (DEFAULT_IDLE_TASK == 1) && \
+			(OS_DEBUG_LEVEL != CLOSE) && (OS_DEBUG_LEVEL != ERROR)
+			if(gCpuRunBase < 0xffffffff)
+				gCpuRunBase++;
+		#endif						
 	}
 }
 
@@ -321,29 +449,26 @@ void event_scheduler(void)
 /* 系统移植时请将此函数放置于TICK定时器器 */
 void os_event_timer_isr(void)
 {
-	uint16_t i;	
-	#if (EN_IDLE_TASK == 1) && (DEFAULT_IDLE_TASK == 1) && \
-		(OS_DEBUG_LEVEL != CLOSE) && (OS_DEBUG_LEVEL != ERROR)
-		uint16_t usNum = 0;
-	#endif
 	gTimes ++;
-	for(i=0; i<EVNT_CONCURRENT; i++)
-	{
-		if(gtEvent.pfFunc[i] != NULL)	/* 查找到事件 */
-		{
-			#if (EN_IDLE_TASK == 1) && (DEFAULT_IDLE_TASK == 1) && \
-				(OS_DEBUG_LEVEL != CLOSE) && (OS_DEBUG_LEVEL != ERROR)
-				usNum++;
-				if(gtEvent.maxEvent < usNum)
-				{
-					gtEvent.maxEvent = usNum;
-					OS_DEBUG_PRINTF("MaxEvent=%d,UsePercentage=%d%%\r\n\r\n",gtEvent.maxEvent,(gtEvent.maxEvent*100)/EVNT_CONCURRENT);						
-				}					
-			#endif				
-			if(gtEvent.delayTime[i])
-			{
-				gtEvent.delayTime[i]--;
-			}
-		}
-	}
-}
\ No newline at end of file
+}
+
+/**
+*	function:	event_next_ticks
+*	作用:	获取到最近的事件到期还需的TICK数,无滴答模式据此决定睡眠时间 
+*	return :	0:已有事件到期;TICKS_NONE:没有事件
+**/
+uint32_t event_next_ticks(void)
+{
+	int32_t ticks;
+	
+	if(!gtEvent.count)
+		return TICKS_NONE;
+	ticks = (int32_t)(gtEvent.heapDue[0] - gTimes);
+	return (ticks > 0) ? (uint32_t)ticks : 0;
+}
+
+/* 无滴答模式睡眠后补偿TICK中断,事件按到期时刻存放,只需推进gTimes */
+void os_event_timer_compensate(uint32_t ticks)
+{
+	gTimes += ticks;
+}
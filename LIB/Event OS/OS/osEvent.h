@@ -27,12 +27,29 @@ typedef void(*tpEventFunc)(uint32_t eventId, uint32_t param);
 * Defining task function pointer array types 
 * 结构体	
 *************************************************************/ 
+#if EVNT_CONCURRENT > 4095u
+	#error "EVNT_CONCURRENT must not exceed 4095"
+#endif
+
+#define EVNT_NONE	0xFFFFu		/* 空槽号 */
+
+/*
+*	事件按到期时刻存放在最小堆中,TICK中断只累加gTimes,
+*	调度时只取出堆顶已到期的事件;回调函数按哈希索引查找.
+*/
 typedef struct setEvent
 {
-	volatile uint32_t delayTime[EVNT_CONCURRENT];	/* 延时时间 */
 	uint32_t id[EVNT_CONCURRENT];					/* ID号 */
 	tpEventFunc pfFunc[EVNT_CONCURRENT];			/* 事件回调函数指针 */
 	uint32_t param[EVNT_CONCURRENT];				/* 参数 */
+	uint16_t heap[EVNT_CONCURRENT];					/* 按到期时刻排列的最小堆,存放槽号 */
+	uint32_t heapDue[EVNT_CONCURRENT];				/* 堆中各位置事件的到期时刻(gTimes计数) */
+	uint16_t heapPos[EVNT_CONCURRENT];				/* 槽在堆中的位置 */
+	uint16_t link[EVNT_CONCURRENT];					/* 使用中:回调哈希链的下一个槽;空闲:下一个空闲槽 */
+	uint16_t prev[EVNT_CONCURRENT];					/* 回调哈希链的上一个槽 */
+	uint16_t hash[EVNT_HASH_SIZE];					/* 回调哈希表,存放链首槽号 */
+	uint16_t count;									/* 事件数 */
+	uint16_t freeSlot;								/* 空闲槽链首 */
 	#if (EN_IDLE_TASK == 1) && (DEFAULT_IDLE_TASK == 1) && \
 		(OS_DEBUG_LEVEL != CLOSE) && (OS_DEBUG_LEVEL != ERROR)
 		uint16_t maxEvent;			/* 标识最大并发数,便于调试 */
@@ -59,6 +76,9 @@ extern bool clean_event_for_id(uint32_t eventId);												//事件清除
 //注意,采用回调函数和事件ID操作事件的方法不能混用
 /* 系统移植时请将此函数放置于TICK定时器器 */
 extern void os_event_timer_isr(void);
+/* 无滴答模式使用:到最近事件到期的TICK数,及睡眠后补偿TICK数 */
+extern uint32_t event_next_ticks(void);
+extern void os_event_timer_compensate(uint32_t ticks);
 
 
 
@@ -30,6 +30,8 @@
 #include "osTimer.h"
 /*系统调度和系统延时用户需要加载*/
 #include "osScheduler.h"
+/*有栈协作线程*/
+#include "osThread.h"
 
 #endif	/*_OS_INCLUDE_H_ */
 
@@ -212,4 +212,122 @@ uint16_t pull_queue(tsQueue *psQueue, void *pbuf, uint16_t num)
     psQueue->num -= tmpNum;	
 	EXIT_CRITICAL();		/* 退出临界，总是与进入临界成对出现 */			
 	return tmpNum;
-}
\ No newline at end of file
+}
+
+
+/**
+*	function:	
+*	作用:	创建一个单生产者单消费者无锁队列 
+*	tsSpscQueue *psQueue:	
+*	参数1:	队列对象指针. 
+*	void *pBuf:	
+*	参数2:	用于存放消息的缓冲区指针. 
+*	uint16_t deep:	
+*	参数3:	缓冲区的深度,必须是2的幂,最大32768; 
+*	uint16_t width:	
+*	参数4:	消息数据宽度;sizeof(data)  
+*	return : false of true	
+*	返回:	成功 或 失败 
+**/
+bool create_spsc_queue(tsSpscQueue *psQueue, void *pBuf, uint16_t deep, uint16_t width)
+{
+	if((NULL == psQueue) || (NULL == pBuf) || (0 == width) || 
+		(0 == deep) || (deep & (deep - 1)) || (deep > 0x8000u))
+		return false;
+	
+	psQueue->pBuf = (uint8_t *)pBuf;
+	psQueue->mask = deep - 1;
+	psQueue->width = width;
+	psQueue->head = 0;
+	psQueue->tail = 0;
+	return true;
+}
+
+/*
+ * 清空无锁队列,丢弃全部未读消息,只能由消费者调用 
+ */
+void clean_spsc_queue(tsSpscQueue *psQueue)
+{
+	if(psQueue == NULL)
+		return;
+	
+	psQueue->head = psQueue->tail;
+}
+
+/*
+ * 获取无锁队列数据个数 
+ */
+uint16_t get_spsc_data_num(tsSpscQueue *psQueue)
+{
+	return (uint16_t)(psQueue->tail - psQueue->head);
+}
+
+/***********************************************Function info*********************************************
+** Function name:           push_spsc_queue 
+** Descriptions:            无锁队列入队,只能由生产者调用,剩余空间不足时不装入
+**                          回绕前后各用一次memcpy复制连续的消息
+** Param[input]:            psQueue 队列指针 
+** Param[input]:            pBuf 数据指针 
+** Param[input]:            num 消息的数量 
+** Returned value:          操作结果               
+*********************************************************************************************************/ 
+bool push_spsc_queue(tsSpscQueue *psQueue, void *pBuf, uint16_t num)
+{
+	uint16_t tail,pos,run;
+	
+	if((psQueue == NULL)||(pBuf == NULL))
+		return false;	
+	
+	tail = psQueue->tail;
+	if(num > (uint16_t)(psQueue->mask + 1 - (uint16_t)(tail - psQueue->head)))
+		return false;	/* 剩下缓冲区不够返回错误 */
+	
+	pos = tail & psQueue->mask;
+	run = psQueue->mask + 1 - pos;			/* 到缓冲区末尾的连续空间 */
+	if(run > num)
+		run = num;
+	memcpy(psQueue->pBuf + (size_t)pos * psQueue->width, pBuf, (size_t)run * psQueue->width);
+	if(num > run)
+		memcpy(psQueue->pBuf, (uint8_t *)pBuf + (size_t)run * psQueue->width, (size_t)(num - run) * psQueue->width);
+	
+	MEMORY_BARRIER();		/* 数据写入后再发布写计数 */
+	psQueue->tail = tail + num;
+	return true;
+}
+
+/***********************************************Function info*********************************************
+** Function name:           pull_spsc_queue 
+** Descriptions:            无锁队列出队,只能由消费者调用
+**                          回绕前后各用一次memcpy复制连续的消息
+** Param[input]:            psQueue 队列指针 
+** Param[input]:            pbuf 数据指针 
+** Param[input]:            num 最多取出的消息数量
+** Returned value:          取出消息的条数.               
+*********************************************************************************************************/ 
+uint16_t pull_spsc_queue(tsSpscQueue *psQueue, void *pbuf, uint16_t num)
+{
+	uint16_t head,pos,run,dataNum;
+	
+	if((psQueue == NULL)||(pbuf == NULL))
+		return 0;	
+	
+	head = psQueue->head;
+	dataNum = (uint16_t)(psQueue->tail - head);
+	if(num > dataNum)
+		num = dataNum;
+	if(!num)	/* 没有数据返回 */
+		return 0;
+	MEMORY_BARRIER();		/* 读到写计数后再读数据 */
+	
+	pos = head & psQueue->mask;
+	run = psQueue->mask + 1 - pos;			/* 到缓冲区末尾的连续数据 */
+	if(run > num)
+		run = num;
+	memcpy(pbuf, psQueue->pBuf + (size_t)pos * psQueue->width, (size_t)run * psQueue->width);
+	if(num > run)
+		memcpy((uint8_t *)pbuf + (size_t)run * psQueue->width, psQueue->pBuf, (size_t)(num - run) * psQueue->width);
+	
+	MEMORY_BARRIER();		/* 数据读出后再释放空间 */
+	psQueue->head = head + num;
+	return num;
+}
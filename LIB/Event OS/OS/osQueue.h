@@ -37,6 +37,21 @@ typedef struct strQueue
 	uint16_t num;	
 }tsQueue;
 
+/*  
+**  单生产者单消费者无锁队列
+**  深度为2的幂,读写索引分开,生产者只改tail,消费者只改head,不需要屏蔽中断;
+**  适合一个中断向一个任务传递消息,同一队列只能有一个生产者和一个消费者.
+**  索引为自由递增的16位计数,深度最大32768.
+*/
+typedef struct strSpscQueue 
+{
+	uint8_t *pBuf;
+	uint16_t mask;				/* 深度-1 */
+	uint16_t width;
+	volatile uint16_t head;		/* 读计数,只由消费者修改 */
+	volatile uint16_t tail;		/* 写计数,只由生产者修改 */
+}tsSpscQueue;
+
 /**--------------以下API操作较为复杂,不推荐用户使用,用户可以使用后面的API----------------------**/
 extern bool create_queue(tsQueue *psQueue, void *pBuf, uint16_t deep, uint16_t width);
 extern void clean_queue(tsQueue *psQueue);									/* 清除队列  */
@@ -45,6 +60,12 @@ extern bool push_queue(tsQueue *psQueue,void *pBuf,uint16_t len);				/*  正常
 extern bool push_queue_prior(tsQueue *psQueue,void *pbuf,uint16_t len);		/*  插队方式入消息 */
 extern uint16_t pull_queue(tsQueue *psQueue,void *pbuf,uint16_t len);			/*  取消息 */
 
+extern bool create_spsc_queue(tsSpscQueue *psQueue, void *pBuf, uint16_t deep, uint16_t width);
+extern void clean_spsc_queue(tsSpscQueue *psQueue);							/* 清除队列,只能由消费者调用  */
+extern uint16_t get_spsc_data_num(tsSpscQueue *psQueue);						/* 获取当前队列数据个数  */
+extern bool push_spsc_queue(tsSpscQueue *psQueue,void *pBuf,uint16_t len);		/*  装入消息,只能由生产者调用 */
+extern uint16_t pull_spsc_queue(tsSpscQueue *psQueue,void *pbuf,uint16_t len);	/*  取消息,只能由消费者调用 */
+
 
 
 
@@ -123,4 +144,22 @@ extern uint16_t pull_queue(tsQueue *psQueue,void *pbuf,uint16_t len);			/*  取
 ** 返回:	实际取出的消息长度
 */
 #define pull_qu_one(S_QUEUE, P_BUF)  pull_queue(&S_QUEUE, (void *)P_BUF, 1)
+
+/**-----------------------单生产者单消费者无锁队列的宏定义API-------------------------------**/
+
+/*  
+** 无锁队列初始化 
+** S_QUEUE  ->队列名称,即使用tsSpscQueue 创建的变量
+** P_BUF	->用来存放消息的缓冲区,元素个数必须是2的幂
+** 返回:成功 失败.
+*/
+#define create_spsc_qu(S_QUEUE, P_BUF) create_spsc_queue(&S_QUEUE, (void *)P_BUF, sizeof(P_BUF)/sizeof(P_BUF[0]), sizeof(P_BUF[0]))
+
+/* 装入多个/1个消息,返回:成功 失败. */
+#define push_spsc_qu(S_QUEUE, P_BUF, NUM)  push_spsc_queue(&S_QUEUE, (void *)P_BUF, NUM)
+#define push_spsc_qu_one(S_QUEUE, S_BUF)  push_spsc_queue(&S_QUEUE, (void *)&S_BUF, 1)
+
+/* 取多个/1个消息,返回:实际取出的消息长度 */
+#define pull_spsc_qu(S_QUEUE, P_BUF, NUM)  pull_spsc_queue(&S_QUEUE, (void *)P_BUF, NUM)
+#define pull_spsc_qu_one(S_QUEUE, P_BUF)  pull_spsc_queue(&S_QUEUE, (void *)P_BUF, 1)
 #endif //_MSG_QUEUE_H_
\ No newline at end of file
@@ -31,6 +31,8 @@
 #include "osScheduler.h"
 /*OS硬件相关*/
 #include "osHardware.h"
+/*有栈协作线程*/
+#include "osThread.h"
 
 static volatile uint32_t gOsRelativeTime = 0;	/* OS相对时间 */
 #if (EN_IDLE_TASK == 1) && (DEFAULT_IDLE_TASK == 1) && \
@@ -58,6 +60,9 @@ void os_scheduler(void)
 	while(1)
 	{
 		event_scheduler();
+		#if EN_THREAD
+			thread_scheduler();
+		#endif
 		while(task_scheduler())
 		{
 			OS_CLR_WDT();			
@@ -76,6 +81,9 @@ void os_scheduler(void)
 		#if EN_IDLE_TASK == 1	
 			gtTask.pfFunc[0](0,0,NULL,0);	/* 执行空闲任务调度 */
 		#endif	
+		#if EN_TICKLESS
+			os_tickless_idle();		/* 睡眠到下一个事件/定时器/线程到期或有中断发生 */
+		#endif
 		OS_CLR_WDT();				
 	}	
 }
@@ -92,6 +100,57 @@ uint32_t get_os_time(void)
 	return gOsRelativeTime;
 }
 
+#if EN_TICKLESS
+/* 无滴答模式睡眠后补偿TICK中断 */
+void os_scheduler_timer_compensate(uint32_t ticks)
+{
+	gOsRelativeTime += ticks;
+}
+
+/**
+*	function:	os_tickless_idle
+*	作用:	无滴答空闲处理,没有任务消息、到期事件和就绪线程时,
+*			停止周期TICK,按最近的事件/定时器/线程到期时刻编程单次定时后睡眠,
+*			被定时器或其他中断唤醒后一次性补偿睡眠期间经过的TICK数.
+*	parame :	void
+*	参数:	空
+*	return :	无
+**/
+void os_tickless_idle(void)
+{
+	uint32_t next, ticks, elapsed = 0;
+	
+	DISABLE_IRQ();	/* 用PRIMASK关闭全部中断:BASEPRI屏蔽的中断无法唤醒WFI */
+	
+	/* 关中断后再确认没有可运行的工作,避免漏掉刚由中断发出的消息或事件 */
+	next = get_task_msg_num() ? 0 : timer_next_ticks();
+	ticks = event_next_ticks();
+	if(ticks < next)
+		next = ticks;
+	#if EN_THREAD
+		ticks = thread_next_ticks();
+		if(ticks < next)
+			next = ticks;
+	#endif
+	
+	if(next == 1)
+	{
+		sys_sleep();		/* 下一个TICK就到期,不必重新编程定时器 */
+	}
+	else if(next)
+	{
+		sys_tick_oneshot(next);
+		sys_sleep();
+		elapsed = sys_tick_resume();
+		/* 开中断前补偿,挂起的TICK中断在补偿后的计数上处理最后一个TICK */
+		timer_compensate(elapsed);
+		os_event_timer_compensate(elapsed);
+		os_scheduler_timer_compensate(elapsed);
+	}
+	ENABLE_IRQ();	/* 重新开启中断,挂起的中断在此处执行 */
+}
+#endif
+
 /*
 **  系统延时
 **  最小单位1/2个TICK周期;延时时可调度其它任务和事件.
@@ -118,6 +177,10 @@ bool os_delay_ms(uint16_t delayMs)
 	uint32_t lastTime; 		// 上次一采样时间	
 	uint32_t nowTime;		// 当前时间 
 
+	#if EN_THREAD
+		if(thread_self() != THREAD_NONE)	/* 线程中延时只切换回调度器,不递归调度 */
+			return thread_delay_ms(delayMs);
+	#endif
 	if(ucgDelayStatus >= OS_DELAY_MAX_CONCURRENT)	/* 已经到达最大延时数 */
 		return false;			/* 返回 */
 	else
@@ -139,6 +202,9 @@ bool os_delay_ms(uint16_t delayMs)
 	do
 	{
 		event_scheduler();		
+		#if EN_THREAD
+			thread_scheduler();
+		#endif
 		while(task_scheduler())
 		{			
 			event_scheduler();
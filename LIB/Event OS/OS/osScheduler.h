@@ -28,6 +28,12 @@ void os_scheduler_timer_isr(void);
 
 extern uint32_t get_os_time(void);
 
+#if EN_TICKLESS
+/* 无滴答模式:空闲时由os_scheduler()调用 */
+extern void os_scheduler_timer_compensate(uint32_t ticks);
+extern void os_tickless_idle(void);
+#endif
+
 extern void os_scheduler(void);
 
 /////////////////////////////////////////////////////////////////////////
@@ -37,6 +43,7 @@ extern void os_scheduler(void);
 ** 这样压栈的数据就会大大增加,严重时发生栈溢出,导致程序崩溃.
 ** 用户调用此延时程序时,需要判断返回值,如果返回值为fals,说明延时失败,
 ** 此时用户需要自行设法解决.
+** EN_THREAD为1时,在线程中调用等同thread_delay_ms(),不受OS_DELAY_MAX_CONCURRENT限制.
 */
 /////////////////////////////////////////////////////////////////////////
 extern bool os_delay_ms(uint16_t delayMs);
@@ -210,6 +210,12 @@ uint8_t task_scheduler(void)
 }
 
 
+/* 获取待处理的任务消息数 */
+uint16_t get_task_msg_num(void)
+{
+	return get_queue_data_num(&gtTaskQueue);
+}
+
 /**
 *	function:	default idle task
 *	作用:	默认空闲任务,可用于分析CPU的使用率
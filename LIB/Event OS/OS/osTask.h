@@ -30,6 +30,11 @@ extern void *pvPortMalloc( size_t xWantedSize );
 extern void vPortFree( void *pv );
 extern size_t xPortGetFreeHeapSize( void );
 extern size_t xPortGetMinimumEverFreeHeapSize( void );
+#if HEAP_TRACE
+extern void vHeapTraceStart( void );
+extern void vHeapTraceStop( void );
+extern void vHeapTraceDump( void (*pfWrite)( const void *pvData, uint16_t usLen ) );
+#endif
 
 #define osMalloc(x)		pvPortMalloc(x)
 #define osFree(x)		vPortFree(x)
@@ -76,6 +81,7 @@ extern uint8_t del_task(tpfTaskFunc pfFunction);
 
 extern bool send_msg_to_task(uint8_t taskId, uint8_t msg, void *pData, uint16_t dataSize);
 extern uint8_t task_scheduler(void);
+extern uint16_t get_task_msg_num(void);
 
 #if DEFAULT_IDLE_TASK == 1
 extern void idle_task(uint8_t taskId,uint8_t msg, void *pData, uint16_t dataSize);
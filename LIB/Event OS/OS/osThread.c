@@ -0,0 +1,268 @@
+/*-----------------------------------------------File Info------------------------------------------------
+** File Name:               osThread.c  
+** Last modified date:      
+** Last version:            V0.1
+** Description:             
+**--------------------------------------------------------------------------------------------------------            
+** Descriptions:            有栈协作线程创建/调度. 
+**                          线程延时或等待时保存上下文并切换回调度器,不像os_delay_ms()那样
+**                          在调用者的栈上递归运行调度器,因此多个线程可以同时延时.
+**--------------------------------------------------------------------------------------------------------
+*/
+
+/*************************************************************
+* 	include 
+* 	头文件	
+*************************************************************/ 
+/* 系统配置文件 */ 
+#include "osConfig.h"
+/* 重定义头文件 */
+#include "osTypedef.h"
+/*系统调度和系统延时用户需要加载*/
+#include "osScheduler.h"
+/*OS硬件相关*/
+#include "osHardware.h"
+/*线程创建/调度*/
+#include "osThread.h"
+
+#if EN_THREAD
+
+tsThread gtThread = {.current = THREAD_NONE};
+
+/* 将以mS为单位的延时转换为TICK数 */
+static uint32_t prvThreadTicks(uint16_t delayMs)
+{
+	/* 将绝对延时时间转换为相对延时 */	
+	#if(TICK_CYCLICITY_US == 1000u)		/* ==1mS */			
+		return delayMs;
+	#elif(TICK_CYCLICITY_US > 1000u)	/* 大于1mS */
+		return delayMs / (TICK_CYCLICITY_US / 1000u);	
+	#else								/* 小于1mS */
+		return (uint32_t)delayMs * (1000u / TICK_CYCLICITY_US);	
+	#endif
+}
+
+/* 保存当前线程上下文,切换回调度器 */
+static void prvThreadSwitchOut(void)
+{
+	uint8_t id = gtThread.current;
+	
+	gtThread.current = THREAD_NONE;
+	thread_context_switch(&gtThread.ctx[id], &gtThread.schedCtx);
+}
+
+/* 线程入口,线程函数返回后释放线程并切换回调度器,不再返回 */
+static void prvThreadEntry(void)
+{
+	uint8_t id = gtThread.current;
+	
+	gtThread.pfFunc[id](gtThread.param[id]);
+	OS_INFO_PRINTF("threadExit,Id=%d\r\n",id);
+	gtThread.state[id] = THREAD_FREE;
+	gtThread.pfFunc[id] = NULL;
+	prvThreadSwitchOut();
+}
+
+/**
+*	function:	create_thread 
+*	作用:	创建一个有栈协作线程,下一次调度时开始运行. 
+*	tpfThreadFunc pfFunction:	
+*	参数1: 线程函数,函数返回即线程结束.
+*	void *param:	
+*	参数2:	传递给线程函数的参数 
+*	void *pStack, uint16_t stackSize	
+*	参数3,4:	线程栈及其字节数,栈需容纳线程中最深的调用链和中断压栈
+*	return : 线程ID,失败返回THREAD_NONE
+**/
+uint8_t create_thread(tpfThreadFunc pfFunction, void *param, void *pStack, uint16_t stackSize)
+{
+	uint8_t i;
+	
+	if((pfFunction == NULL) || (pStack == NULL))
+		return THREAD_NONE;
+	
+	for(i=0; i < MAX_THREAD_NUM; i++)
+	{
+		if(gtThread.state[i] == THREAD_FREE)
+		{
+			gtThread.pfFunc[i] = pfFunction;
+			gtThread.param[i] = param;
+			gtThread.pStack[i] = (uint32_t *)pStack;
+			*gtThread.pStack[i] = THREAD_STACK_MAGIC;
+			gtThread.pQueue[i] = NULL;
+			thread_context_init(&gtThread.ctx[i], pStack, stackSize, prvThreadEntry);
+			gtThread.state[i] = THREAD_READY;
+			OS_INFO_PRINTF("createThreadSuccess,Id=%d\r\n",i);
+			return i;
+		}
+	}
+	OS_ERR_PRINTF("\r\n\r\ncreateThreadFalse,pleaseCheck \"MAX_THREAD_NUM\"=%d\r\n\r\n",MAX_THREAD_NUM);
+	return THREAD_NONE;
+}
+
+/**
+*	function:	thread_self 
+*	作用:	获取当前线程ID 
+*	return : 线程ID,不在线程中运行时返回THREAD_NONE
+**/
+uint8_t thread_self(void)
+{
+	return gtThread.current;
+}
+
+/**
+*	function:	thread_yield 
+*	作用:	让出CPU,调度器运行一轮任务/事件/其它线程后继续. 
+*	不在线程中调用时直接返回.
+**/
+void thread_yield(void)
+{
+	if(gtThread.current == THREAD_NONE)
+		return;
+	prvThreadSwitchOut();
+}
+
+/**
+*	function:	thread_delay_ms 
+*	作用:	线程延时,延时期间调度器运行任务/事件/其它线程. 
+*	uint16_t delayMs:	
+*	参数1: 延时时间,以mS为单位.
+*	return : true;不在线程中调用时返回false
+**/
+bool thread_delay_ms(uint16_t delayMs)
+{
+	uint8_t id = gtThread.current;
+	
+	if(id == THREAD_NONE)
+		return false;
+	
+	gtThread.wakeTime[id] = get_os_time() + prvThreadTicks(delayMs);
+	gtThread.state[id] = THREAD_DELAY;
+	prvThreadSwitchOut();
+	return true;
+}
+
+/**
+*	function:	thread_pull_queue 
+*	作用:	从队列取消息,队列为空时线程等待,直到有数据或超时. 
+*	tsQueue *psQueue, void *pbuf, uint16_t len:	
+*	参数1,2,3: 同pull_queue().
+*	uint16_t timeoutMs:	
+*	参数4: 超时时间,以mS为单位,THREAD_WAIT_FOREVER不超时.
+*	return : 取出消息的条数,超时返回0;不在线程中调用时不等待
+**/
+uint16_t thread_pull_queue(tsQueue *psQueue, void *pbuf, uint16_t len, uint16_t timeoutMs)
+{
+	uint8_t id = gtThread.current;
+	uint16_t num;
+	
+	num = pull_queue(psQueue, pbuf, len);
+	if(num || (id == THREAD_NONE) || (timeoutMs == 0))
+		return num;
+	
+	gtThread.wakeTime[id] = get_os_time() + prvThreadTicks(timeoutMs);
+	do
+	{
+		gtThread.pQueue[id] = psQueue;
+		gtThread.state[id] = (timeoutMs == THREAD_WAIT_FOREVER) ? THREAD_PEND : THREAD_WAIT;
+		prvThreadSwitchOut();
+		num = pull_queue(psQueue, pbuf, len);
+	}while(!num && ((timeoutMs == THREAD_WAIT_FOREVER) || 
+			((int32_t)(get_os_time() - gtThread.wakeTime[id]) < 0)));
+	gtThread.pQueue[id] = NULL;
+	return num;
+}
+
+/**
+*	function:	thread_scheduler
+*	作用:	线程调度,就绪(含延时到期、等待的队列有数据)的线程各运行一次,直到其延时/等待/让出 
+*	parame :	void
+*	参数:	空
+*	return :	运行的线程数
+**/
+uint8_t thread_scheduler(void)
+{
+	uint8_t i, run = 0;
+	uint32_t now;
+	
+	if(gtThread.current != THREAD_NONE)	/* 不能在线程中调度线程 */
+		return 0;
+	
+	for(i=0; i < MAX_THREAD_NUM; i++)
+	{
+		now = get_os_time();
+		switch(gtThread.state[i])
+		{
+			case THREAD_READY:
+				break;
+			case THREAD_DELAY:
+				if((int32_t)(now - gtThread.wakeTime[i]) < 0)
+					continue;
+				break;
+			case THREAD_WAIT:
+				if(!get_queue_data_num(gtThread.pQueue[i]) &&
+					((int32_t)(now - gtThread.wakeTime[i]) < 0))
+					continue;
+				break;
+			case THREAD_PEND:
+				if(!get_queue_data_num(gtThread.pQueue[i]))
+					continue;
+				break;
+			default:
+				continue;
+		}
+		
+		gtThread.state[i] = THREAD_READY;
+		gtThread.current = i;
+		thread_context_switch(&gtThread.schedCtx, &gtThread.ctx[i]);
+		run++;
+		
+		if(*gtThread.pStack[i] != THREAD_STACK_MAGIC)
+		{
+			OS_ERR_PRINTF("\r\n\r\nthreadStackOverflow,Id=%d\r\n\r\n",i);
+			*gtThread.pStack[i] = THREAD_STACK_MAGIC;
+		}
+	}
+	return run;
+}
+
+/**
+*	function:	thread_next_ticks
+*	作用:	获取到最近的线程可以运行还需的TICK数,无滴答模式据此决定睡眠时间 
+*	return :	0:有线程就绪;TICKS_NONE:没有线程在延时
+**/
+uint32_t thread_next_ticks(void)
+{
+	uint8_t i;
+	int32_t ticks;
+	uint32_t next = TICKS_NONE;
+	
+	for(i=0; i < MAX_THREAD_NUM; i++)
+	{
+		switch(gtThread.state[i])
+		{
+			case THREAD_READY:
+				return 0;
+			case THREAD_PEND:
+				if(get_queue_data_num(gtThread.pQueue[i]))
+					return 0;
+				continue;
+			case THREAD_WAIT:
+				if(get_queue_data_num(gtThread.pQueue[i]))
+					return 0;
+				break;
+			case THREAD_DELAY:
+				break;
+			default:
+				continue;
+		}
+		ticks = (int32_t)(gtThread.wakeTime[i] - get_os_time());
+		if(ticks <= 0)
+			return 0;
+		if((uint32_t)ticks < next)
+			next = (uint32_t)ticks;
+	}
+	return next;
+}
+
+#endif /* EN_THREAD */
@@ -0,0 +1,73 @@
+/*-----------------------------------------------File Info------------------------------------------------
+** File Name:               osThread.h  
+** Last modified date:      
+** Last version:            V0.1
+** Description:             有栈协作线程
+**
+**--------------------------------------------------------------------------------------------------------            
+** Descriptions:            线程有独立的栈,延时或等待队列时切换回调度器,由os_scheduler()轮流运行.
+**                          线程之间不抢占,只在延时/等待/让出时切换,共享数据不需要加锁.
+**--------------------------------------------------------------------------------------------------------*/
+#ifndef _OS_THREAD_H_
+#define _OS_THREAD_H_
+
+/*************************************************************
+* 	include 
+* 	头文件	
+*************************************************************/ 
+#include "osConfig.h" 
+#include "osTypedef.h"
+#include "osQueue.h"
+#include "osHardware.h"
+
+#if EN_THREAD
+
+#define THREAD_NONE			0xFFu		/* 不在线程中运行 */
+#define THREAD_WAIT_FOREVER	0xFFFFu		/* 等待队列不超时 */
+#define THREAD_STACK_MAGIC	0xA5A5A5A5u	/* 栈底标记,被改写说明栈溢出 */
+
+/* 定义线程函数类型,函数返回即线程结束 */
+typedef void(*tpfThreadFunc)(void *param);
+
+/* 线程状态 */
+enum eThreadState
+{
+	THREAD_FREE = 0,	/* 未使用 */
+	THREAD_READY,		/* 就绪 */
+	THREAD_DELAY,		/* 延时中 */
+	THREAD_WAIT,		/* 等待队列数据,超时后继续 */
+	THREAD_PEND,		/* 等待队列数据,不超时 */
+};
+
+/* 定义线程结构 */
+typedef struct strThread 
+{
+	tThreadContext ctx[MAX_THREAD_NUM];		/* 线程上下文 */
+	tpfThreadFunc pfFunc[MAX_THREAD_NUM];	/* 线程函数 */
+	void *param[MAX_THREAD_NUM];			/* 线程参数 */
+	uint32_t *pStack[MAX_THREAD_NUM];		/* 栈底,存放栈溢出标记 */
+	uint32_t wakeTime[MAX_THREAD_NUM];		/* 延时/等待到期时刻(get_os_time) */
+	tsQueue *pQueue[MAX_THREAD_NUM];		/* 等待的队列 */
+	uint8_t state[MAX_THREAD_NUM];			/* 线程状态 */
+	uint8_t current;						/* 正在运行的线程,THREAD_NONE表示调度器 */
+	tThreadContext schedCtx;				/* 调度器上下文 */
+}tsThread;
+
+extern tsThread gtThread;
+
+/** 
+*	线程函数必需是以下类型 
+* 	void vThreadFunc(void *param); 
+*	pStack为线程栈,需4字节对齐,如 static uint32_t stack[256];
+**/
+extern uint8_t create_thread(tpfThreadFunc pfFunction, void *param, void *pStack, uint16_t stackSize);
+extern uint8_t thread_self(void);
+extern void thread_yield(void);
+extern bool thread_delay_ms(uint16_t delayMs);
+extern uint16_t thread_pull_queue(tsQueue *psQueue, void *pbuf, uint16_t len, uint16_t timeoutMs);
+extern uint8_t thread_scheduler(void);
+extern uint32_t thread_next_ticks(void);
+
+#endif /* EN_THREAD */
+
+#endif /* _OS_THREAD_H_ */
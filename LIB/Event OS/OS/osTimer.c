@@ -157,4 +157,40 @@ void timer_scheduler(void)
 			}		
 		}
 	}
-}
\ No newline at end of file
+}
+
+/**
+*	function:	timer_next_ticks
+*	作用:	获取到最近的定时器到期还需的TICK数,无滴答模式据此决定睡眠时间. 			
+*	返回:	TICK数,没有定时器时返回TICKS_NONE
+**/
+uint32_t timer_next_ticks(void)
+{
+	uint16_t i;
+	uint32_t next = TICKS_NONE;
+	
+	for(i=0; i<MAX_TIMER_NUM; i++)
+	{
+		if((gtTimer.pfFunc[i] != NULL) && (gtTimer.runTime[i] < next))
+			next = gtTimer.runTime[i];
+	}
+	return next;
+}
+
+/**
+*	function:	timer_compensate
+*	作用:	无滴答模式睡眠后补偿TICK数,睡眠时间不超过timer_next_ticks(),
+*			到期的最后一个TICK仍由定时器中断处理.
+*	参数1:	睡眠期间未经过TICK中断的TICK数 			
+*	返回:	无
+**/
+void timer_compensate(uint32_t ticks)
+{
+	uint16_t i;
+	
+	for(i=0; i<MAX_TIMER_NUM; i++)
+	{
+		if(gtTimer.pfFunc[i] != NULL)
+			gtTimer.runTime[i] = (gtTimer.runTime[i] > ticks) ? (gtTimer.runTime[i] - ticks) : 1u;
+	}
+}
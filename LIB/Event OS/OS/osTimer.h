@@ -41,4 +41,7 @@ extern bool create_timer(uint32_t timeMs, tpfTimerFunc pfFunction);//创建定
 extern bool del_timer(tpfTimerFunc pfFunction);
 
 extern void timer_scheduler(void);
+/* 无滴答模式使用:到最近定时器到期的TICK数,及睡眠后补偿TICK数 */
+extern uint32_t timer_next_ticks(void);
+extern void timer_compensate(uint32_t ticks);
 #endif /* _OS_TIMER_H_ */
\ No newline at end of file
@@ -68,6 +68,12 @@
 #ifndef	DEFAULT_IDLE_TASK
 	#define DEFAULT_IDLE_TASK	1
 #endif
+/* Critical section interrupt mask priority
+*  临界段屏蔽的中断优先级,0:屏蔽全部中断;
+*  非0:使用BASEPRI只屏蔽优先级数值>=该值的中断,优先级更高的中断中不能调用OS接口 */
+#ifndef	CRITICAL_BASEPRI
+	#define CRITICAL_BASEPRI	0
+#endif
 /* TASK ID */
 /* 定义空闲任务ID号  */
 #define IDLE_TASK_ID	0	/* 空闲任务ID默认为0,无需修改  */
@@ -76,8 +82,14 @@
 	#err "IDLE_TASK_ID Must be 0 !!!"
 #endif
 /* Define event concurrency number  */
-/* 定义事件并发数 */
-#define EVNT_CONCURRENT		32u
+/* 定义事件并发数,最大4095 */
+#ifndef	EVNT_CONCURRENT
+	#define EVNT_CONCURRENT		32u
+#endif
+/* 事件回调函数哈希表大小,create_event/clean_event按回调函数查找时使用 */
+#ifndef	EVNT_HASH_SIZE
+	#define EVNT_HASH_SIZE		16u
+#endif
 	
 /* Define event concurrency number  */
 /* 定义定时器最大数量 */
@@ -89,6 +101,28 @@
 */
 #define OS_DELAY_MAX_CONCURRENT		1u
 
+/* 
+**	有栈协作线程,1使能,0禁止
+**	线程有独立的栈,在线程中os_delay_ms()/thread_delay_ms()/thread_pull_queue()只切换到调度器,
+**	不递归调度,多个线程可以同时延时或等待.
+*/
+#ifndef	EN_THREAD
+	#define EN_THREAD	0
+#endif
+/* 最大线程数 */
+#ifndef	MAX_THREAD_NUM
+	#define MAX_THREAD_NUM		4u
+#endif
+
+/* 
+**	无滴答模式,1使能,0禁止
+**	空闲时按最近的事件/定时器/线程到期时刻把SysTick编程为单次定时并睡眠,
+**	唤醒后一次性补偿睡眠期间经过的TICK数.
+*/
+#ifndef	EN_TICKLESS
+	#define EN_TICKLESS	0
+#endif
+
 /* 系统定时器频率（Hz）最小为1Hz,最大不超过1000Hz,推荐频率100Hz~1000Hz*/
 
 #define TICK_RATE_HZ   		1000u
@@ -125,7 +159,9 @@ enum eSysTaskMsg
 * 				动态内存管理
 *************************************************************/ 
 /* 定义堆大小 */
-#define configTOTAL_HEAP_SIZE		(1024*2)	//2K
+#ifndef	configTOTAL_HEAP_SIZE
+	#define configTOTAL_HEAP_SIZE		(1024*2)	//2K
+#endif
 	
 /* 内存对齐字节数 */
 #define portBYTE_ALIGNMENT				4
@@ -153,6 +189,19 @@ enum eSysTaskMsg
 #define traceMALLOC( pvAddress, uiSize )	HEAP_PRINTF("\nMalloc:%x,size:%d",(uint32_t )pvAddress,uiSize)
 #define traceFREE( pvAddress, uiSize )		HEAP_PRINTF("\nFree:%x,size:%d",(uint32_t )pvAddress,uiSize)
 
+/* 二进制分配跟踪
+*  每次分配/释放把时刻、大小、地址、调用者和耗时记录到RAM中的环形缓冲区,开销为几十个周期,可长期开启.
+*  用vHeapTraceDump()导出后,由tools/heap_replay在主机上回放,统计峰值、碎片和耗时 */
+#ifndef	HEAP_TRACE
+	#define HEAP_TRACE			0	/* 1使能,0禁止 */
+#endif
+#ifndef	HEAP_TRACE_DEPTH
+	#define HEAP_TRACE_DEPTH	128	/* 记录条数,每条20字节 */
+#endif
+#ifndef	HEAP_TRACE_WRAP
+	#define HEAP_TRACE_WRAP		0	/* 0:记满后停止,保留从开始跟踪起的完整记录;1:覆盖最旧的记录 */
+#endif
+
 
 #if OS_DEBUG_LEVEL ==  LOG_CLOSE
 	#ifdef	OS_DEBUG_PRINTF		/* 调试信息 */
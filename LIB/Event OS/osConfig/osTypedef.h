@@ -48,6 +48,9 @@
 #endif
 	
 
+/* 没有到期时刻,用于各模块的*_next_ticks() */
+#define TICKS_NONE	0xFFFFFFFFu
+
 extern void disDebugTypedefPrintf(const char *s, ...);
 
 #endif /* #ifndef _OS_TYPEDEF_H_ */
@@ -42,7 +42,10 @@ extern IWDG_HandleTypeDef hiwdg;
 
 
 uint16_t criticalNesting;
+uint32_t criticalSavedMask;
 bool gClrWdt=false;
+static uint16_t tickCount = 0;		/* 清看门狗标志计数 */
+static uint16_t infoTickCount = 0;	/* 输出OS信息计数 */
 
 /**
  * 看门狗初始化
@@ -77,7 +80,7 @@ void sys_tick_init(void)
 {
     // HAL库已经初始化了SysTick，这里只需确保配置正确
     // SysTick配置为1ms中断（1000Hz）
-    HAL_SYSTICK_Config(HAL_RCC_GetHCLKFreq()/1000);
+    HAL_SYSTICK_Config(HAL_RCC_GetHCLKFreq()/TICK_RATE_HZ);
     HAL_SYSTICK_CLKSourceConfig(SYSTICK_CLKSOURCE_HCLK);
     
     // 设置中断优先级
@@ -101,9 +104,6 @@ void os_systick_handler(void)
 {
     HAL_IncTick();
     
-    static uint16_t tickCount = 0;
-    static uint16_t infoTickCount = 0;
-    
     tickCount++;
     
     // 每秒清除看门狗
@@ -124,4 +124,139 @@ void os_systick_handler(void)
     timer_scheduler();
     os_event_timer_isr();
     os_scheduler_timer_isr();
-}
\ No newline at end of file
+}
+
+
+#if EN_TICKLESS
+/*
+ * 无滴答模式使用SysTick作为单次定时器,到期时SysTick中断仍按一个TICK处理.
+ * SysTick重装值只有24位,单次定时的最长时间受系统时钟限制,超出时分多次睡眠.
+ * 进入和退出单次定时时都保留不足一个TICK的部分,唤醒再频繁系统时间也不会落后.
+ */
+#define TICKLESS_CYCLES_PER_TICK	(HAL_RCC_GetHCLKFreq() / TICK_RATE_HZ)
+#define TICKLESS_MIN_CYCLES			32u	/* 恢复周期TICK时首个TICK的最短周期数,不足时并入下一个TICK */
+
+static uint32_t ticklessTicks;	/* 本次单次定时的TICK数 */
+static uint32_t ticklessPhase;	/* 进入单次定时时当前TICK已走过的周期数 */
+static uint32_t ticklessCtrl;	/* 停止状态下的SysTick控制字 */
+
+/**
+ * 停止周期TICK,编程一个ticks个TICK后到期的单次定时,返回实际编程的TICK数.
+ * 到期时刻从上一个TICK边界起算,与周期TICK对齐.
+ */
+uint32_t sys_tick_oneshot(uint32_t ticks)
+{
+	uint32_t maxTicks = SysTick_LOAD_RELOAD_Msk / TICKLESS_CYCLES_PER_TICK;
+
+	if(ticks > maxTicks)
+		ticks = maxTicks;
+
+	ticklessCtrl = SysTick->CTRL & ~(SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_COUNTFLAG_Msk);
+	SysTick->CTRL = ticklessCtrl;
+
+	ticklessPhase = SysTick->LOAD - SysTick->VAL;
+	SysTick->LOAD = ticks * TICKLESS_CYCLES_PER_TICK - ticklessPhase - 1u;
+	SysTick->VAL = 0;
+	SysTick->CTRL = ticklessCtrl | SysTick_CTRL_ENABLE_Msk;
+
+	ticklessTicks = ticks;
+	return ticks;
+}
+
+/**
+ * 恢复周期TICK,返回睡眠期间经过、且不会由TICK中断计入的TICK数,
+ * 同时补偿HAL时基和本文件的秒计数
+ */
+uint32_t sys_tick_resume(void)
+{
+	uint32_t elapsed, cycles, i;
+
+	SysTick->CTRL = ticklessCtrl;	/* 先停止计数再读COUNTFLAG,写CTRL不会清除该标志 */
+
+	if(SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk)
+	{
+		/* 单次定时已到期,挂起的SysTick中断返回后会补上最后一个TICK;
+		   计数器已从LOAD重新开始,LOAD - VAL为到期后又经过的周期数 */
+		cycles = SysTick->LOAD - SysTick->VAL;
+		elapsed = ticklessTicks - 1u + cycles / TICKLESS_CYCLES_PER_TICK;
+	}
+	else
+	{
+		/* 被其他中断提前唤醒 */
+		cycles = SysTick->LOAD - SysTick->VAL + ticklessPhase;
+		elapsed = cycles / TICKLESS_CYCLES_PER_TICK;
+	}
+
+	/* 不足一个TICK的部分留给下一个TICK:首个TICK只计余下的周期,之后恢复周期TICK */
+	cycles = TICKLESS_CYCLES_PER_TICK - cycles % TICKLESS_CYCLES_PER_TICK;
+	if(cycles < TICKLESS_MIN_CYCLES)
+	{
+		elapsed++;
+		cycles += TICKLESS_CYCLES_PER_TICK;
+	}
+
+	SysTick->LOAD = cycles - 1u;
+	SysTick->VAL = 0;
+	SysTick->CTRL = ticklessCtrl | SysTick_CTRL_ENABLE_Msk;
+	SysTick->LOAD = TICKLESS_CYCLES_PER_TICK - 1u;	/* 下次重装时生效 */
+
+	/* HAL时基同样需要补偿,保证HAL_GetTick()与HAL_Delay()正常 */
+	for(i = 0; i < elapsed; i++)
+	{
+		HAL_IncTick();
+	}
+	tickCount += elapsed;
+	return elapsed;
+}
+
+/**
+ * 关中断状态下调用,挂起的中断可唤醒内核但需开中断后才会执行
+ */
+void sys_sleep(void)
+{
+    __DSB();
+    __WFI();
+    __ISB();
+}
+#endif
+
+#if EN_THREAD
+/* 协作切换在普通函数调用中进行,只需保存被调用者保存的寄存器 */
+#if defined(__VFP_FP__) && !defined(__SOFTFP__)
+	#define THREAD_FPU_FRAME	16u		/* s16-s31 */
+#else
+	#define THREAD_FPU_FRAME	0u
+#endif
+
+/**
+ * 初始化线程上下文,首次切换到该线程时从pfEntry开始运行
+ */
+void thread_context_init(tThreadContext *pCtx, void *pStack, uint32_t stackSize, void (*pfEntry)(void))
+{
+    uint32_t *sp = (uint32_t *)(((uint32_t)pStack + stackSize) & ~7u);	/* 栈顶8字节对齐 */
+
+    sp -= 10u + THREAD_FPU_FRAME;
+    memset(sp, 0, (10u + THREAD_FPU_FRAME) * sizeof(uint32_t));
+    sp[THREAD_FPU_FRAME + 9u] = (uint32_t)pfEntry;	/* lr */
+    *pCtx = sp;
+}
+
+/**
+ * 保存当前上下文到pSave,切换到pTo
+ */
+__attribute__((naked)) void thread_context_switch(tThreadContext *pSave, tThreadContext *pTo)
+{
+    __asm volatile(
+        "push   {r3-r11, lr}    \n"
+#if THREAD_FPU_FRAME
+        "vpush  {s16-s31}       \n"
+#endif
+        "str    sp, [r0]        \n"
+        "ldr    sp, [r1]        \n"
+#if THREAD_FPU_FRAME
+        "vpop   {s16-s31}       \n"
+#endif
+        "pop    {r3-r11, pc}    \n"
+    );
+}
+#endif
@@ -5,26 +5,62 @@
 #include "osTypedef.h"
 #include "py32f4xx_hal.h"
 
-/* 临界段保护 */
+/* 临界段保护
+*  可嵌套:最外层进入时保存中断屏蔽状态,最外层退出时恢复,
+*  在已关中断的环境中调用也不会提前打开中断.
+*  CRITICAL_BASEPRI不为0时使用BASEPRI,只屏蔽优先级数值>=CRITICAL_BASEPRI的中断,
+*  更高优先级的中断(如DMA、捕获)不受影响,但这些中断中不能调用OS接口.
+*/
 extern uint16_t criticalNesting;
+extern uint32_t criticalSavedMask;
 #define DISABLE_IRQ()  	__disable_irq()
 #define ENABLE_IRQ()  	__enable_irq()
 
+#if CRITICAL_BASEPRI
+#define CRITICAL_MASK_GET()         __get_BASEPRI()
+#define CRITICAL_MASK_SET()         do { __set_BASEPRI_MAX(CRITICAL_BASEPRI << (8 - __NVIC_PRIO_BITS)); __ISB(); } while(0)
+#define CRITICAL_MASK_RESTORE(m)    __set_BASEPRI(m)
+#else
+#define CRITICAL_MASK_GET()         __get_PRIMASK()
+#define CRITICAL_MASK_SET()         __disable_irq()
+#define CRITICAL_MASK_RESTORE(m)    __set_PRIMASK(m)
+#endif
+
 #define ENTER_CRITICAL()    \
     do { \
-        uint32_t primask = __get_PRIMASK(); \
-        __disable_irq(); \
-        criticalNesting++; \
-        (void)primask; \
+        uint32_t mask = CRITICAL_MASK_GET(); \
+        CRITICAL_MASK_SET(); \
+        if(criticalNesting++ == 0) { \
+            criticalSavedMask = mask; \
+        } \
     } while(0)
 
 #define EXIT_CRITICAL() \
     do { \
         if(--criticalNesting == 0) { \
-            __enable_irq(); \
+            CRITICAL_MASK_RESTORE(criticalSavedMask); \
         } \
     } while(0)
 
+/* 内存屏障,无锁队列在发布读写计数前保证数据已写入/读出 */
+#define MEMORY_BARRIER()    __DMB()
+
+/* 动态内存分配跟踪(HEAP_TRACE)使用的时刻、周期计数和调用者地址 */
+#define HEAP_TRACE_TIME()       HAL_GetTick()
+#define HEAP_TRACE_CYCLES()     (DWT->CYCCNT)
+#if defined(__CC_ARM)
+#define HEAP_TRACE_CALLER()     __return_address()
+#else
+#define HEAP_TRACE_CALLER()     ((uint32_t)__builtin_return_address(0))
+#endif
+
+#if EN_THREAD
+/* 线程上下文:切换时保存的栈指针,由thread_context_switch()压入r3-r11,lr(及s16-s31) */
+typedef uint32_t *tThreadContext;
+extern void thread_context_init(tThreadContext *pCtx, void *pStack, uint32_t stackSize, void (*pfEntry)(void));
+extern void thread_context_switch(tThreadContext *pSave, tThreadContext *pTo);
+#endif
+
 /* 系统定时器相关定义 */
 #define SYSTICK_CTRL        (SysTick->CTRL)
 #define SYSTICK_LOAD        (SysTick->LOAD)
@@ -61,4 +97,9 @@ extern void sys_tick_init(void);
 extern uint32_t get_sys_tick_val(void);
 extern uint32_t get_sys_tick_load(void);
 void os_systick_handler(void);
+#if EN_TICKLESS
+extern uint32_t sys_tick_oneshot(uint32_t ticks);
+extern uint32_t sys_tick_resume(void);
+extern void sys_sleep(void);
+#endif
 #endif
\ No newline at end of file
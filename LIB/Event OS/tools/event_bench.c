@@ -0,0 +1,120 @@
+/*-----------------------------------------------File Info------------------------------------------------
+** File Name:               event_bench.c  
+** Descriptions:            主机端osEvent.c性能测试,用法见说明.txt
+**                          gcc -O2 -DEVNT_CONCURRENT=128 -Itools/host -IosConfig -IOS 
+**                              tools/event_bench.c OS/osEvent.c -o event_bench
+**--------------------------------------------------------------------------------------------------------
+*/
+#include <time.h>
+#include "osConfig.h"
+#include "osTypedef.h"
+#include "osEvent.h"
+
+#define BENCH_TICKS		200000u		/* 周期事件模拟的TICK数 */
+#define BENCH_LOOPS		200u		/* 单项测试重复次数 */
+
+uint32_t gCpuRunBase = 0;
+void disDebugTypedefPrintf(const char *s, ...)
+{
+	(void)s;
+}
+
+static uint32_t gFired;
+static uint32_t gEventId[EVNT_CONCURRENT];
+
+static double prvNowNs(void)
+{
+	struct timespec ts;
+	
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* 不会被调用的回调函数,只用其地址测试按回调函数查找 */
+static tpEventFunc prvFakeFunc(uint16_t i)
+{
+	return (tpEventFunc)(size_t)(0x08000000u + 4u * (i + 1u));
+}
+
+static void prvNop(uint32_t eventId, uint32_t param)
+{
+	(void)eventId;
+	(void)param;
+}
+
+/* 周期事件:以参数为周期重新创建自身 */
+static void prvPeriodic(uint32_t eventId, uint32_t param)
+{
+	(void)eventId;
+	gFired++;
+	create_events(param, prvPeriodic, param);
+}
+
+int main(void)
+{
+	uint32_t i, n, loop;
+	double t0, createNs, tickNs, idleNs, resetNs, cleanNs, runNs;
+	
+	/* 按ID方式创建满EVNT_CONCURRENT个远期事件 */
+	t0 = prvNowNs();
+	for(loop=0; loop < BENCH_LOOPS; loop++)
+	{
+		for(i=0; i < EVNT_CONCURRENT; i++)
+			gEventId[i] = create_events(1000000u + i, prvNop, i);
+		if(loop + 1 < BENCH_LOOPS)
+			for(i=0; i < EVNT_CONCURRENT; i++)
+				clean_event_for_id(gEventId[i]);
+	}
+	createNs = (prvNowNs() - t0) / (BENCH_LOOPS * EVNT_CONCURRENT * 2u - EVNT_CONCURRENT);
+	
+	/* 表满时的TICK中断与空闲调度 */
+	t0 = prvNowNs();
+	for(i=0; i < BENCH_TICKS; i++)
+		os_event_timer_isr();
+	tickNs = (prvNowNs() - t0) / BENCH_TICKS;
+	
+	t0 = prvNowNs();
+	for(i=0; i < BENCH_TICKS; i++)
+		event_scheduler();
+	idleNs = (prvNowNs() - t0) / BENCH_TICKS;
+	
+	for(i=0; i < EVNT_CONCURRENT; i++)
+		clean_event_for_id(gEventId[i]);
+	
+	/* 按回调函数查找:create_event重置已有事件,clean_event+create_event */
+	for(i=0; i < EVNT_CONCURRENT; i++)
+		create_event(1000000u, prvFakeFunc(i), i);
+	t0 = prvNowNs();
+	for(loop=0; loop < BENCH_LOOPS; loop++)
+		for(i=0; i < EVNT_CONCURRENT; i++)
+			create_event(1000000u + loop, prvFakeFunc(i), i);
+	resetNs = (prvNowNs() - t0) / (BENCH_LOOPS * EVNT_CONCURRENT);
+	
+	t0 = prvNowNs();
+	for(loop=0; loop < BENCH_LOOPS; loop++)
+		for(i=0; i < EVNT_CONCURRENT; i++)
+		{
+			clean_event(prvFakeFunc(i));
+			create_event(1000000u, prvFakeFunc(i), i);
+		}
+	cleanNs = (prvNowNs() - t0) / (BENCH_LOOPS * EVNT_CONCURRENT);
+	
+	for(i=0; i < EVNT_CONCURRENT; i++)
+		clean_event(prvFakeFunc(i));
+	
+	/* 周期事件模拟:周期2~65个TICK,每个TICK运行一次中断和调度 */
+	for(i=0; i < EVNT_CONCURRENT; i++)
+		create_events(2u + i % 64u, prvPeriodic, 2u + i % 64u);
+	t0 = prvNowNs();
+	for(n=0; n < BENCH_TICKS; n++)
+	{
+		os_event_timer_isr();
+		event_scheduler();
+	}
+	runNs = (prvNowNs() - t0) / BENCH_TICKS;
+	
+	printf("{\"events\":%u,\"create_ns\":%.1f,\"tick_ns\":%.1f,\"idle_sched_ns\":%.1f,"
+		"\"reset_by_func_ns\":%.1f,\"clean_create_ns\":%.1f,\"periodic_tick_ns\":%.1f,\"fired\":%u}\n",
+		(unsigned)EVNT_CONCURRENT, createNs, tickNs, idleNs, resetNs, cleanNs, runNs, (unsigned)gFired);
+	return 0;
+}
@@ -0,0 +1,671 @@
+/*-----------------------------------------------File Info------------------------------------------------
+** File Name:               heap_replay.c
+** Description:             主机工具:回放heap_4.c导出的二进制分配跟踪(HEAP_TRACE),
+**                          统计峰值、碎片、调用耗时,并比较heap_4与其他分配策略所需的最小堆大小
+**--------------------------------------------------------------------------------------------------------
+** 编译:   gcc -O2 -o heap_replay heap_replay.c
+** 用法:   heap_replay trace.bin [-s 堆大小] [-c 调用者条数]
+**
+** 回放不运行目标板上的heap_4.c,而是按目标板的块头大小和对齐(取自跟踪文件头)模拟同样的
+** 地址有序首次适配、分割与合并,因此在64位主机上得到的块布局与32位目标板一致,
+** 并可对任意堆大小重复回放.
+**--------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/* 与heap_4.c中的定义一致 */
+#define TRACE_MAGIC         0x43525448UL    /* "HTRC" */
+#define TRACE_VERSION       1
+#define TRACE_MALLOC        0
+#define TRACE_FREE          1
+
+typedef struct
+{
+    uint32_t ulMagic;
+    uint16_t usVersion;
+    uint16_t usRecordSize;
+    uint32_t ulHeapSize;
+    uint32_t ulHeapStart;
+    uint16_t usHeaderSize;
+    uint16_t usAlignment;
+    uint32_t ulCount;
+    uint32_t ulDropped;
+    uint32_t ulCycleHz;
+} TraceHeader_t;
+
+typedef struct
+{
+    uint32_t ulTime;
+    uint32_t ulAddress;
+    uint32_t ulCaller;
+    uint16_t usSize;
+    uint16_t usCycles;
+    uint8_t ucOp;
+    uint8_t ucReserved[3];
+} TraceRecord_t;
+
+/* 回放用的操作序列,释放已与对应的分配配对 */
+typedef struct
+{
+    uint8_t op;
+    uint32_t size;      /* 分配:申请字节数 */
+    int32_t pair;       /* 释放:对应分配的下标;分配:-1 */
+} ReplayOp_t;
+
+/* 空闲块,按地址升序 */
+typedef struct
+{
+    uint32_t off;
+    uint32_t size;
+} FreeBlock_t;
+
+typedef enum
+{
+    FIT_FIRST = 0,      /* heap_4:地址有序首次适配 */
+    FIT_BEST,           /* 最佳适配 */
+    FIT_NEXT,           /* 循环首次适配 */
+    FIT_NUM
+} FitPolicy_t;
+
+static const char *const fitName[FIT_NUM] = {"heap_4", "best_fit", "next_fit"};
+
+/* 模拟堆 */
+typedef struct
+{
+    FitPolicy_t policy;
+    uint32_t header;    /* 块头大小 */
+    uint32_t mask;      /* 对齐掩码 */
+    FreeBlock_t *list;
+    uint32_t cnt;
+    uint32_t rover;     /* FIT_NEXT的起始查找位置 */
+    uint32_t freeBytes;
+    uint32_t minFree;
+    uint32_t used;
+    uint32_t peakUsed;
+    uint32_t fails;
+    double maxFrag;     /* 分配后 1 - 最大空闲块/空闲总量 的最大值 */
+    uint64_t visits[2]; /* 分配、释放访问的空闲块数 */
+    uint32_t maxVisits[2];
+    uint32_t calls[2];
+} SimHeap_t;
+
+typedef struct
+{
+    uint32_t caller;
+    uint32_t calls;
+    uint64_t bytes;
+    uint32_t maxSize;
+    uint32_t live;
+} CallerStat_t;
+
+static TraceHeader_t header;
+static TraceRecord_t *records;
+static ReplayOp_t *ops;
+static uint32_t opCnt;
+
+/* heap_4:块大小=申请字节数+块头,再向上对齐 */
+static uint32_t blockSize(uint32_t size, uint32_t hdr, uint32_t mask)
+{
+    uint32_t want = size + hdr;
+
+    if (want & mask)
+    {
+        want += (mask + 1) - (want & mask);
+    }
+    return want;
+}
+
+static void simInit(SimHeap_t *h, FitPolicy_t policy, uint32_t heapSize)
+{
+    uint32_t end;
+
+    memset(h, 0, sizeof(SimHeap_t));
+    h->policy = policy;
+    h->header = header.usHeaderSize;
+    h->mask = header.usAlignment - 1;
+    h->list = malloc(sizeof(FreeBlock_t) * (opCnt + 2));
+
+    /* 与prvHeapInit()相同:堆尾留出一个块头作为结束标记 */
+    end = (heapSize - h->header) & ~h->mask;
+    h->list[0].off = 0;
+    h->list[0].size = end;
+    h->cnt = 1;
+    h->freeBytes = end;
+    h->minFree = end;
+}
+
+static void simFreeList(SimHeap_t *h)
+{
+    free(h->list);
+}
+
+static void simVisit(SimHeap_t *h, int op, uint32_t visits)
+{
+    h->calls[op]++;
+    h->visits[op] += visits;
+    if (h->maxVisits[op] < visits)
+    {
+        h->maxVisits[op] = visits;
+    }
+}
+
+static void simFragment(SimHeap_t *h)
+{
+    uint32_t largest = 0;
+    uint32_t i;
+    double frag;
+
+    for (i = 0; i < h->cnt; i++)
+    {
+        if (largest < h->list[i].size)
+        {
+            largest = h->list[i].size;
+        }
+    }
+    if (h->freeBytes)
+    {
+        frag = 1.0 - (double)largest / h->freeBytes;
+        if (h->maxFrag < frag)
+        {
+            h->maxFrag = frag;
+        }
+    }
+}
+
+/* 分配,返回块偏移并由block返回实际块大小,失败返回UINT32_MAX */
+static uint32_t simMalloc(SimHeap_t *h, uint32_t size, uint32_t *block)
+{
+    uint32_t want = blockSize(size, h->header, h->mask);
+    uint32_t i, n, pick = UINT32_MAX, visits = 0;
+    uint32_t off;
+
+    if ((size == 0) || (want > h->freeBytes))
+    {
+        h->fails++;
+        simVisit(h, TRACE_MALLOC, 0);
+        return UINT32_MAX;
+    }
+
+    switch (h->policy)
+    {
+    case FIT_FIRST:
+        for (i = 0; i < h->cnt; i++)
+        {
+            visits++;
+            if (h->list[i].size >= want)
+            {
+                pick = i;
+                break;
+            }
+        }
+        break;
+    case FIT_BEST:
+        for (i = 0; i < h->cnt; i++)
+        {
+            visits++;
+            if ((h->list[i].size >= want) &&
+                ((pick == UINT32_MAX) || (h->list[i].size < h->list[pick].size)))
+            {
+                pick = i;
+                if (h->list[i].size == want)
+                {
+                    break;
+                }
+            }
+        }
+        break;
+    default:
+        for (n = 0; n < h->cnt; n++)
+        {
+            i = (h->rover + n) % h->cnt;
+            visits++;
+            if (h->list[i].size >= want)
+            {
+                pick = i;
+                break;
+            }
+        }
+        break;
+    }
+    simVisit(h, TRACE_MALLOC, visits);
+
+    if (pick == UINT32_MAX)
+    {
+        h->fails++;
+        return UINT32_MAX;
+    }
+
+    off = h->list[pick].off;
+    if (h->list[pick].size - want > (h->header << 1))
+    {
+        /* 分割,剩余部分留在原位置 */
+        h->list[pick].off += want;
+        h->list[pick].size -= want;
+        h->rover = pick;
+    }
+    else
+    {
+        want = h->list[pick].size;
+        memmove(&h->list[pick], &h->list[pick + 1], (h->cnt - pick - 1) * sizeof(FreeBlock_t));
+        h->cnt--;
+        h->rover = (h->cnt && (pick < h->cnt)) ? pick : 0;
+    }
+
+    h->freeBytes -= want;
+    h->used += want;
+    if (h->minFree > h->freeBytes)
+    {
+        h->minFree = h->freeBytes;
+    }
+    if (h->peakUsed < h->used)
+    {
+        h->peakUsed = h->used;
+    }
+    simFragment(h);
+    *block = want;
+    return off;
+}
+
+/* 释放,按地址插入空闲表并与相邻块合并 */
+static void simFree(SimHeap_t *h, uint32_t off, uint32_t size)
+{
+    uint32_t i = 0;
+
+    while ((i < h->cnt) && (h->list[i].off < off))
+    {
+        i++;
+    }
+    simVisit(h, TRACE_FREE, i + 1);
+
+    h->freeBytes += size;
+    h->used -= size;
+
+    if ((i > 0) && (h->list[i - 1].off + h->list[i - 1].size == off))
+    {
+        h->list[i - 1].size += size;
+        if ((i < h->cnt) && (h->list[i - 1].off + h->list[i - 1].size == h->list[i].off))
+        {
+            h->list[i - 1].size += h->list[i].size;
+            memmove(&h->list[i], &h->list[i + 1], (h->cnt - i - 1) * sizeof(FreeBlock_t));
+            h->cnt--;
+        }
+    }
+    else if ((i < h->cnt) && (off + size == h->list[i].off))
+    {
+        h->list[i].off = off;
+        h->list[i].size += size;
+    }
+    else
+    {
+        memmove(&h->list[i + 1], &h->list[i], (h->cnt - i) * sizeof(FreeBlock_t));
+        h->list[i].off = off;
+        h->list[i].size = size;
+        h->cnt++;
+    }
+}
+
+/*
+ * 按策略和堆大小回放整个序列.
+ * offsets非NULL时输出每个分配的块偏移(失败为UINT32_MAX).
+ */
+static void simReplay(SimHeap_t *h, FitPolicy_t policy, uint32_t heapSize, uint32_t *offsets)
+{
+    uint32_t *off = malloc(sizeof(uint32_t) * (opCnt + 1));
+    uint32_t *len = malloc(sizeof(uint32_t) * (opCnt + 1));
+    uint32_t i;
+    int32_t p;
+
+    simInit(h, policy, heapSize);
+    for (i = 0; i < opCnt; i++)
+    {
+        if (ops[i].op == TRACE_MALLOC)
+        {
+            /* 未分割时块比申请的大,释放时按实际块大小归还 */
+            off[i] = simMalloc(h, ops[i].size, &len[i]);
+        }
+        else
+        {
+            p = ops[i].pair;
+            if ((p >= 0) && (off[p] != UINT32_MAX))
+            {
+                simFree(h, off[p], len[p]);
+            }
+        }
+    }
+    if (offsets)
+    {
+        memcpy(offsets, off, sizeof(uint32_t) * opCnt);
+    }
+    free(off);
+    free(len);
+}
+
+/* 不失败地回放所需的最小堆大小 */
+static uint32_t simMinHeap(FitPolicy_t policy, uint32_t from, uint32_t limit)
+{
+    SimHeap_t h;
+    uint32_t size;
+    uint32_t step = header.usAlignment;
+
+    for (size = from; size <= limit; size += step)
+    {
+        simReplay(&h, policy, size, NULL);
+        simFreeList(&h);
+        if (h.fails == 0)
+        {
+            return size;
+        }
+    }
+    return 0;
+}
+
+/* 读取跟踪文件,并把释放与分配配对 */
+static int loadTrace(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    uint32_t *liveAddr;
+    int32_t *liveIdx;
+    uint32_t liveCnt = 0;
+    uint32_t i, j;
+
+    if (fp == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    if ((fread(&header, sizeof(header), 1, fp) != 1) || (header.ulMagic != TRACE_MAGIC))
+    {
+        fprintf(stderr, "%s: not a heap trace\n", path);
+        fclose(fp);
+        return -1;
+    }
+    if ((header.usVersion != TRACE_VERSION) || (header.usRecordSize != sizeof(TraceRecord_t)) ||
+        (header.usAlignment == 0) || (header.usAlignment & (header.usAlignment - 1)))
+    {
+        fprintf(stderr, "%s: unsupported trace version %u, record size %u, alignment %u\n",
+                path, header.usVersion, header.usRecordSize, header.usAlignment);
+        fclose(fp);
+        return -1;
+    }
+
+    records = calloc(header.ulCount + 1, sizeof(TraceRecord_t));
+    header.ulCount = (uint32_t)fread(records, sizeof(TraceRecord_t), header.ulCount, fp);
+    fclose(fp);
+
+    ops = calloc(header.ulCount + 1, sizeof(ReplayOp_t));
+    liveAddr = malloc(sizeof(uint32_t) * (header.ulCount + 1));
+    liveIdx = malloc(sizeof(int32_t) * (header.ulCount + 1));
+    opCnt = 0;
+    for (i = 0; i < header.ulCount; i++)
+    {
+        ops[i].op = records[i].ucOp;
+        ops[i].size = records[i].usSize;
+        ops[i].pair = -1;
+        if (records[i].ucOp == TRACE_MALLOC)
+        {
+            if (records[i].ulAddress)
+            {
+                liveAddr[liveCnt] = records[i].ulAddress;
+                liveIdx[liveCnt++] = (int32_t)i;
+            }
+        }
+        else
+        {
+            for (j = 0; j < liveCnt; j++)
+            {
+                if (liveAddr[j] == records[i].ulAddress)
+                {
+                    ops[i].pair = liveIdx[j];
+                    liveAddr[j] = liveAddr[--liveCnt];
+                    liveIdx[j] = liveIdx[liveCnt];
+                    break;
+                }
+            }
+        }
+        opCnt++;
+    }
+    free(liveAddr);
+    free(liveIdx);
+    return 0;
+}
+
+static double cyclesToUs(double cycles)
+{
+    return header.ulCycleHz ? cycles * 1e6 / header.ulCycleHz : 0.0;
+}
+
+/* 跟踪本身的统计:调用次数、失败、峰值、目标板上测得的耗时 */
+static void reportTrace(uint32_t *peakBlock)
+{
+    uint32_t i, n[2] = {0, 0}, maxCyc[2] = {0, 0}, failed = 0, unmatched = 0;
+    uint64_t sumCyc[2] = {0, 0};
+    uint64_t live = 0, liveBlock = 0, peak = 0, peakB = 0;
+    uint32_t mask = header.usAlignment - 1;
+    int32_t p;
+
+    for (i = 0; i < opCnt; i++)
+    {
+        TraceRecord_t *r = &records[i];
+        int op = r->ucOp ? TRACE_FREE : TRACE_MALLOC;
+
+        n[op]++;
+        sumCyc[op] += r->usCycles;
+        if (maxCyc[op] < r->usCycles)
+        {
+            maxCyc[op] = r->usCycles;
+        }
+
+        if (op == TRACE_MALLOC)
+        {
+            if (r->ulAddress == 0)
+            {
+                failed++;
+                continue;
+            }
+            live += r->usSize;
+            liveBlock += blockSize(r->usSize, header.usHeaderSize, mask);
+            if (peak < live)
+            {
+                peak = live;
+            }
+            if (peakB < liveBlock)
+            {
+                peakB = liveBlock;
+            }
+        }
+        else
+        {
+            p = ops[i].pair;
+            if (p < 0)
+            {
+                unmatched++;
+                continue;
+            }
+            live -= records[p].usSize;
+            liveBlock -= blockSize(records[p].usSize, header.usHeaderSize, mask);
+        }
+    }
+
+    printf("trace:   %u records (malloc %u, free %u), dropped %u, target failures %u, unmatched frees %u, %u ms\n",
+           opCnt, n[TRACE_MALLOC], n[TRACE_FREE], header.ulDropped, failed, unmatched,
+           opCnt ? records[opCnt - 1].ulTime - records[0].ulTime : 0);
+    printf("target:  heap %u bytes at 0x%08x, block header %u, alignment %u, cycle %u Hz\n",
+           header.ulHeapSize, header.ulHeapStart, header.usHeaderSize, header.usAlignment, header.ulCycleHz);
+    printf("peak:    %llu bytes requested, %llu bytes in blocks; live at end %llu bytes\n",
+           (unsigned long long)peak, (unsigned long long)peakB, (unsigned long long)live);
+    for (i = 0; i < 2; i++)
+    {
+        if (n[i])
+        {
+            printf("latency: %-6s avg %.2f us, max %.2f us (%u cycles)\n", i ? "free" : "malloc",
+                   cyclesToUs((double)sumCyc[i] / n[i]), cyclesToUs(maxCyc[i]), maxCyc[i]);
+        }
+    }
+    if (header.ulDropped)
+    {
+        printf("note:    %u records were dropped, peak and sizing cover only the recorded part\n",
+               header.ulDropped);
+    }
+    *peakBlock = (uint32_t)peakB;
+}
+
+/* 回放heap_4模型,检查块地址是否与目标板一致 */
+static void reportFidelity(void)
+{
+    SimHeap_t h;
+    uint32_t *off = malloc(sizeof(uint32_t) * (opCnt + 1));
+    uint32_t i, total = 0, match = 0;
+
+    if (header.ulDropped)
+    {
+        free(off);
+        return;
+    }
+    simReplay(&h, FIT_FIRST, header.ulHeapSize, off);
+    simFreeList(&h);
+    for (i = 0; i < opCnt; i++)
+    {
+        if ((ops[i].op == TRACE_MALLOC) && records[i].ulAddress)
+        {
+            total++;
+            if ((off[i] != UINT32_MAX) &&
+                (header.ulHeapStart + off[i] + header.usHeaderSize == records[i].ulAddress))
+            {
+                match++;
+            }
+        }
+    }
+    printf("model:   heap_4 replay reproduces %u of %u target addresses\n", match, total);
+    free(off);
+}
+
+static void reportAllocators(uint32_t heapSize, uint32_t peakBlock)
+{
+    SimHeap_t h;
+    uint32_t policy, minHeap;
+    uint32_t from = peakBlock + header.usHeaderSize;
+    uint32_t limit = (heapSize > from ? heapSize : from) * 8 + 4096;
+
+    from = (from + header.usAlignment - 1) & ~(uint32_t)(header.usAlignment - 1);
+
+    printf("\n%-9s %7s %5s %9s %8s %8s %13s %13s %8s\n", "allocator", "heap", "fail", "peak_used",
+           "min_free", "max_frag", "malloc_visit", "free_visit", "min_heap");
+    for (policy = 0; policy < FIT_NUM; policy++)
+    {
+        simReplay(&h, (FitPolicy_t)policy, heapSize, NULL);
+        simFreeList(&h);
+        minHeap = simMinHeap((FitPolicy_t)policy, from, limit);
+
+        printf("%-9s %7u %5u %9u %8u %7.1f%% %6.1f/%-6u %6.1f/%-6u %8u\n", fitName[policy], heapSize,
+               h.fails, h.peakUsed, h.minFree, h.maxFrag * 100.0,
+               h.calls[0] ? (double)h.visits[0] / h.calls[0] : 0.0, h.maxVisits[0],
+               h.calls[1] ? (double)h.visits[1] / h.calls[1] : 0.0, h.maxVisits[1], minHeap);
+    }
+    printf("(visit: free-list blocks examined per call, avg/max; min_heap 0 = not found below %u)\n", limit);
+}
+
+static int compareCaller(const void *a, const void *b)
+{
+    const CallerStat_t *x = a, *y = b;
+
+    return (x->bytes < y->bytes) ? 1 : (x->bytes > y->bytes) ? -1 : 0;
+}
+
+/* 按调用者统计,live为跟踪结束时仍未释放的块数(泄漏候选) */
+static void reportCallers(uint32_t top)
+{
+    CallerStat_t *st = calloc(opCnt + 1, sizeof(CallerStat_t));
+    uint8_t *freed = calloc(opCnt + 1, 1);
+    uint32_t cnt = 0, i, j;
+
+    for (i = 0; i < opCnt; i++)
+    {
+        if ((ops[i].op == TRACE_FREE) && (ops[i].pair >= 0))
+        {
+            freed[ops[i].pair] = 1;
+        }
+    }
+    for (i = 0; i < opCnt; i++)
+    {
+        if (ops[i].op != TRACE_MALLOC)
+        {
+            continue;
+        }
+        for (j = 0; (j < cnt) && (st[j].caller != records[i].ulCaller); j++)
+        {
+        }
+        if (j == cnt)
+        {
+            st[cnt++].caller = records[i].ulCaller;
+        }
+        st[j].calls++;
+        st[j].bytes += records[i].usSize;
+        if (st[j].maxSize < records[i].usSize)
+        {
+            st[j].maxSize = records[i].usSize;
+        }
+        if (records[i].ulAddress && !freed[i])
+        {
+            st[j].live++;
+        }
+    }
+    qsort(st, cnt, sizeof(CallerStat_t), compareCaller);
+
+    printf("\n%-10s %7s %9s %8s %5s\n", "caller", "calls", "bytes", "max_size", "live");
+    for (i = 0; (i < cnt) && (i < top); i++)
+    {
+        printf("0x%08x %7u %9llu %8u %5u\n", st[i].caller, st[i].calls,
+               (unsigned long long)st[i].bytes, st[i].maxSize, st[i].live);
+    }
+    free(st);
+    free(freed);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = NULL;
+    uint32_t heapSize = 0;
+    uint32_t top = 10;
+    uint32_t peakBlock;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))
+        {
+            heapSize = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "-c") == 0) && (i + 1 < argc))
+        {
+            top = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+    if (path == NULL)
+    {
+        fprintf(stderr, "usage: %s trace.bin [-s heap_size] [-c callers]\n", argv[0]);
+        return 1;
+    }
+    if (loadTrace(path) != 0)
+    {
+        return 1;
+    }
+    if (heapSize == 0)
+    {
+        heapSize = header.ulHeapSize;
+    }
+
+    reportTrace(&peakBlock);
+    reportFidelity();
+    reportAllocators(heapSize, peakBlock);
+    reportCallers(top);
+
+    free(records);
+    free(ops);
+    return 0;
+}
@@ -0,0 +1,39 @@
+#ifndef _OS_HARDWARE_H_
+#define _OS_HARDWARE_H_
+
+/* 主机端工具使用的osHardware.h替身:无中断,临界段为空 */
+#include "osConfig.h" 
+#include "osTypedef.h"
+
+#define ENTER_CRITICAL()    do{}while(0)
+#define EXIT_CRITICAL()     do{}while(0)
+#define MEMORY_BARRIER()    __atomic_thread_fence(__ATOMIC_ACQ_REL)
+
+#ifndef TICK_RATE_HZ
+	#define TICK_RATE_HZ   		1000u
+#endif
+
+/* 系统定时器运行周期us */
+#define TICK_CYCLICITY_US 	(1000000u / TICK_RATE_HZ)	
+
+#if EN_THREAD
+/* 线程上下文切换用ucontext代替目标板的汇编实现 */
+#include <ucontext.h>
+typedef ucontext_t tThreadContext;
+
+static inline void thread_context_init(tThreadContext *pCtx, void *pStack, uint32_t stackSize, void (*pfEntry)(void))
+{
+	getcontext(pCtx);
+	pCtx->uc_stack.ss_sp = pStack;
+	pCtx->uc_stack.ss_size = stackSize;
+	pCtx->uc_link = NULL;
+	makecontext(pCtx, pfEntry, 0);
+}
+
+static inline void thread_context_switch(tThreadContext *pSave, tThreadContext *pTo)
+{
+	swapcontext(pSave, pTo);
+}
+#endif
+
+#endif
@@ -0,0 +1,138 @@
+/*-----------------------------------------------File Info------------------------------------------------
+** File Name:               queue_bench.c  
+** Descriptions:            主机端osQueue.c性能测试,比较加锁逐条复制的队列与无锁SPSC队列,用法见说明.txt
+**                          gcc -O2 -Itools/host -IosConfig -IOS tools/queue_bench.c OS/osQueue.c -lpthread -o queue_bench
+**--------------------------------------------------------------------------------------------------------
+*/
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include "osConfig.h"
+#include "osTypedef.h"
+#include "osQueue.h"
+
+#define BENCH_DEEP		256u		/* 队列深度 */
+#define BENCH_MSGS		4000000u	/* 单项测试传递的消息数 */
+#define BENCH_WIDTH_MAX	16u
+
+void disDebugTypedefPrintf(const char *s, ...)
+{
+	(void)s;
+}
+
+static uint8_t gBuf[BENCH_DEEP * BENCH_WIDTH_MAX];
+static uint8_t gIn[64 * BENCH_WIDTH_MAX];
+static uint8_t gOut[64 * BENCH_WIDTH_MAX];
+static tsQueue gQueue;
+static tsSpscQueue gSpsc;
+
+static double prvNowNs(void)
+{
+	struct timespec ts;
+	
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* 单线程交替装入、取出,每次batch条,返回每条消息的纳秒数 */
+static double prvRunQueue(uint16_t width, uint16_t batch)
+{
+	uint32_t n;
+	double t0;
+	
+	create_queue(&gQueue, gBuf, BENCH_DEEP, width);
+	t0 = prvNowNs();
+	for(n=0; n < BENCH_MSGS; n += batch)
+	{
+		push_queue(&gQueue, gIn, batch);
+		pull_queue(&gQueue, gOut, batch);
+	}
+	return (prvNowNs() - t0) / BENCH_MSGS;
+}
+
+static double prvRunSpsc(uint16_t width, uint16_t batch)
+{
+	uint32_t n;
+	double t0;
+	
+	create_spsc_queue(&gSpsc, gBuf, BENCH_DEEP, width);
+	gSpsc.head = gSpsc.tail = 0xFFF0u;	/* 从计数回绕附近开始 */
+	t0 = prvNowNs();
+	for(n=0; n < BENCH_MSGS; n += batch)
+	{
+		push_spsc_queue(&gSpsc, gIn, batch);
+		pull_spsc_queue(&gSpsc, gOut, batch);
+	}
+	return (prvNowNs() - t0) / BENCH_MSGS;
+}
+
+/* 两个线程分别作为生产者和消费者,检查消息顺序 */
+static void *prvProducer(void *arg)
+{
+	uint32_t v;
+	
+	(void)arg;
+	for(v=0; v < BENCH_MSGS; )
+	{
+		if(push_spsc_queue(&gSpsc, &v, 1))
+			v++;
+		else
+			sched_yield();		/* 队列满,单核主机上让出给消费者 */
+	}
+	return NULL;
+}
+
+static uint32_t prvRunThreads(double *pNs)
+{
+	pthread_t th;
+	uint32_t v, expect = 0, errors = 0;
+	double t0;
+	
+	create_spsc_queue(&gSpsc, gBuf, BENCH_DEEP, sizeof(uint32_t));
+	t0 = prvNowNs();
+	pthread_create(&th, NULL, prvProducer, NULL);
+	while(expect < BENCH_MSGS)
+	{
+		if(pull_spsc_queue(&gSpsc, &v, 1))
+		{
+			if(v != expect)
+				errors++;
+			expect++;
+		}
+		else
+		{
+			sched_yield();
+		}
+	}
+	pthread_join(th, NULL);
+	*pNs = (prvNowNs() - t0) / BENCH_MSGS;
+	return errors;
+}
+
+int main(void)
+{
+	static const uint16_t widths[] = {4, 16};
+	static const uint16_t batches[] = {1, 8, 64};
+	uint16_t i, j, k;
+	uint32_t errors;
+	double ns;
+	
+	for(i=0; i < sizeof(gIn); i++)
+		gIn[i] = (uint8_t)i;
+	
+	for(i=0; i < sizeof(widths)/sizeof(widths[0]); i++)
+	{
+		for(j=0; j < sizeof(batches)/sizeof(batches[0]); j++)
+		{
+			printf("{\"width\":%u,\"batch\":%u,\"queue_ns\":%.2f,",
+				widths[i], batches[j], prvRunQueue(widths[i], batches[j]));
+			printf("\"spsc_ns\":%.2f,", prvRunSpsc(widths[i], batches[j]));
+			for(k=0; (k < batches[j] * widths[i]) && (gOut[k] == gIn[k]); k++)
+				;
+			printf("\"spsc_ok\":%u}\n", (unsigned)(k == batches[j] * widths[i]));
+		}
+	}
+	errors = prvRunThreads(&ns);
+	printf("{\"spsc_threads_ns\":%.2f,\"order_errors\":%u}\n", ns, (unsigned)errors);
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,202 @@
+/*-----------------------------------------------File Info------------------------------------------------
+** File Name:               thread_test.c
+** Descriptions:            主机端osThread.c测试,检查多个线程同时延时、等待队列及超时,用法见说明.txt
+**                          gcc -O2 -DEN_THREAD=1 -Itools/host -IosConfig -IOS tools/thread_test.c
+**                              OS/osThread.c OS/osQueue.c -o thread_test
+**--------------------------------------------------------------------------------------------------------
+** Descriptions:            get_os_time()由测试提供,每个TICK调用一次thread_scheduler(),结果与主机调度无关.
+**                          通过时输出PASS并返回0,否则输出失败原因并返回1.
+**--------------------------------------------------------------------------------------------------------
+*/
+#include <stdio.h>
+#include "osConfig.h"
+#include "osTypedef.h"
+#include "osQueue.h"
+#include "osThread.h"
+
+#if !EN_THREAD
+	#error "thread_test must be built with EN_THREAD=1"
+#endif
+
+#if(TICK_CYCLICITY_US != 1000u)
+	#error "thread_test assumes a 1mS tick"
+#endif
+
+#define TEST_STACK_SIZE		32768u		/* 线程栈字节数,主机上printf等库函数需要较大的栈 */
+#define TEST_TICKS			200u		/* 模拟的TICK数 */
+#define TEST_WAKE_MAX		16u
+
+static uint32_t gOsTime;
+static uint8_t gFailed;
+
+static uint64_t gStackA[TEST_STACK_SIZE / 8u];
+static uint64_t gStackB[TEST_STACK_SIZE / 8u];
+static uint64_t gStackC[TEST_STACK_SIZE / 8u];
+
+/* 延时线程的参数与每次醒来的时刻 */
+typedef struct
+{
+	uint16_t delayMs;
+	uint8_t loops;
+	uint8_t wakeCnt;
+	uint32_t wake[TEST_WAKE_MAX];
+	uint32_t sum;		/* 栈上的累加值,检查切换后局部变量保持不变 */
+	uint8_t done;
+}tsDelayArg;
+
+static tsDelayArg gArgA = {3u, 5u};
+static tsDelayArg gArgB = {5u, 3u};
+
+static tsQueue gQueue;
+static uint32_t gQueueBuf[4];
+static uint32_t gRecv[3];
+static uint32_t gRecvTime[3];
+static uint8_t gRecvCnt;
+static uint8_t gQueueDone;
+
+uint32_t get_os_time(void)
+{
+	return gOsTime;
+}
+
+void disDebugTypedefPrintf(const char *s, ...)
+{
+	(void)s;
+}
+
+#define TEST_CHECK(cond)	do{ if(!(cond)){ printf("FAIL: line %d: %s (tick %u)\n", __LINE__, #cond, (unsigned)gOsTime); gFailed = 1; } }while(0)
+
+/* 延时线程:每次延时delayMs,记录醒来时刻 */
+static void prvDelayThread(void *param)
+{
+	tsDelayArg *arg = (tsDelayArg *)param;
+	uint32_t sum = 0;
+	uint8_t i;
+
+	for(i=0; i < arg->loops; i++)
+	{
+		sum += i + 1u;
+		TEST_CHECK(thread_delay_ms(arg->delayMs));
+		arg->wake[arg->wakeCnt++] = get_os_time();
+	}
+	arg->sum = sum;
+	arg->done = 1;
+}
+
+/* 队列线程:有数据时立即醒来,超时返回0,不超时等待直到有数据 */
+static void prvQueueThread(void *param)
+{
+	uint32_t v;
+	uint32_t start;
+
+	(void)param;
+
+	/* 第4个TICK装入数据,应在第4个TICK醒来 */
+	TEST_CHECK(thread_pull_queue(&gQueue, &v, 1, 10) == 1);
+	gRecv[gRecvCnt] = v;
+	gRecvTime[gRecvCnt++] = get_os_time();
+
+	/* 没有数据,应恰好在10个TICK后超时 */
+	start = get_os_time();
+	TEST_CHECK(thread_pull_queue(&gQueue, &v, 1, 10) == 0);
+	TEST_CHECK(get_os_time() - start == 10u);
+
+	/* 不超时等待,第60个TICK装入数据 */
+	TEST_CHECK(thread_pull_queue(&gQueue, &v, 1, THREAD_WAIT_FOREVER) == 1);
+	gRecv[gRecvCnt] = v;
+	gRecvTime[gRecvCnt++] = get_os_time();
+
+	/* 队列中已有数据时不等待 */
+	TEST_CHECK(thread_pull_queue(&gQueue, &v, 1, 10) == 1);
+	gRecv[gRecvCnt] = v;
+	gRecvTime[gRecvCnt++] = get_os_time();
+	gQueueDone = 1;
+}
+
+static void prvCheckDelay(const char *name, const tsDelayArg *arg)
+{
+	uint8_t i;
+
+	if(!arg->done || (arg->wakeCnt != arg->loops))
+	{
+		printf("FAIL: %s finished %u of %u delays\n", name, (unsigned)arg->wakeCnt, (unsigned)arg->loops);
+		gFailed = 1;
+		return;
+	}
+	for(i=0; i < arg->wakeCnt; i++)
+	{
+		if(arg->wake[i] != (uint32_t)arg->delayMs * (i + 1u))
+		{
+			printf("FAIL: %s delay %u woke at tick %u\n", name, (unsigned)i, (unsigned)arg->wake[i]);
+			gFailed = 1;
+		}
+	}
+	if(arg->sum != (uint32_t)arg->loops * (arg->loops + 1u) / 2u)
+	{
+		printf("FAIL: %s stack local lost across switches\n", name);
+		gFailed = 1;
+	}
+}
+
+int main(void)
+{
+	uint32_t v;
+	uint8_t idA, idB, idC;
+
+	create_qu(gQueue, gQueueBuf);
+
+	idA = create_thread(prvDelayThread, &gArgA, gStackA, sizeof(gStackA));
+	idB = create_thread(prvDelayThread, &gArgB, gStackB, sizeof(gStackB));
+	idC = create_thread(prvQueueThread, NULL, gStackC, sizeof(gStackC));
+	TEST_CHECK((idA != THREAD_NONE) && (idB != THREAD_NONE) && (idC != THREAD_NONE));
+	TEST_CHECK(thread_next_ticks() == 0u);
+
+	for(gOsTime = 0; gOsTime < TEST_TICKS; gOsTime++)
+	{
+		if(gOsTime == 4u)
+		{
+			v = 0x1234u;
+			push_qu_one(gQueue, v);
+		}
+		if(gOsTime == 60u)
+		{
+			v = 0x5678u;
+			push_qu_one(gQueue, v);
+			v = 0x9ABCu;
+			push_qu_one(gQueue, v);
+		}
+		thread_scheduler();
+
+		/* 第一轮后A、B同时延时,C等待队列,最近的是A在第3个TICK */
+		if(gOsTime == 0u)
+		{
+			TEST_CHECK(gtThread.state[idA] == THREAD_DELAY);
+			TEST_CHECK(gtThread.state[idB] == THREAD_DELAY);
+			TEST_CHECK(gtThread.state[idC] == THREAD_WAIT);
+			TEST_CHECK(thread_next_ticks() == 3u);
+		}
+		TEST_CHECK(thread_self() == THREAD_NONE);
+	}
+
+	prvCheckDelay("thread A", &gArgA);
+	prvCheckDelay("thread B", &gArgB);
+
+	TEST_CHECK(gQueueDone);
+	TEST_CHECK((gRecv[0] == 0x1234u) && (gRecvTime[0] == 4u));
+	TEST_CHECK((gRecv[1] == 0x5678u) && (gRecvTime[1] == 60u));
+	TEST_CHECK((gRecv[2] == 0x9ABCu) && (gRecvTime[2] == 60u));
+
+	/* 线程函数返回后释放,可以再次创建 */
+	TEST_CHECK(gtThread.state[idA] == THREAD_FREE);
+	TEST_CHECK(gtThread.state[idB] == THREAD_FREE);
+	TEST_CHECK(gtThread.state[idC] == THREAD_FREE);
+	TEST_CHECK(thread_next_ticks() == TICKS_NONE);
+	TEST_CHECK(create_thread(prvDelayThread, &gArgA, gStackA, sizeof(gStackA)) == idA);
+
+	/* 不在线程中调用时不切换 */
+	TEST_CHECK(!thread_delay_ms(1));
+	TEST_CHECK(thread_pull_queue(&gQueue, &v, 1, 10) == 0);
+
+	printf(gFailed ? "FAIL\n" : "PASS\n");
+	return gFailed ? 1 : 0;
+}
@@ -4,6 +4,14 @@
 
 #include <stdint.h>
 
+/**
+ * @brief protothread函数返回值
+ */
+#define PT_WAITING 0 // 等待中
+#define PT_YIELDED 1 // 让出
+#define PT_EXITED 2  // 通过PT_EXIT退出
+#define PT_ENDED 3   // 执行到PT_END结束
+
 /**
  * @brief Protothread 状态结构
  * 仅保存行号，极其轻量
@@ -30,10 +38,10 @@ typedef struct pt
 /**
  * @brief 结束protothread定义
  */
-#define PT_END(pt) \
-    }              \
-    (pt)->lc = 0;  \
-    return 0;      \
+#define PT_END(pt)   \
+    }                \
+    (pt)->lc = 0;    \
+    return PT_ENDED; \
     }
 
 /**
@@ -79,11 +87,11 @@ typedef struct pt
 /**
  * @brief 退出protothread
  */
-#define PT_EXIT(pt)   \
-    do                \
-    {                 \
-        (pt)->lc = 0; \
-        return 2;     \
+#define PT_EXIT(pt)       \
+    do                    \
+    {                     \
+        (pt)->lc = 0;     \
+        return PT_EXITED; \
     } while (0)
 
 /**
@@ -99,7 +107,7 @@ typedef struct pt
 /**
  * @brief 检查protothread是否结束
  */
-#define PT_SCHEDULE(f) ((f) < 2)
+#define PT_SCHEDULE(f) ((f) < PT_EXITED)
 
 /**
  * @brief 定义protothread函数类型
@@ -0,0 +1,140 @@
+/****************************************************************************************
+ * 文件名  ：hal_posix.c
+ * 描述    ：OSAL主机(POSIX)移植的中断模拟与HAL时基
+ * 开发平台：Linux / gcc / pthread
+ ***************************************************************************************/
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <errno.h>
+#include "py32f4xx_hal.h"
+
+static pthread_mutex_t irqLock = PTHREAD_MUTEX_INITIALIZER; // 中断锁，持有者即"关中断"
+static pthread_cond_t irqCond = PTHREAD_COND_INITIALIZER;   // 每次模拟中断结束后广播，用于唤醒WFI
+static uint32_t irqCount;                                   // 已执行的模拟中断次数
+static volatile uint32_t irqWaiting;                        // 等待执行的模拟中断数
+
+static __thread uint32_t irqMasked; // 本线程是否持有中断锁
+static __thread uint32_t irqInIsr;  // 本线程是否在模拟中断中，中断内开中断无效(不支持中断嵌套)
+
+//关中断，可重复调用
+void osal_host_irq_disable(void)
+{
+    if (!irqMasked)
+    {
+        pthread_mutex_lock(&irqLock);
+        irqMasked = 1;
+    }
+}
+
+//开中断，中断上下文中调用无效
+void osal_host_irq_enable(void)
+{
+    if (irqMasked && !irqInIsr)
+    {
+        irqMasked = 0;
+        pthread_mutex_unlock(&irqLock);
+
+        // 互斥锁不保证公平，主循环反复开关中断会让等待的中断迟迟拿不到锁
+        if (irqWaiting)
+        {
+            sched_yield();
+        }
+    }
+}
+
+uint32_t osal_host_irq_masked(void)
+{
+    return irqMasked;
+}
+
+//等待下一次模拟中断，与MCU的WFI一样关中断时调用也能被唤醒，返回时仍保持调用前的中断状态
+void osal_host_wfi(void)
+{
+    uint32_t masked = irqMasked;
+    uint32_t count;
+
+    if (!masked)
+    {
+        pthread_mutex_lock(&irqLock);
+    }
+
+    count = irqCount;
+    while (count == irqCount)
+    {
+        pthread_cond_wait(&irqCond, &irqLock);
+    }
+
+    if (!masked)
+    {
+        pthread_mutex_unlock(&irqLock);
+    }
+}
+
+//以中断方式执行isr：等待主线程开中断后独占运行，结束后唤醒WFI
+void osal_host_irq(void (*isr)(void))
+{
+    uint32_t masked = irqMasked;
+
+    if (!masked)
+    {
+        __atomic_add_fetch(&irqWaiting, 1, __ATOMIC_RELAXED);
+        pthread_mutex_lock(&irqLock);
+        __atomic_sub_fetch(&irqWaiting, 1, __ATOMIC_RELAXED);
+        irqMasked = 1;
+    }
+    irqInIsr++;
+
+    isr();
+
+    irqInIsr--;
+    irqCount++;
+    pthread_cond_broadcast(&irqCond);
+
+    if (!masked)
+    {
+        irqMasked = 0;
+        pthread_mutex_unlock(&irqLock);
+    }
+}
+
+/*********************************************************************
+ * HAL时基
+ */
+static uint64_t halBaseNs; // HAL_Init()时刻的单调时钟
+
+static uint64_t halMonotonicNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+//HAL初始化：记录时基起点，OSAL滴答在osal_init_system()中由OSAL_TIMER_TICKINIT()启动
+HAL_StatusTypeDef HAL_Init(void)
+{
+    halBaseNs = halMonotonicNs();
+    return HAL_OK;
+}
+
+//主机上HAL_GetTick()直接取单调时钟，无需滴答累加
+void HAL_IncTick(void)
+{
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)((halMonotonicNs() - halBaseNs) / 1000000ULL);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    struct timespec ts;
+
+    ts.tv_sec = Delay / 1000U;
+    ts.tv_nsec = (long)(Delay % 1000U) * 1000000L;
+    while ((nanosleep(&ts, &ts) != 0) && (errno == EINTR))
+    {
+    }
+}
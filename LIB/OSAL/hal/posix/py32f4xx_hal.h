@@ -0,0 +1,86 @@
+/****************************************************************************************
+ * 文件名  ：py32f4xx_hal.h
+ * 描述    ：OSAL主机(POSIX)移植的芯片头文件替身，提供type.h等用到的CMSIS内核函数与HAL时基接口
+ * 开发平台：Linux / gcc / pthread
+ * 说明    ：主机上没有真实中断，用一把全局"中断锁"模拟PRIMASK：
+ *           关中断即获取中断锁，滴答线程等模拟中断在持有中断锁时运行，
+ *           因此临界区与中断服务函数的互斥关系和单核MCU一致。
+ ***************************************************************************************/
+#ifndef OSAL_POSIX_HAL_H
+#define OSAL_POSIX_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __NVIC_PRIO_BITS 3U // 与PY32F403一致，仅用于BASEPRI移位计算
+
+typedef enum
+{
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+// 模拟中断接口(hal_posix.c)
+extern void osal_host_irq_disable(void);     // 关中断：获取中断锁
+extern void osal_host_irq_enable(void);      // 开中断：释放中断锁
+extern uint32_t osal_host_irq_masked(void);  // 当前线程是否处于关中断/中断上下文
+extern void osal_host_wfi(void);             // 等待下一次模拟中断
+extern void osal_host_irq(void (*isr)(void)); // 以中断方式执行isr，可在任意线程调用
+
+// CMSIS内核函数的主机实现
+static inline void __disable_irq(void) { osal_host_irq_disable(); }
+static inline void __enable_irq(void) { osal_host_irq_enable(); }
+static inline uint32_t __get_PRIMASK(void) { return osal_host_irq_masked(); }
+
+static inline void __set_PRIMASK(uint32_t priMask)
+{
+    if (priMask)
+    {
+        osal_host_irq_disable();
+    }
+    else
+    {
+        osal_host_irq_enable();
+    }
+}
+
+// 主机没有中断优先级，BASEPRI非0等同于屏蔽全部中断
+static inline uint32_t __get_BASEPRI(void) { return osal_host_irq_masked(); }
+static inline void __set_BASEPRI(uint32_t basePri) { __set_PRIMASK(basePri); }
+
+static inline void __set_BASEPRI_MAX(uint32_t basePri)
+{
+    if (basePri)
+    {
+        osal_host_irq_disable();
+    }
+}
+
+static inline void __ISB(void) { __sync_synchronize(); }
+static inline void __DSB(void) { __sync_synchronize(); }
+static inline void __DMB(void) { __sync_synchronize(); }
+static inline void __WFI(void) { osal_host_wfi(); }
+static inline void __NOP(void) {}
+
+static inline uint32_t __CLZ(uint32_t value)
+{
+    return value ? (uint32_t)__builtin_clz(value) : 32U;
+}
+
+// HAL时基，HAL_GetTick()直接取单调时钟的毫秒数
+extern HAL_StatusTypeDef HAL_Init(void);
+extern void HAL_IncTick(void);
+extern uint32_t HAL_GetTick(void);
+extern void HAL_Delay(uint32_t Delay);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSAL_POSIX_HAL_H */
@@ -0,0 +1,253 @@
+/****************************************************************************************
+ * 文件名  ：osal_test_deadline.c
+ * 描述    ：绝对时刻定时器测试(主机)
+ * 开发平台：Linux / gcc / pthread
+ * 说明    ：开启OSAL_DEADLINE_TIMER编译，毫秒单位。测试全程关中断，滴答线程不会推进系统时钟，
+ *           由测试直接调用osalTimerUpdate()模拟滴答和滴答延后，结果与主机调度无关。检查：
+ *             - 周期定时器从上一次的到期时刻重载，处理延后不累积相位误差；
+ *             - 延后超过整个周期时跳过错过的周期，只发一次事件，跳过次数计入overruns；
+ *             - overruns在0xFFFF饱和，重新启动时清零；
+ *             - 系统时钟32位回绕前后的到期顺序、到期时刻与剩余时间正确；
+ *             - 单次定时器到期后释放，停止的定时器不再发出事件。
+ *           通过时输出PASS并返回0，否则输出失败原因并返回1。
+ ***************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "osal.h"
+#include "osal_event.h"
+#include "osal_timer.h"
+#include "osal_memory.h"
+#include "osal_deadline.h"
+
+#if !OSAL_DEADLINE_TIMER
+#error osal_test_deadline must be built with OSAL_DEADLINE_TIMER=1
+#endif
+#if OSAL_DEADLINE_US
+#error osal_test_deadline tests the millisecond unit
+#endif
+
+#define TEST_EVT_A          0x0001
+#define TEST_EVT_B          0x0002
+#define TEST_EVT_C          0x0004
+
+static uint8 testTaskId;
+static int testFailed;
+
+#define TEST_CHECK(cond)                                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(cond))                                                            \
+        {                                                                       \
+            printf("FAIL: line %d: %s (clock %lu)\n", __LINE__, #cond,          \
+                   (unsigned long)osal_GetSystemClock());                       \
+            testFailed = 1;                                                     \
+        }                                                                       \
+    } while (0)
+
+//推进系统时钟ms毫秒，一次调用模拟一个延后了ms-1个滴答的滴答处理
+static void testAdvance(uint32 ms)
+{
+    while (ms > 0xFFFFU)
+    {
+        osalTimerUpdate(0xFFFF);
+        ms -= 0xFFFFU;
+    }
+    if (ms)
+    {
+        osalTimerUpdate((uint16)ms);
+    }
+}
+
+//取出并清除测试任务上已发出的事件
+static uint16 testTakeEvents(void)
+{
+    OsalTadkREC_t *task = osalFindTask(testTaskId);
+    uint16 events = task->events;
+
+    osal_clear_event(testTaskId, events);
+    return events;
+}
+
+static uint32 testDeadline(uint16 event)
+{
+    uint32 deadline = 0;
+
+    TEST_CHECK(osal_get_deadline(testTaskId, event, &deadline) == SUCCESS);
+    return deadline;
+}
+
+//周期定时器从上一次的到期时刻重载，跳过错过的周期
+static void testReload(void)
+{
+    uint32 t0 = osal_GetSystemClock();
+
+    TEST_CHECK(osal_start_periodic_timer(testTaskId, TEST_EVT_A, 10) == SUCCESS);
+    TEST_CHECK(testDeadline(TEST_EVT_A) == t0 + 10);
+    TEST_CHECK(osal_deadline_next_timeout() == 10);
+
+    testAdvance(9);
+    TEST_CHECK(testTakeEvents() == 0);
+
+    // 延后3毫秒处理，下一次仍在t0 + 20
+    testAdvance(4);
+    TEST_CHECK(testTakeEvents() == TEST_EVT_A);
+    TEST_CHECK(testDeadline(TEST_EVT_A) == t0 + 20);
+    TEST_CHECK(osal_deadline_next_timeout() == 7);
+
+    // 恰好在到期时刻处理
+    testAdvance(7);
+    TEST_CHECK(testTakeEvents() == TEST_EVT_A);
+    TEST_CHECK(testDeadline(TEST_EVT_A) == t0 + 30);
+    TEST_CHECK(osal_deadline_overruns(testTaskId, TEST_EVT_A) == 0);
+
+    // 延后到t0 + 58：t0 + 30的到期发出一次事件，t0 + 40和t0 + 50被跳过
+    testAdvance(38);
+    TEST_CHECK(testTakeEvents() == TEST_EVT_A);
+    TEST_CHECK(testDeadline(TEST_EVT_A) == t0 + 60);
+    TEST_CHECK(osal_deadline_overruns(testTaskId, TEST_EVT_A) == 2);
+
+    // 恰好延后到下一个到期时刻t0 + 70，t0 + 60发出事件，t0 + 70被跳过
+    testAdvance(12);
+    TEST_CHECK(testTakeEvents() == TEST_EVT_A);
+    TEST_CHECK(testDeadline(TEST_EVT_A) == t0 + 80);
+    TEST_CHECK(osal_deadline_overruns(testTaskId, TEST_EVT_A) == 3);
+
+    // 长时间运行后相位不变
+    testAdvance(10 * 1000 - 70);
+    TEST_CHECK(testTakeEvents() == TEST_EVT_A);
+    TEST_CHECK(testDeadline(TEST_EVT_A) == t0 + 10 * 1000 + 10);
+
+    TEST_CHECK(osal_stop_deadline_timer(testTaskId, TEST_EVT_A) == SUCCESS);
+    TEST_CHECK(osal_stop_deadline_timer(testTaskId, TEST_EVT_A) == INVALID_EVENT_ID);
+    testAdvance(100);
+    TEST_CHECK(testTakeEvents() == 0);
+    TEST_CHECK(osal_deadline_next_timeout() == 0);
+}
+
+//跳过次数在0xFFFF饱和，重新启动时清零
+static void testOverrunSaturate(void)
+{
+    TEST_CHECK(osal_start_periodic_timer(testTaskId, TEST_EVT_B, 1) == SUCCESS);
+
+    testAdvance(0xFFF0);
+    TEST_CHECK(testTakeEvents() == TEST_EVT_B);
+    TEST_CHECK(osal_deadline_overruns(testTaskId, TEST_EVT_B) == 0xFFEF);
+
+    testAdvance(0x20);
+    TEST_CHECK(osal_deadline_overruns(testTaskId, TEST_EVT_B) == 0xFFFF);
+    testAdvance(0x20);
+    TEST_CHECK(osal_deadline_overruns(testTaskId, TEST_EVT_B) == 0xFFFF);
+    TEST_CHECK(testTakeEvents() == TEST_EVT_B);
+
+    TEST_CHECK(osal_start_periodic_timer(testTaskId, TEST_EVT_B, 1) == SUCCESS);
+    TEST_CHECK(osal_deadline_overruns(testTaskId, TEST_EVT_B) == 0);
+    TEST_CHECK(osal_stop_deadline_timer(testTaskId, TEST_EVT_B) == SUCCESS);
+}
+
+//系统时钟32位回绕前后的定时
+static void testWrap(void)
+{
+    uint32 now;
+
+    // 推进到回绕前6毫秒
+    testAdvance((uint32)(0xFFFFFFFAU - osal_GetSystemClock()));
+    now = osal_GetSystemClock();
+    TEST_CHECK(now == 0xFFFFFFFAU);
+
+    // C在回绕后到期，先启动；A在回绕前到期，仍须排在前面
+    TEST_CHECK(osal_start_deadline_timer(testTaskId, TEST_EVT_C, now + 10, 0) == SUCCESS);
+    TEST_CHECK(osal_start_deadline_timer(testTaskId, TEST_EVT_A, now + 3, 0) == SUCCESS);
+    TEST_CHECK(osal_start_periodic_timer(testTaskId, TEST_EVT_B, 4) == SUCCESS);
+    TEST_CHECK(testDeadline(TEST_EVT_C) == 4);
+    TEST_CHECK(osal_deadline_next_timeout() == 3);
+
+    testAdvance(3); // 0xFFFFFFFD
+    TEST_CHECK(testTakeEvents() == TEST_EVT_A);
+    TEST_CHECK(osal_get_deadline(testTaskId, TEST_EVT_A, &now) == INVALID_EVENT_ID);
+    TEST_CHECK(osal_deadline_next_timeout() == 1);
+
+    testAdvance(1); // 0xFFFFFFFE
+    TEST_CHECK(testTakeEvents() == TEST_EVT_B);
+    TEST_CHECK(testDeadline(TEST_EVT_B) == 2);
+    TEST_CHECK(osal_deadline_next_timeout() == 4);
+
+    testAdvance(2); // 0
+    TEST_CHECK(osal_GetSystemClock() == 0);
+    TEST_CHECK(testTakeEvents() == 0);
+
+    testAdvance(2); // 2
+    TEST_CHECK(testTakeEvents() == TEST_EVT_B);
+    TEST_CHECK(testDeadline(TEST_EVT_B) == 6);
+
+    testAdvance(1); // 3
+    TEST_CHECK(testTakeEvents() == 0);
+
+    // 延后越过回绕后的两个到期时刻，C和B同时发出，B跳过一个周期
+    testAdvance(8); // 11
+    TEST_CHECK(testTakeEvents() == (TEST_EVT_B | TEST_EVT_C));
+    TEST_CHECK(testDeadline(TEST_EVT_B) == 14);
+    TEST_CHECK(osal_deadline_overruns(testTaskId, TEST_EVT_B) == 1);
+    TEST_CHECK(osal_get_deadline(testTaskId, TEST_EVT_C, &now) == INVALID_EVENT_ID);
+
+    // 已过去的到期时刻在下一个滴答到期
+    now = osal_GetSystemClock();
+    TEST_CHECK(osal_start_deadline_timer(testTaskId, TEST_EVT_C, now - 5, 0) == SUCCESS);
+    TEST_CHECK(osal_deadline_next_timeout() == 1);
+    testAdvance(1);
+    TEST_CHECK(testTakeEvents() == TEST_EVT_C);
+
+    TEST_CHECK(osal_stop_deadline_timer(testTaskId, TEST_EVT_B) == SUCCESS);
+}
+
+//静态池用尽时返回NO_TIMER_AVAIL，释放后可以再次启动
+static void testPool(void)
+{
+    uint8 i;
+
+    for (i = 0; i < OSAL_DEADLINE_TIMERS; i++)
+    {
+        TEST_CHECK(osal_start_periodic_timer(testTaskId, (uint16)(0x0100U << i), 100) == SUCCESS);
+    }
+    TEST_CHECK(osal_start_periodic_timer(testTaskId, TEST_EVT_A, 100) == NO_TIMER_AVAIL);
+    TEST_CHECK(osal_start_periodic_timer(testTaskId, 0x0100, 50) == SUCCESS);
+
+    TEST_CHECK(osal_stop_deadline_timer(testTaskId, 0x0100) == SUCCESS);
+    TEST_CHECK(osal_start_periodic_timer(testTaskId, TEST_EVT_A, 100) == SUCCESS);
+
+    for (i = 1; i < OSAL_DEADLINE_TIMERS; i++)
+    {
+        TEST_CHECK(osal_stop_deadline_timer(testTaskId, (uint16)(0x0100U << i)) == SUCCESS);
+    }
+    TEST_CHECK(osal_stop_deadline_timer(testTaskId, TEST_EVT_A) == SUCCESS);
+    TEST_CHECK(osal_deadline_next_timeout() == 0);
+}
+
+static void testTaskInit(uint8 task_id)
+{
+    testTaskId = task_id;
+}
+
+static uint16 testTaskEventProcess(uint8 task_id, uint16 events)
+{
+    return 0;
+}
+
+int main(void)
+{
+    HAL_Init();
+
+    // 不再开中断：滴答线程的模拟中断拿不到中断锁，系统时钟只由测试推进
+    HAL_DISABLE_INTERRUPTS();
+    osal_init_system();
+    osal_add_Task(testTaskInit, testTaskEventProcess, 1);
+    osal_Task_init();
+    osal_mem_kick();
+
+    testReload();
+    testOverrunSaturate();
+    testWrap();
+    testPool();
+
+    printf(testFailed ? "FAIL\n" : "PASS\n");
+    return testFailed ? 1 : 0;
+}
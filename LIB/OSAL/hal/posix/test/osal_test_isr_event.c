@@ -0,0 +1,176 @@
+/****************************************************************************************
+ * 文件名  ：osal_test_isr_event.c
+ * 描述    ：osal_isr_set_event()并发压力测试(主机)
+ * 开发平台：Linux / gcc / pthread
+ * 说明    ：TEST_PRODUCERS个生产者线程模拟中断，不持中断锁、真正并行地调用osal_isr_set_event()，
+ *           分别向TEST_TASKS个任务置位各自独占的事件位；主循环同时在任务上下文中并入事件。
+ *           每个生产者置位后等待对应任务确认再置位下一次，因此每次置位都必须恰好收到一次事件：
+ *             - 事件丢失时生产者永远等不到确认，看门狗在TEST_STALL_MS内没有进展即判定失败；
+ *             - 任务收到没有对应置位的事件(重复或错位)时立即判定失败。
+ *           第一个任务的优先级为OSAL_PREEMPT_PRIO，开启OSAL_PREEMPT编译时它的事件由软件中断线程并入。
+ *           全部生产者完成TEST_ROUNDS次后输出PASS并返回0，否则输出失败原因并返回1。
+ ***************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "osal.h"
+#include "osal_event.h"
+#include "osal_timer.h"
+#include "osal_memory.h"
+
+#define TEST_TASKS      3       //接收事件的任务数
+#define TEST_PRODUCERS  8       //生产者线程数，每个生产者独占一个(任务, 事件位)
+#define TEST_ROUNDS     5000    //每个生产者的置位次数
+#define TEST_STALL_MS   2000    //看门狗判定停滞的时间
+
+static uint8 testTaskId[TEST_TASKS];
+static uint8 testTaskCnt;
+static uint32 testSent[TEST_PRODUCERS];  // 生产者已置位的次数
+static uint32 testAcked[TEST_PRODUCERS]; // 任务已确认的次数
+static uint32 testAckedTotal;
+
+//生产者k对应的任务序号与事件位
+#define TEST_TASK_OF(k)     ((k) % TEST_TASKS)
+#define TEST_EVENT_OF(k)    ((uint16)(1U << ((k) / TEST_TASKS)))
+
+static void testFail(const char *reason)
+{
+    uint8 k;
+
+    printf("FAIL: %s\n", reason);
+    for (k = 0; k < TEST_PRODUCERS; k++)
+    {
+        printf("producer %u: sent %u, acked %u\n", (unsigned)k,
+               (unsigned)__atomic_load_n(&testSent[k], __ATOMIC_ACQUIRE),
+               (unsigned)__atomic_load_n(&testAcked[k], __ATOMIC_ACQUIRE));
+    }
+    exit(1);
+}
+
+//生产者线程：模拟中断置位事件，等任务确认后再置位下一次
+static void *testProducerEntry(void *arg)
+{
+    uint8 k = (uint8)(uintptr_t)arg;
+    uint8 task_id = testTaskId[TEST_TASK_OF(k)];
+    uint16 event = TEST_EVENT_OF(k);
+    uint32 i;
+
+    for (i = 1; i <= TEST_ROUNDS; i++)
+    {
+        __atomic_store_n(&testSent[k], i, __ATOMIC_RELEASE);
+        if (osal_isr_set_event(task_id, event) != ZSUCCESS)
+        {
+            testFail("osal_isr_set_event rejected a valid task");
+        }
+
+        while (__atomic_load_n(&testAcked[k], __ATOMIC_ACQUIRE) != i)
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+//看门狗线程：确认总数在TEST_STALL_MS内没有变化即认为有事件丢失
+static void *testWatchdogEntry(void *arg)
+{
+    struct timespec ts = {TEST_STALL_MS / 1000, (TEST_STALL_MS % 1000) * 1000000L};
+    uint32 last = 0;
+    uint32 now;
+
+    for (;;)
+    {
+        nanosleep(&ts, NULL);
+        now = __atomic_load_n(&testAckedTotal, __ATOMIC_ACQUIRE);
+        if (now == last)
+        {
+            testFail("no progress, an event was lost");
+        }
+        last = now;
+    }
+    return NULL;
+}
+
+static void testTaskInit(uint8 task_id)
+{
+    testTaskId[testTaskCnt++] = task_id;
+}
+
+static uint16 testTaskEventProcess(uint8 task_id, uint16 events)
+{
+    uint8 t;
+    uint8 k;
+    uint32 sent;
+    uint32 acked;
+
+    for (t = 0; t < TEST_TASKS; t++)
+    {
+        if (testTaskId[t] == task_id)
+        {
+            break;
+        }
+    }
+
+    for (k = t; k < TEST_PRODUCERS; k += TEST_TASKS)
+    {
+        if (!(events & TEST_EVENT_OF(k)))
+        {
+            continue;
+        }
+        events &= ~TEST_EVENT_OF(k);
+
+        sent = __atomic_load_n(&testSent[k], __ATOMIC_ACQUIRE);
+        acked = testAcked[k];
+        if (sent != acked + 1)
+        {
+            testFail("event delivered without a matching post");
+        }
+        __atomic_store_n(&testAcked[k], sent, __ATOMIC_RELEASE);
+
+        if (__atomic_add_fetch(&testAckedTotal, 1, __ATOMIC_ACQ_REL) == TEST_PRODUCERS * TEST_ROUNDS)
+        {
+            printf("%u events from %u producers to %u tasks\n",
+                   (unsigned)(TEST_PRODUCERS * TEST_ROUNDS), (unsigned)TEST_PRODUCERS, (unsigned)TEST_TASKS);
+            printf("PASS\n");
+            exit(0);
+        }
+    }
+
+    if (events)
+    {
+        testFail("event bit that no producer posts");
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    pthread_t thread;
+    uint8 k;
+
+    setvbuf(stdout, NULL, _IONBF, 0);
+    HAL_Init();
+
+    HAL_DISABLE_INTERRUPTS();
+    osal_init_system();
+    for (k = 0; k < TEST_TASKS; k++)
+    {
+        osal_add_Task(testTaskInit, testTaskEventProcess, (k == 0) ? OSAL_PREEMPT_PRIO : 1);
+    }
+    osal_Task_init();
+    osal_mem_kick();
+    HAL_ENABLE_INTERRUPTS();
+
+    for (k = 0; k < TEST_PRODUCERS; k++)
+    {
+        pthread_create(&thread, NULL, testProducerEntry, (void *)(uintptr_t)k);
+    }
+    pthread_create(&thread, NULL, testWatchdogEntry, NULL);
+
+    // 不会返回，全部事件确认后由任务处理函数退出进程
+    osal_start_system();
+    return 0;
+}
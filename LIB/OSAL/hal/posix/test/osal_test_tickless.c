@@ -0,0 +1,200 @@
+/****************************************************************************************
+ * 文件名  ：osal_test_tickless.c
+ * 描述    ：无滴答模式定时器到期时间测试(主机)
+ * 开发平台：Linux / gcc / pthread
+ * 说明    ：开启OSAL_TICKLESS编译。测试任务启动一组单次定时器和一个周期定时器，
+ *           另有一个干扰线程以随机间隔触发空的模拟中断，让无滴答睡眠频繁被提前唤醒。
+ *           每个定时器到期时检查：
+ *             - OSAL系统时钟与单调时钟经过的时间都不少于定时时间(单调时钟按毫秒取整，允许少1毫秒)；
+ *             - 两者超出定时时间不多于TEST_LATE_MS，该余量用于容纳主机线程调度延迟；
+ *           周期定时器每次到期时检查其剩余时间与OSAL系统时钟对齐，周期没有因补偿而漂移；
+ *           全部到期后检查OSAL系统时钟是否仍跟随单调时钟。
+ *           通过时输出PASS并返回0，否则输出失败原因并返回1。
+ ***************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include "osal.h"
+#include "osal_event.h"
+#include "osal_timer.h"
+#include "osal_memory.h"
+
+#if !OSAL_TICKLESS
+#error osal_test_tickless must be built with OSAL_TICKLESS=1
+#endif
+
+#define TEST_LATE_MS        20      //允许的到期延迟，来自主机线程调度
+#define TEST_RELOAD_MS      7       //周期定时器周期
+#define TEST_RELOAD_EVT     0x4000  //周期定时器事件
+#define TEST_START_EVT      0x2000  //开中断后启动定时器
+#define TEST_NOISE_MAX_US   3000    //干扰中断的最大间隔
+
+// 单次定时器：每个使用一个事件位，包含超过单次睡眠上限(1秒)的定时
+static const uint16 testTimeout[] = {2, 3, 10, 25, 64, 150, 400, 999, 1500};
+#define TEST_TIMERS (sizeof(testTimeout) / sizeof(testTimeout[0]))
+
+static uint8 testTaskId;
+static uint32 testStartClock;   // 启动定时器时的OSAL系统时钟
+static uint32 testStartTick;    // 启动定时器时的单调时钟(毫秒)
+static uint16 testFiredMask;    // 已到期的单次定时器
+static uint32 testReloadCount;  // 周期定时器到期次数
+static uint32 testNoiseCount;   // 干扰中断次数
+static int testFailed;
+
+static void testNoiseIsr(void)
+{
+    testNoiseCount++;
+}
+
+//干扰线程：随机间隔触发不置任何事件的模拟中断
+static void *testNoiseEntry(void *arg)
+{
+    struct timespec ts;
+    uint32 seed = 12345;
+
+    for (;;)
+    {
+        seed = seed * 1103515245U + 12345U;
+        ts.tv_sec = 0;
+        ts.tv_nsec = (long)((seed >> 8) % TEST_NOISE_MAX_US) * 1000L;
+        nanosleep(&ts, NULL);
+        osal_host_irq(testNoiseIsr);
+    }
+    return NULL;
+}
+
+static void testFinish(void)
+{
+    uint32 clockElapsed = osal_GetSystemClock() - testStartClock;
+    uint32 realElapsed = HAL_GetTick() - testStartTick;
+
+    printf("osal clock %u ms, monotonic %u ms, reload %u, noise irq %u\n",
+           (unsigned)clockElapsed, (unsigned)realElapsed, (unsigned)testReloadCount,
+           (unsigned)testNoiseCount);
+
+    if ((clockElapsed > realElapsed + 1) || (realElapsed > clockElapsed + 1))
+    {
+        printf("FAIL: osal clock drifted from monotonic clock\n");
+        testFailed = 1;
+    }
+
+    printf(testFailed ? "FAIL\n" : "PASS\n");
+    exit(testFailed ? 1 : 0);
+}
+
+//在关中断状态下同时记录两个时钟并启动定时器，之后的到期时间都以此为起点
+static void testStart(void)
+{
+    halIntState_t intState;
+    uint8 i;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    testStartClock = osal_GetSystemClock();
+    testStartTick = HAL_GetTick();
+
+    for (i = 0; i < TEST_TIMERS; i++)
+    {
+        osal_start_timerEx(testTaskId, (uint16)(1U << i), testTimeout[i]);
+    }
+    osal_start_reload_timer(testTaskId, TEST_RELOAD_EVT, TEST_RELOAD_MS);
+    HAL_EXIT_CRITICAL_SECTION(intState);
+}
+
+static void testTaskInit(uint8 task_id)
+{
+    testTaskId = task_id;
+    // 初始化时中断尚未开启，滴答还没有计入初始化期间经过的时间，等进入主循环再启动定时器
+    osal_set_event(testTaskId, TEST_START_EVT);
+}
+
+//处理函数可能被调度延迟，两次到期会合并为一次事件，因此不数次数，只检查周期相位
+static void testCheckReload(void)
+{
+    halIntState_t intState;
+    uint32 clockElapsed;
+    uint16 remain;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    clockElapsed = osal_GetSystemClock() - testStartClock;
+    remain = osal_get_timeoutEx(testTaskId, TEST_RELOAD_EVT);
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    testReloadCount++;
+    if (remain != TEST_RELOAD_MS - clockElapsed % TEST_RELOAD_MS)
+    {
+        printf("FAIL: reload timer due in %u ms at osal clock %u ms\n",
+               (unsigned)remain, (unsigned)clockElapsed);
+        testFailed = 1;
+    }
+}
+
+static uint16 testTaskEventProcess(uint8 task_id, uint16 events)
+{
+    uint32 clockElapsed = osal_GetSystemClock() - testStartClock;
+    uint32 realElapsed = HAL_GetTick() - testStartTick;
+    uint8 i;
+
+    if (events & TEST_START_EVT)
+    {
+        testStart();
+        return 0;
+    }
+
+    if (events & TEST_RELOAD_EVT)
+    {
+        testCheckReload();
+    }
+
+    for (i = 0; i < TEST_TIMERS; i++)
+    {
+        if (!(events & (1U << i)))
+        {
+            continue;
+        }
+
+        printf("timer %4u ms: osal clock %4u ms, monotonic %4u ms\n",
+               (unsigned)testTimeout[i], (unsigned)clockElapsed, (unsigned)realElapsed);
+
+        if ((clockElapsed < testTimeout[i]) || (clockElapsed > testTimeout[i] + TEST_LATE_MS))
+        {
+            printf("FAIL: timer %u ms expired at osal clock %u ms\n",
+                   (unsigned)testTimeout[i], (unsigned)clockElapsed);
+            testFailed = 1;
+        }
+        if ((realElapsed + 1 < testTimeout[i]) || (realElapsed > testTimeout[i] + TEST_LATE_MS))
+        {
+            printf("FAIL: timer %u ms expired at monotonic %u ms\n",
+                   (unsigned)testTimeout[i], (unsigned)realElapsed);
+            testFailed = 1;
+        }
+        testFiredMask |= (uint16)(1U << i);
+    }
+
+    if (testFiredMask == (uint16)((1U << TEST_TIMERS) - 1U))
+    {
+        testFinish();
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    pthread_t noise;
+
+    HAL_Init();
+
+    HAL_DISABLE_INTERRUPTS();
+    osal_init_system();
+    osal_add_Task(testTaskInit, testTaskEventProcess, 1);
+    osal_Task_init();
+    osal_mem_kick();
+    HAL_ENABLE_INTERRUPTS();
+
+    pthread_create(&noise, NULL, testNoiseEntry, NULL);
+
+    // 不会返回，全部定时器到期后由testFinish()退出进程
+    osal_start_system();
+    return 0;
+}
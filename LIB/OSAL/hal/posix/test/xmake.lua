@@ -0,0 +1,55 @@
+-- OSAL主机(POSIX)移植测试：每个测试一个可执行文件，通过时返回0
+-- 构建：xmake -P LIB/OSAL/hal/posix/test，运行全部：xmake run -a -P LIB/OSAL/hal/posix/test
+add_rules("mode.debug", "mode.release")
+
+set_project("osal-host-test")
+set_version("1.0.0")
+
+-- OSAL源文件与主机移植层，由各测试目标共用
+function add_osal_host()
+    set_kind("binary")
+    set_targetdir("dist")
+
+    add_files("../../../*.c")
+    add_files("../*.c")
+    add_includedirs("..")
+    add_includedirs("../../..")
+    add_includedirs("../..")
+    add_includedirs("../../../Protothreads")
+
+    add_cflags("-Wall", "-Wno-unused-parameter", {force = true})
+    add_syslinks("pthread", "m")
+
+    if is_mode("debug") then
+        add_cflags("-O0", "-g", {force = true})
+    else
+        add_cflags("-O2", {force = true})
+    end
+end
+
+-- 无滴答模式定时器到期时间，链表与时间轮两种定时器实现各测一次
+target("osal_test_tickless")
+    add_osal_host()
+    add_files("osal_test_tickless.c")
+    add_defines("OSAL_TICKLESS=1")
+
+target("osal_test_tickless_wheel")
+    add_osal_host()
+    add_files("osal_test_tickless.c")
+    add_defines("OSAL_TICKLESS=1", "OSAL_TIMER_WHEEL=1")
+
+-- 多个生产者线程并发调用osal_isr_set_event()，检查事件不丢失、不重复，协作与抢占两种调度各测一次
+target("osal_test_isr_event")
+    add_osal_host()
+    add_files("osal_test_isr_event.c")
+
+target("osal_test_isr_event_preempt")
+    add_osal_host()
+    add_files("osal_test_isr_event.c")
+    add_defines("OSAL_PREEMPT=1")
+
+-- 绝对时刻定时器：从上一次到期时刻重载、跳过错过的周期、跳过次数饱和、32位时钟回绕
+target("osal_test_deadline")
+    add_osal_host()
+    add_files("osal_test_deadline.c")
+    add_defines("OSAL_DEADLINE_TIMER=1")
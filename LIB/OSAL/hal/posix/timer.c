@@ -0,0 +1,202 @@
+/****************************************************************************************
+ * 文件名  ：timer.c
+ * 描述    ：OSAL主机(POSIX)移植的系统时钟，用timerfd + 滴答线程代替SysTick
+ * 开发平台：Linux / gcc / pthread
+ * 说明    ：滴答线程每1毫秒以模拟中断方式执行一次滴答中断函数，
+ *           滴答中断按单调时钟补齐尚未计入OSAL的毫秒数，线程调度延迟不会造成时钟漂移，
+ *           osal_GetSystemClock()因此始终跟随单调时钟。
+ *           抢占模式下另建一个软件中断线程代替PendSV。
+ ***************************************************************************************/
+#include <pthread.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include "timer.h"
+#include "osal_timer.h"
+#include "osal_event.h"
+
+static int tickFd = -1;        // 滴答timerfd
+static pthread_t tickThread;   // 滴答线程
+static uint32 tickAccounted;   // 已计入OSAL的单调时钟(毫秒)
+
+//编程滴答timerfd：interval为0表示单次定时
+static void osalHostTickArm(uint32 ms, uint32 interval)
+{
+    struct itimerspec its;
+
+    its.it_value.tv_sec = ms / 1000U;
+    its.it_value.tv_nsec = (long)(ms % 1000U) * 1000000L;
+    its.it_interval.tv_sec = interval / 1000U;
+    its.it_interval.tv_nsec = (long)(interval % 1000U) * 1000000L;
+    timerfd_settime(tickFd, 0, &its, NULL);
+}
+
+//补齐单调时钟与OSAL系统时钟之间的差值，需在关中断状态下调用，返回补齐的毫秒数
+static uint32 osalHostTickCatchUp(void)
+{
+    uint32 now = HAL_GetTick();
+    uint32 elapsed = now - tickAccounted;
+
+    tickAccounted = now;
+    return elapsed;
+}
+
+//滴答中断，对应目标板SysTick_Handler中的osalTimerUpdate(1)
+static void osalHostTickIsr(void)
+{
+    uint32 elapsed = osalHostTickCatchUp();
+    uint16 step;
+
+    while (elapsed)
+    {
+        step = (elapsed > 0xFFFFU) ? 0xFFFFU : (uint16)elapsed;
+        osalTimerUpdate(step);
+        elapsed -= step;
+    }
+}
+
+static void *osalHostTickEntry(void *arg)
+{
+    uint64_t expirations;
+
+    for (;;)
+    {
+        if (read(tickFd, &expirations, sizeof(expirations)) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        osal_host_irq(osalHostTickIsr);
+    }
+    return NULL;
+}
+
+//硬件定时器初始化，设定系统时钟：创建timerfd与滴答线程并开始1毫秒周期滴答
+void OSAL_TIMER_TICKINIT(void)
+{
+    tickAccounted = HAL_GetTick();
+
+    if (tickFd < 0)
+    {
+        tickFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        pthread_create(&tickThread, NULL, osalHostTickEntry, NULL);
+    }
+    osalHostTickArm(1, 1);
+}
+
+//与目标板SysTick一致，滴答常开，不随定时器启停
+void OSAL_TIMER_TICKSTART(void)
+{
+
+}
+
+void OSAL_TIMER_TICKSTOP(void)
+{
+
+}
+
+#if OSAL_PREEMPT
+static pthread_t swiThread;                                // 软件中断线程，代替PendSV
+static pthread_mutex_t swiLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t swiCond = PTHREAD_COND_INITIALIZER;
+static uint32 swiPending;                                  // 软件中断挂起标志
+
+static void *osalHostSwiEntry(void *arg)
+{
+    for (;;)
+    {
+        pthread_mutex_lock(&swiLock);
+        while (!swiPending)
+        {
+            pthread_cond_wait(&swiCond, &swiLock);
+        }
+        swiPending = 0;
+        pthread_mutex_unlock(&swiLock);
+
+        osal_host_irq(osal_preempt_run);
+    }
+    return NULL;
+}
+
+//创建软件中断线程。主机上抢占任务与被"抢占"的主线程实际并行运行，只在临界区互斥
+void OSAL_PREEMPT_INIT(void)
+{
+    static uint8 started;
+
+    if (!started)
+    {
+        started = 1;
+        pthread_create(&swiThread, NULL, osalHostSwiEntry, NULL);
+    }
+}
+
+//挂起软件中断，可在关中断或模拟中断中调用
+void OSAL_PREEMPT_PEND(void)
+{
+    pthread_mutex_lock(&swiLock);
+    swiPending = 1;
+    pthread_cond_signal(&swiCond);
+    pthread_mutex_unlock(&swiLock);
+}
+#endif
+
+//主机上以单调时钟的纳秒数作为周期计数
+void OSAL_CYCLE_INIT(void)
+{
+
+}
+
+uint32 OSAL_CYCLE_COUNT(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+uint32 OSAL_CYCLE_FREQ(void)
+{
+    return 1000000000U;
+}
+
+#if OSAL_TICKLESS
+// 单次定时的最长时间，保证睡眠时间小于32位纳秒周期计数的回绕周期(约4.29秒)
+#define TICKLESS_MAX_MS 1000U
+
+//停止周期滴答，编程一个ms毫秒后到期的单次定时，ms为0表示尽可能长，返回实际编程的毫秒数
+uint32 OSAL_TIMER_ONESHOT(uint32 ms)
+{
+    uint32 late;
+
+    if ((ms == 0) || (ms > TICKLESS_MAX_MS))
+    {
+        ms = TICKLESS_MAX_MS;
+    }
+
+    // 以已计入的时刻为起点，扣除尚未计入的部分
+    late = HAL_GetTick() - tickAccounted;
+    osalHostTickArm((ms > late) ? (ms - late) : 1U, 0);
+
+    return ms;
+}
+
+//恢复1毫秒周期滴答，返回睡眠期间经过、且尚未由滴答中断计入的整毫秒数
+uint32 OSAL_TIMER_RESUME(void)
+{
+    uint32 elapsed = osalHostTickCatchUp();
+
+    osalHostTickArm(1, 1);
+
+    return elapsed;
+}
+
+//关中断状态下调用，任意模拟中断结束后返回
+void OSAL_TIMER_SLEEP(void)
+{
+    __WFI();
+}
+#endif
@@ -6,6 +6,7 @@
  ***************************************************************************************/
 #include "timer.h"
 #include "osal_timer.h"
+#include "osal_event.h"
 
 //硬件定时器初始化，设定系统时钟
 void OSAL_TIMER_TICKINIT(void)
@@ -25,5 +26,137 @@ void OSAL_TIMER_TICKSTOP(void )
 
 }
 
+//启用DWT周期计数器，按内核时钟计数，不清零计数值，多个模块可重复调用
+void OSAL_CYCLE_INIT(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32 OSAL_CYCLE_COUNT(void)
+{
+    return DWT->CYCCNT;
+}
+
+uint32 OSAL_CYCLE_FREQ(void)
+{
+    return SystemCoreClock;
+}
+
+#if OSAL_PREEMPT
+/*
+ * 抢占模式使用PendSV作为软件中断，PendSV_Handler中调用osal_preempt_run()。
+ * PendSV设为最低优先级，只抢占主循环中的协作任务；SysTick至少比它高一级，
+ * 抢占任务运行超过1毫秒时滴答也不会丢失。
+ */
+void OSAL_PREEMPT_INIT(void)
+{
+    uint32 lowest = (1UL << __NVIC_PRIO_BITS) - 1UL;
+
+    NVIC_SetPriority(PendSV_IRQn, lowest);
+    if (NVIC_GetPriority(SysTick_IRQn) >= lowest)
+    {
+        NVIC_SetPriority(SysTick_IRQn, lowest - 1UL);
+    }
+}
+
+//挂起PendSV，开中断且没有更高优先级的中断在运行时立即执行
+void OSAL_PREEMPT_PEND(void)
+{
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+#endif
+
 //此处添加硬件定时器中断溢出函数，并调用系统时钟更新函数osal_update_timers()
 
+#if OSAL_TICKLESS
+/*
+ * 无滴答模式默认使用SysTick作为单次定时器，SysTick_Handler中仍按1毫秒调用osalTimerUpdate(1)。
+ * SysTick重装值只有24位，单次定时的最长时间受系统时钟限制，超出时分多次睡眠。
+ * 进入和退出单次定时时都保留不足1毫秒的部分，唤醒次数再多，系统时钟也不会落后于实际时间。
+ */
+#define TICKLESS_CYCLES_PER_MS (SystemCoreClock / 1000U)
+#define TICKLESS_MIN_CYCLES    32U // 恢复周期滴答时首个滴答的最短周期数，不足时并入下一个滴答
+
+static uint32 tickless_ms;    // 本次单次定时的毫秒数
+static uint32 tickless_phase; // 进入单次定时时当前毫秒已走过的周期数
+static uint32 tickless_ctrl;  // 停止状态下的SysTick控制字
+
+//停止周期滴答，编程一个ms毫秒后到期的单次定时，ms为0表示尽可能长，返回实际编程的毫秒数
+uint32 OSAL_TIMER_ONESHOT(uint32 ms)
+{
+    uint32 max_ms = SysTick_LOAD_RELOAD_Msk / TICKLESS_CYCLES_PER_MS;
+
+    if ((ms == 0) || (ms > max_ms))
+    {
+        ms = max_ms;
+    }
+
+    tickless_ctrl = SysTick->CTRL & ~(SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_COUNTFLAG_Msk);
+    SysTick->CTRL = tickless_ctrl;
+
+    // 从上一个滴答边界起算，到期时刻与周期滴答对齐
+    tickless_phase = SysTick->LOAD - SysTick->VAL;
+    SysTick->LOAD = ms * TICKLESS_CYCLES_PER_MS - tickless_phase - 1U;
+    SysTick->VAL = 0;
+    SysTick->CTRL = tickless_ctrl | SysTick_CTRL_ENABLE_Msk;
+
+    tickless_ms = ms;
+    return ms;
+}
+
+//恢复1毫秒周期滴答，返回睡眠期间经过、且尚未由滴答中断计入的整毫秒数
+uint32 OSAL_TIMER_RESUME(void)
+{
+    uint32 elapsed;
+    uint32 cycles;
+    uint32 i;
+
+    // 先停止计数再读COUNTFLAG，写CTRL不会清除该标志
+    SysTick->CTRL = tickless_ctrl;
+
+    if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk)
+    {
+        // 单次定时已到期，挂起的SysTick中断返回后会补上最后1毫秒；
+        // 计数器已从LOAD重新开始，LOAD - VAL为到期后又经过的周期数
+        cycles = SysTick->LOAD - SysTick->VAL;
+        elapsed = tickless_ms - 1U + cycles / TICKLESS_CYCLES_PER_MS;
+    }
+    else
+    {
+        // 被其他中断提前唤醒
+        cycles = SysTick->LOAD - SysTick->VAL + tickless_phase;
+        elapsed = cycles / TICKLESS_CYCLES_PER_MS;
+    }
+
+    // 不足1毫秒的部分留给下一个滴答：首个滴答只计余下的周期，之后恢复1毫秒周期
+    cycles = TICKLESS_CYCLES_PER_MS - cycles % TICKLESS_CYCLES_PER_MS;
+    if (cycles < TICKLESS_MIN_CYCLES)
+    {
+        elapsed++;
+        cycles += TICKLESS_CYCLES_PER_MS;
+    }
+
+    SysTick->LOAD = cycles - 1U;
+    SysTick->VAL = 0;
+    SysTick->CTRL = tickless_ctrl | SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = TICKLESS_CYCLES_PER_MS - 1U; // 下次重装时生效
+
+    // HAL时基同样需要补偿，保证HAL_GetTick()与HAL_Delay()正常
+    for (i = 0; i < elapsed; i++)
+    {
+        HAL_IncTick();
+    }
+
+    return elapsed;
+}
+
+//关中断状态下调用，挂起的中断可唤醒内核但需开中断后才会执行
+void OSAL_TIMER_SLEEP(void)
+{
+    __DSB();
+    __WFI();
+    __ISB();
+}
+#endif
+
@@ -8,4 +8,18 @@ extern void OSAL_TIMER_TICKINIT(void);
 extern void OSAL_TIMER_TICKSTART(void);
 extern void OSAL_TIMER_TICKSTOP(void);
 
+// 无滴答模式接口(OSAL_TICKLESS)
+extern uint32 OSAL_TIMER_ONESHOT(uint32 ms);
+extern uint32 OSAL_TIMER_RESUME(void);
+extern void OSAL_TIMER_SLEEP(void);
+
+// 抢占模式接口(OSAL_PREEMPT)，由最低优先级的软件中断(目标板为PendSV)调用osal_preempt_run()
+extern void OSAL_PREEMPT_INIT(void);
+extern void OSAL_PREEMPT_PEND(void);
+
+// 周期计数器接口，用于基准测试等性能测量，计数按OSAL_CYCLE_FREQ()的频率递增，32位回绕
+extern void OSAL_CYCLE_INIT(void);
+extern uint32 OSAL_CYCLE_COUNT(void);
+extern uint32 OSAL_CYCLE_FREQ(void);
+
 #endif
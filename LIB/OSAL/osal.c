@@ -1,10 +1,13 @@
 #include "osal.h"
 #include "osal_event.h"
 #include "osal_memory.h"
+#include "osal_msg.h"
+#include "osal_cpu.h"
+#include "timer.h"
 
 #include <string.h>
 
-osal_msg_q_t osal_qHead;
+osal_msg_q_t osal_qHead; // 通用消息队列，系统消息已改为按任务分队列，保留以兼容旧代码
 /*********************************************************************
  * @fn osal_init_system
  *
@@ -23,6 +26,7 @@ uint8 osal_init_system(void)
 
     // 初始化消息队列
     osal_qHead = NULL;
+    osal_msg_init();
 
 #if defined(OSAL_TOTAL_MEM)
     osal_msg_cnt = 0;
@@ -31,6 +35,18 @@ uint8 osal_init_system(void)
     osalTimerInit();
     osal_init_TaskHead();
 
+#ifdef OSAL_PT_ENABLE
+    osal_pt_scheduler_init(&osal_pt_sched); // 初始化协程调度器
+#endif
+
+#if OSAL_CPU_STATS
+    osal_cpu_init();
+#endif
+
+#if OSAL_PREEMPT
+    OSAL_PREEMPT_INIT();
+#endif
+
     return (ZSUCCESS);
 }
 
@@ -49,12 +65,11 @@ uint8 osal_init_system(void)
  */
 void osal_start_system(void)
 {
+    halIntState_t intState;
     uint16 events;
     uint16 retEvents;
-
-#ifdef OSAL_PT_ENABLE
-    osal_pt_scheduler_t sched;
-    osal_pt_scheduler_init(&sched); // 初始化协程调度器
+#if OSAL_CPU_STATS
+    uint32 cpuStart; // 调用任务事件处理函数前的周期计数
 #endif
 
     while (1)
@@ -62,29 +77,52 @@ void osal_start_system(void)
         TaskActive = osalNextActiveTask();
         if (TaskActive)
         {
-            HAL_ENTER_CRITICAL_SECTION();
+            HAL_ENTER_CRITICAL_SECTION(intState);
             events = TaskActive->events;
             // 清除此任务的事件标志
             TaskActive->events = 0;
-            HAL_EXIT_CRITICAL_SECTION();
+            osalReadyMask &= ~TaskActive->readyBit;
+            HAL_EXIT_CRITICAL_SECTION(intState);
 
             if (events != 0)
             {
                 // 调用任务处理事件
                 if (TaskActive->pfnEventProcessor)
                 {
+#if OSAL_CPU_STATS
+                    cpuStart = OSAL_CYCLE_COUNT();
+#endif
                     retEvents = (TaskActive->pfnEventProcessor)(TaskActive->taskID, events);
+#if OSAL_CPU_STATS
+                    osal_cpu_account(TaskActive->taskID, events, retEvents, cpuStart);
+#endif
 
                     // 将未处理完的事件重新添加回当前任务
-                    HAL_ENTER_CRITICAL_SECTION();
+                    HAL_ENTER_CRITICAL_SECTION(intState);
                     TaskActive->events |= retEvents;
-                    HAL_EXIT_CRITICAL_SECTION();
+                    if (TaskActive->events)
+                    {
+                        osalReadyMask |= TaskActive->readyBit;
+                    }
+                    HAL_EXIT_CRITICAL_SECTION(intState);
                 }
             }
         }
+#if OSAL_TICKLESS || OSAL_CPU_STATS
+        else
+        {
+#if OSAL_TICKLESS
+            // 没有就绪任务，睡眠到下一个定时器到期或有中断发生
+            osal_timer_idle();
+#endif
+#if OSAL_CPU_STATS
+            osal_cpu_idle();
+#endif
+        }
+#endif
 #ifdef OSAL_PT_ENABLE
         // 协程调度
-        osal_pt_schedule(&sched);
+        osal_pt_schedule(&osal_pt_sched);
 #endif
     }
 }
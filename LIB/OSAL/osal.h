@@ -16,6 +16,7 @@ typedef struct
     void *next;
     uint16 len;
     uint8 dest_id;
+    uint8 pool_id; // 所属消息池，OSAL_MSG_POOL_HEAP表示来自堆
 } osal_msg_hdr_t;
 
 typedef struct
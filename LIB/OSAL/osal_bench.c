@@ -0,0 +1,605 @@
+/****************************************************************************************
+ * 文件名  ：osal_bench.c
+ * 描述    ：OSAL基准测试，测量事件置位、事件分发、消息收发、定时器滴答与抖动、内存分配的耗时，
+ *           以及低优先级任务忙于事件处理时高优先级任务的响应延迟
+ * 说明    ：计时使用timer.c中的周期计数器(目标板为DWT CYCCNT，主机为单调时钟纳秒)，
+ *           结果以每行一个JSON对象的形式通过printf输出，耗时单位均为周期计数，
+ *           首行config给出计数频率与编译配置，便于在调整任务数、堆大小后比对。
+ ***************************************************************************************/
+#include <stdio.h>
+#include "osal_bench.h"
+#include "osal_event.h"
+#include "osal_timer.h"
+#include "osal_msg.h"
+#include "osal_memory.h"
+#include "timer.h"
+
+#if OSAL_BENCH
+
+#define SYS_EVENT_MSG       0x8000
+
+#define BENCH_EVT_NEXT      0x0001  //执行下一项测试
+#define BENCH_EVT_DISPATCH  0x0002  //分发延迟测试：置位探测任务事件
+#define BENCH_EVT_BUSY      0x0004  //抢占延迟测试：忙等并在中途置位高优先级任务事件
+
+#define PROBE_EVT_PING      0x0001  //分发延迟测试的探测事件
+#define PROBE_EVT_TIMER     0x0002  //定时抖动测试的周期定时器事件
+
+#define URGENT_EVT          0x0001  //抢占延迟测试的高优先级事件
+
+#define DUMMY_EVT           0x0001
+#define DUMMY_TIMER_EVTS    15      //每个空任务可用于定时器的事件数，SYS_EVENT_MSG除外
+#define BENCH_TICK_TIMERS   (OSAL_BENCH_TASKS * DUMMY_TIMER_EVTS)
+
+// 单项统计
+typedef struct
+{
+    uint32 n;
+    uint32 min;
+    uint32 max;
+    uint64_t sum;
+} osalBenchStat_t;
+
+enum
+{
+    BENCH_PHASE_CONFIG = 0,
+    BENCH_PHASE_SET_EVENT,
+    BENCH_PHASE_MSG,
+    BENCH_PHASE_MEM,
+    BENCH_PHASE_TICK,
+    BENCH_PHASE_DISPATCH,
+    BENCH_PHASE_PREEMPT,
+    BENCH_PHASE_JITTER,
+    BENCH_PHASE_DONE
+};
+
+static uint8 benchTaskId;
+static uint8 probeTaskId;
+static uint8 urgentTaskId;
+static uint8 dummyTaskId[OSAL_BENCH_TASKS];
+static uint8 dummyCnt;
+static uint8 benchPhase;
+static void (*benchDone)(void);
+
+static uint32 benchOverhead;        // 连续两次读取周期计数器的耗时，从每个采样中扣除
+static uint32 benchSeed;            // 伪随机数种子，固定初值保证每次运行的负载相同
+static uint32 benchStamp;           // 分发、抖动测试的上一时刻
+static osalBenchStat_t benchStat;   // 分发、抖动、抢占延迟测试的统计
+static uint8 benchBusyStop;         // 抢占延迟测试已采样完毕
+
+static void osalBenchStatReset(osalBenchStat_t *st)
+{
+    st->n = 0;
+    st->min = 0xFFFFFFFFU;
+    st->max = 0;
+    st->sum = 0;
+}
+
+static void osalBenchStatAdd(osalBenchStat_t *st, uint32 cycles)
+{
+    cycles = (cycles > benchOverhead) ? (cycles - benchOverhead) : 0;
+
+    st->n++;
+    st->sum += cycles;
+    if (st->min > cycles)
+    {
+        st->min = cycles;
+    }
+    if (st->max < cycles)
+    {
+        st->max = cycles;
+    }
+}
+
+//输出一项统计，key为附加参数名，为NULL时不输出附加参数
+static void osalBenchReport(const char *name, const char *key, uint32 value, const osalBenchStat_t *st)
+{
+    printf("{\"bench\":\"%s\"", name);
+    if (key)
+    {
+        printf(",\"%s\":%lu", key, (unsigned long)value);
+    }
+    printf(",\"n\":%lu,\"min\":%lu,\"avg\":%lu,\"max\":%lu}\n",
+           (unsigned long)st->n,
+           (unsigned long)(st->n ? st->min : 0),
+           (unsigned long)(st->n ? st->sum / st->n : 0),
+           (unsigned long)st->max);
+}
+
+static uint32 osalBenchRand(void)
+{
+    benchSeed = benchSeed * 1664525U + 1013904223U;
+    return benchSeed >> 8;
+}
+
+/*********************************************************************
+ * @fn osalBenchConfig
+ *
+ * @brief   校准计时开销并输出计数频率与编译配置。
+ */
+static void osalBenchConfig(void)
+{
+    uint32 t0, t1;
+    uint16 i;
+
+    OSAL_CYCLE_INIT();
+
+    benchOverhead = 0xFFFFFFFFU;
+    for (i = 0; i < 100; i++)
+    {
+        t0 = OSAL_CYCLE_COUNT();
+        t1 = OSAL_CYCLE_COUNT();
+        if (benchOverhead > t1 - t0)
+        {
+            benchOverhead = t1 - t0;
+        }
+    }
+
+    printf("{\"bench\":\"config\",\"cycle_hz\":%lu,\"overhead\":%lu,\"tasks\":%u,\"heap\":%lu,"
+           "\"tlsf\":%d,\"timer_wheel\":%d,\"tickless\":%d,\"msg_pool\":%d,\"preempt\":%d,\"iter\":%d}\n",
+           (unsigned long)OSAL_CYCLE_FREQ(), (unsigned long)benchOverhead, (unsigned)tasksCnt,
+           (unsigned long)MAXMEMHEAP, OSALMEM_TLSF, OSAL_TIMER_WHEEL, OSAL_TICKLESS,
+           OSAL_MSG_POOL, OSAL_PREEMPT, OSAL_BENCH_ITER);
+}
+
+/*********************************************************************
+ * @fn osalBenchSetEvent
+ *
+ * @brief   osal_set_event()与osal_isr_set_event()的单次耗时。
+ */
+static void osalBenchSetEvent(void)
+{
+    halIntState_t intState;
+    osalBenchStat_t st;
+    uint32 t0, t1;
+    uint16 i;
+
+    osalBenchStatReset(&st);
+    for (i = 0; i < OSAL_BENCH_ITER; i++)
+    {
+        HAL_ENTER_CRITICAL_SECTION(intState);
+        t0 = OSAL_CYCLE_COUNT();
+        osal_set_event(dummyTaskId[0], DUMMY_EVT);
+        t1 = OSAL_CYCLE_COUNT();
+        osal_clear_event(dummyTaskId[0], DUMMY_EVT);
+        HAL_EXIT_CRITICAL_SECTION(intState);
+        osalBenchStatAdd(&st, t1 - t0);
+    }
+    osalBenchReport("set_event", NULL, 0, &st);
+
+    osalBenchStatReset(&st);
+    for (i = 0; i < OSAL_BENCH_ITER; i++)
+    {
+        HAL_ENTER_CRITICAL_SECTION(intState);
+        t0 = OSAL_CYCLE_COUNT();
+        osal_isr_set_event(dummyTaskId[0], DUMMY_EVT);
+        t1 = OSAL_CYCLE_COUNT();
+        HAL_EXIT_CRITICAL_SECTION(intState);
+        osalBenchStatAdd(&st, t1 - t0);
+    }
+    osalBenchReport("isr_set_event", NULL, 0, &st);
+}
+
+/*********************************************************************
+ * @fn osalBenchMsg
+ *
+ * @brief   消息申请+发送、接收+释放的耗时与吞吐量，分别测试小、中、超出消息池的消息。
+ */
+static void osalBenchMsg(void)
+{
+    static const uint16 sizes[] = {8, 32, 128};
+    halIntState_t intState;
+    osalBenchStat_t send, recv;
+    uint8 *msg;
+    uint32 t0, t1;
+    uint16 i;
+    uint8 k;
+
+    for (k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++)
+    {
+        osalBenchStatReset(&send);
+        osalBenchStatReset(&recv);
+
+        for (i = 0; i < OSAL_BENCH_ITER; i++)
+        {
+            HAL_ENTER_CRITICAL_SECTION(intState);
+            t0 = OSAL_CYCLE_COUNT();
+            msg = osal_msg_allocate(sizes[k]);
+            if (msg)
+            {
+                osal_msg_send(benchTaskId, msg);
+            }
+            t1 = OSAL_CYCLE_COUNT();
+            HAL_EXIT_CRITICAL_SECTION(intState);
+            if (msg == NULL)
+            {
+                break;
+            }
+            osalBenchStatAdd(&send, t1 - t0);
+
+            HAL_ENTER_CRITICAL_SECTION(intState);
+            t0 = OSAL_CYCLE_COUNT();
+            msg = osal_msg_receive(benchTaskId);
+            osal_msg_deallocate(msg);
+            t1 = OSAL_CYCLE_COUNT();
+            HAL_EXIT_CRITICAL_SECTION(intState);
+            osalBenchStatAdd(&recv, t1 - t0);
+        }
+        osal_clear_event(benchTaskId, SYS_EVENT_MSG);
+
+        osalBenchReport("msg_send", "size", sizes[k], &send);
+        osalBenchReport("msg_receive", "size", sizes[k], &recv);
+        if (send.sum + recv.sum)
+        {
+            printf("{\"bench\":\"msg_throughput\",\"size\":%u,\"msgs_per_s\":%lu}\n", (unsigned)sizes[k],
+                   (unsigned long)((uint64_t)send.n * OSAL_CYCLE_FREQ() / (send.sum + recv.sum)));
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn osalBenchMem
+ *
+ * @brief   随机大小的申请、释放交替进行，测量单次耗时并在负载中途统计碎片。
+ */
+static void osalBenchMem(void)
+{
+    static void *slots[OSAL_BENCH_MEM_SLOTS];
+    halIntState_t intState;
+    osalBenchStat_t alloc, release;
+    uint32 t0, t1;
+    uint32 fail = 0;
+    uint16 size;
+    uint16 i;
+    uint8 k;
+
+    osalBenchStatReset(&alloc);
+    osalBenchStatReset(&release);
+    benchSeed = 1;
+
+    for (i = 0; i < OSAL_BENCH_ITER; i++)
+    {
+        k = osalBenchRand() % OSAL_BENCH_MEM_SLOTS;
+        HAL_ENTER_CRITICAL_SECTION(intState);
+        if (slots[k])
+        {
+            t0 = OSAL_CYCLE_COUNT();
+            osal_mem_free(slots[k]);
+            t1 = OSAL_CYCLE_COUNT();
+            HAL_EXIT_CRITICAL_SECTION(intState);
+            slots[k] = NULL;
+            osalBenchStatAdd(&release, t1 - t0);
+        }
+        else
+        {
+            size = 4 + osalBenchRand() % (OSAL_BENCH_MEM_MAX - 3);
+            t0 = OSAL_CYCLE_COUNT();
+            slots[k] = osal_mem_alloc(size);
+            t1 = OSAL_CYCLE_COUNT();
+            HAL_EXIT_CRITICAL_SECTION(intState);
+            osalBenchStatAdd(&alloc, t1 - t0);
+            if (slots[k] == NULL)
+            {
+                fail++;
+            }
+        }
+    }
+
+    osalBenchReport("mem_alloc", NULL, 0, &alloc);
+    osalBenchReport("mem_free", NULL, 0, &release);
+#if OSALMEM_METRICS
+    printf("{\"bench\":\"mem_frag\",\"used\":%lu,\"high_water\":%lu,\"largest_free\":%lu,\"alloc_fail\":%lu}\n",
+           (unsigned long)osal_heap_mem_used(), (unsigned long)osal_heap_high_water(),
+           (unsigned long)osal_heap_largest_free(), (unsigned long)fail);
+#endif
+
+    for (k = 0; k < OSAL_BENCH_MEM_SLOTS; k++)
+    {
+        if (slots[k])
+        {
+            osal_mem_free(slots[k]);
+            slots[k] = NULL;
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn osalBenchTick
+ *
+ * @brief   不同定时器数量下一次滴答处理(osalTimerUpdate(1))的耗时。
+ *          定时器超时时间远大于采样次数，测试期间不会到期。
+ */
+static void osalBenchTick(void)
+{
+    halIntState_t intState;
+    osalBenchStat_t st;
+    uint32 t0, t1;
+    uint16 count, n, i;
+
+    for (count = 1; ; count *= 4)
+    {
+        if (count > BENCH_TICK_TIMERS)
+        {
+            count = BENCH_TICK_TIMERS;
+        }
+
+        for (n = 0; n < count; n++)
+        {
+            osal_start_timerEx(dummyTaskId[n / DUMMY_TIMER_EVTS], (uint16)(1U << (n % DUMMY_TIMER_EVTS)), 60000);
+        }
+
+        osalBenchStatReset(&st);
+        for (i = 0; i < OSAL_BENCH_ITER / 10; i++)
+        {
+            HAL_ENTER_CRITICAL_SECTION(intState);
+            t0 = OSAL_CYCLE_COUNT();
+            osalTimerUpdate(1);
+            t1 = OSAL_CYCLE_COUNT();
+            HAL_EXIT_CRITICAL_SECTION(intState);
+            osalBenchStatAdd(&st, t1 - t0);
+        }
+        osalBenchReport("timer_tick", "timers", osal_timer_num_active(), &st);
+
+        for (n = 0; n < count; n++)
+        {
+            osal_stop_timerEx(dummyTaskId[n / DUMMY_TIMER_EVTS], (uint16)(1U << (n % DUMMY_TIMER_EVTS)));
+        }
+
+        if (count == BENCH_TICK_TIMERS)
+        {
+            break;
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn osalBenchBusy
+ *
+ * @brief   抢占延迟测试的低优先级负载：忙等OSAL_BENCH_BUSY_US微秒，
+ *          在忙等中途(每次位置不同)置位高优先级任务的事件。
+ *          不开抢占时高优先级任务要等本函数返回才能运行。
+ */
+static void osalBenchBusy(void)
+{
+    uint32 busy = (uint32)((uint64_t)OSAL_CYCLE_FREQ() * OSAL_BENCH_BUSY_US / 1000000U);
+    uint32 post = (uint32)((uint64_t)busy * ((benchStat.n * 37U) % 100U) / 100U);
+    uint32 start = OSAL_CYCLE_COUNT();
+    uint8 posted = FALSE;
+
+    while ((uint32)(OSAL_CYCLE_COUNT() - start) < busy)
+    {
+        if (!posted && ((uint32)(OSAL_CYCLE_COUNT() - start) >= post))
+        {
+            posted = TRUE;
+            benchStamp = OSAL_CYCLE_COUNT();
+            osal_set_event(urgentTaskId, URGENT_EVT);
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn osal_bench_init
+ *
+ * @brief   基准测试驱动任务初始化。
+ */
+static void osal_bench_init(uint8 task_id)
+{
+    benchTaskId = task_id;
+    benchPhase = BENCH_PHASE_CONFIG;
+    osal_set_event(benchTaskId, BENCH_EVT_NEXT);
+}
+
+/*********************************************************************
+ * @fn osal_bench_event_process
+ *
+ * @brief   基准测试驱动任务，每个事件执行一项测试。
+ */
+static uint16 osal_bench_event_process(uint8 task_id, uint16 task_event)
+{
+    uint8 *msg;
+
+    if (task_event & SYS_EVENT_MSG)
+    {
+        while ((msg = osal_msg_receive(task_id)) != NULL)
+        {
+            osal_msg_deallocate(msg);
+        }
+        return (task_event ^ SYS_EVENT_MSG);
+    }
+
+    if (task_event & BENCH_EVT_DISPATCH)
+    {
+        benchStamp = OSAL_CYCLE_COUNT();
+        osal_set_event(probeTaskId, PROBE_EVT_PING);
+        return (task_event ^ BENCH_EVT_DISPATCH);
+    }
+
+    if (task_event & BENCH_EVT_BUSY)
+    {
+        if (!benchBusyStop)
+        {
+            osalBenchBusy();
+            osal_set_event(benchTaskId, BENCH_EVT_BUSY);
+        }
+        return (task_event ^ BENCH_EVT_BUSY);
+    }
+
+    if (task_event & BENCH_EVT_NEXT)
+    {
+        switch (benchPhase++)
+        {
+        case BENCH_PHASE_CONFIG:
+            osalBenchConfig();
+            break;
+        case BENCH_PHASE_SET_EVENT:
+            osalBenchSetEvent();
+            break;
+        case BENCH_PHASE_MSG:
+            osalBenchMsg();
+            break;
+        case BENCH_PHASE_MEM:
+            osalBenchMem();
+            break;
+        case BENCH_PHASE_TICK:
+            osalBenchTick();
+            break;
+        case BENCH_PHASE_DISPATCH:
+            // 由探测任务计时，完成后再置位BENCH_EVT_NEXT
+            osalBenchStatReset(&benchStat);
+            osal_set_event(benchTaskId, BENCH_EVT_DISPATCH);
+            return (task_event ^ BENCH_EVT_NEXT);
+        case BENCH_PHASE_PREEMPT:
+            // 由高优先级任务计时，完成后再置位BENCH_EVT_NEXT
+            osalBenchStatReset(&benchStat);
+            benchBusyStop = FALSE;
+            osal_set_event(benchTaskId, BENCH_EVT_BUSY);
+            return (task_event ^ BENCH_EVT_NEXT);
+        case BENCH_PHASE_JITTER:
+            osalBenchStatReset(&benchStat);
+            benchStamp = OSAL_CYCLE_COUNT();
+            osal_start_reload_timer(probeTaskId, PROBE_EVT_TIMER, OSAL_BENCH_TIMER_PERIOD);
+            return (task_event ^ BENCH_EVT_NEXT);
+        default:
+            printf("{\"bench\":\"done\"}\n");
+            if (benchDone)
+            {
+                benchDone();
+            }
+            return (task_event ^ BENCH_EVT_NEXT);
+        }
+        osal_set_event(benchTaskId, BENCH_EVT_NEXT);
+        return (task_event ^ BENCH_EVT_NEXT);
+    }
+
+    return 0;
+}
+
+static void osal_bench_probe_init(uint8 task_id)
+{
+    probeTaskId = task_id;
+}
+
+/*********************************************************************
+ * @fn osal_bench_probe_event_process
+ *
+ * @brief   探测任务：记录事件从置位到进入处理函数的延迟，以及周期定时器的到期间隔。
+ */
+static uint16 osal_bench_probe_event_process(uint8 task_id, uint16 task_event)
+{
+    uint32 now = OSAL_CYCLE_COUNT();
+    uint32 expect, delta;
+
+    if (task_event & PROBE_EVT_PING)
+    {
+        osalBenchStatAdd(&benchStat, now - benchStamp);
+        if (benchStat.n < OSAL_BENCH_ITER)
+        {
+            osal_set_event(benchTaskId, BENCH_EVT_DISPATCH);
+        }
+        else
+        {
+            osalBenchReport("dispatch", NULL, 0, &benchStat);
+            osal_set_event(benchTaskId, BENCH_EVT_NEXT);
+        }
+        return (task_event ^ PROBE_EVT_PING);
+    }
+
+    if (task_event & PROBE_EVT_TIMER)
+    {
+        // 抖动为实际到期间隔与定时周期之差的绝对值，计时开销不参与
+        expect = (uint32)((uint64_t)OSAL_CYCLE_FREQ() * OSAL_BENCH_TIMER_PERIOD / 1000U);
+        delta = now - benchStamp;
+        benchStamp = now;
+        delta = (delta > expect) ? (delta - expect) : (expect - delta);
+        osalBenchStatAdd(&benchStat, delta + benchOverhead);
+
+        if (benchStat.n >= OSAL_BENCH_TIMER_SAMPLES)
+        {
+            osal_stop_timerEx(probeTaskId, PROBE_EVT_TIMER);
+            osalBenchReport("timer_jitter", "period_ms", OSAL_BENCH_TIMER_PERIOD, &benchStat);
+            osal_set_event(benchTaskId, BENCH_EVT_NEXT);
+        }
+        return (task_event ^ PROBE_EVT_TIMER);
+    }
+
+    return 0;
+}
+
+static void osal_bench_urgent_init(uint8 task_id)
+{
+    urgentTaskId = task_id;
+}
+
+/*********************************************************************
+ * @fn osal_bench_urgent_event_process
+ *
+ * @brief   高优先级任务：记录低优先级任务忙于事件处理时，本任务事件从置位到进入处理函数的延迟。
+ */
+static uint16 osal_bench_urgent_event_process(uint8 task_id, uint16 task_event)
+{
+    uint32 now = OSAL_CYCLE_COUNT();
+
+    if (task_event & URGENT_EVT)
+    {
+        if (!benchBusyStop)
+        {
+            osalBenchStatAdd(&benchStat, now - benchStamp);
+            if (benchStat.n >= OSAL_BENCH_TIMER_SAMPLES)
+            {
+                benchBusyStop = TRUE;
+                osalBenchReport("preempt_latency", "busy_us", OSAL_BENCH_BUSY_US, &benchStat);
+                osal_set_event(benchTaskId, BENCH_EVT_NEXT);
+            }
+        }
+        return (task_event ^ URGENT_EVT);
+    }
+
+    return 0;
+}
+
+static void osal_bench_dummy_init(uint8 task_id)
+{
+    dummyTaskId[dummyCnt++] = task_id;
+}
+
+static uint16 osal_bench_dummy_event_process(uint8 task_id, uint16 task_event)
+{
+    if (task_event & SYS_EVENT_MSG)
+    {
+        uint8 *msg;
+        while ((msg = osal_msg_receive(task_id)) != NULL)
+        {
+            osal_msg_deallocate(msg);
+        }
+    }
+    return 0;
+}
+
+/*********************************************************************
+ * @fn osal_bench_add_tasks
+ *
+ * @brief   添加基准测试任务，在osal_init_system()之后、osal_Task_init()之前调用。
+ *          添加驱动任务、探测任务、高优先级任务(OSAL_PREEMPT_PRIO)和OSAL_BENCH_TASKS个空任务，
+ *          测试完成后调用done(可为NULL)。
+ *
+ * @param   done - 测试完成回调
+ *
+ * @return  none
+ */
+void osal_bench_add_tasks(void (*done)(void))
+{
+    uint8 i;
+
+    benchDone = done;
+    dummyCnt = 0;
+
+    osal_add_Task(osal_bench_init, osal_bench_event_process, 1);
+    osal_add_Task(osal_bench_probe_init, osal_bench_probe_event_process, 1);
+    osal_add_Task(osal_bench_urgent_init, osal_bench_urgent_event_process, OSAL_PREEMPT_PRIO);
+    for (i = 0; i < OSAL_BENCH_TASKS; i++)
+    {
+        osal_add_Task(osal_bench_dummy_init, osal_bench_dummy_event_process, 1);
+    }
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef OSAL_BENCH_H
+#define OSAL_BENCH_H
+
+#include "osal.h"
+#include "type.h"
+
+#if !defined(OSAL_BENCH)
+#define OSAL_BENCH                  0       //定义为1则编译基准测试(osal_bench.c)
+#endif
+
+#if OSAL_BENCH
+#if !defined(OSAL_BENCH_ITER)
+#define OSAL_BENCH_ITER             1000    //每项测试的采样次数
+#endif
+#if !defined(OSAL_BENCH_TASKS)
+#define OSAL_BENCH_TASKS            4       //额外添加的空任务数量，模拟工程中的任务规模
+#endif
+#if !defined(OSAL_BENCH_TIMER_PERIOD)
+#define OSAL_BENCH_TIMER_PERIOD     10      //定时抖动测试的周期定时器周期，单位毫秒
+#endif
+#if !defined(OSAL_BENCH_TIMER_SAMPLES)
+#define OSAL_BENCH_TIMER_SAMPLES    100     //定时抖动测试的采样次数
+#endif
+#if !defined(OSAL_BENCH_BUSY_US)
+#define OSAL_BENCH_BUSY_US          5000    //抢占延迟测试中低优先级任务单次事件处理的忙等时间，单位微秒
+#endif
+#if !defined(OSAL_BENCH_MEM_SLOTS)
+#define OSAL_BENCH_MEM_SLOTS        32      //内存测试同时持有的最大块数
+#endif
+#if !defined(OSAL_BENCH_MEM_MAX)
+#define OSAL_BENCH_MEM_MAX          128     //内存测试随机申请的最大字节数
+#endif
+
+extern void osal_bench_add_tasks(void (*done)(void));
+#endif
+
+#endif
@@ -0,0 +1,348 @@
+/****************************************************************************************
+ * 文件名  ：osal_cpu.c
+ * 描述    ：任务CPU耗时统计，由osal_start_system()在每次调用任务事件处理函数前后计时
+ * 说明    ：计时使用timer.c中的周期计数器(目标板为DWT CYCCNT，主机为单调时钟纳秒)。
+ *           按事件统计时，一次调用的耗时计入本次处理掉的事件中最低的一位，
+ *           任务每次只处理一个事件并返回其余事件时(OSAL常规写法)统计是精确的。
+ ***************************************************************************************/
+#include <stdio.h>
+#include "osal_cpu.h"
+#include "osal_event.h"
+#include "osal_timer.h"
+#include "timer.h"
+
+#if OSAL_CPU_STATS
+
+static osalCpuStat_t cpuTask[OSAL_CPU_STATS_TASKS];       // 按任务ID索引
+#if OSAL_CPU_STATS_EVENTS
+static osalCpuStat_t cpuEvent[OSAL_CPU_STATS_TASKS][16];  // 按任务ID、事件位索引
+#endif
+static uint64_t cpuIdle;     // 没有任务运行的时间
+static uint64_t cpuElapsed;  // 自上次清零以来经过的时间
+static uint32 cpuStamp;      // 上次计入cpuElapsed的时刻
+#if OSAL_PREEMPT
+static uint32 cpuPreempted;  // 上次主循环统计以来抢占任务占用的时间，从被抢占的事件处理或空闲时间中扣除
+#endif
+
+//在stat中计入一次耗时
+static void osalCpuStatAdd(osalCpuStat_t *stat, uint32 cycles)
+{
+    stat->calls++;
+    stat->total += cycles;
+    if (stat->worst < cycles)
+    {
+        stat->worst = cycles;
+    }
+}
+
+//推进经过时间，返回当前时刻
+static uint32 osalCpuElapse(void)
+{
+    uint32 now = OSAL_CYCLE_COUNT();
+
+    cpuElapsed += (uint32)(now - cpuStamp);
+    cpuStamp = now;
+    return now;
+}
+
+#if OSAL_PREEMPT
+//取出并清零抢占任务占用的时间，不超过limit
+static uint32 osalCpuTakePreempted(uint32 limit)
+{
+    halIntState_t intState;
+    uint32 cycles;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    cycles = cpuPreempted;
+    cpuPreempted = 0;
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    return (cycles < limit) ? cycles : limit;
+}
+#endif
+
+//周期计数换算为微秒
+static unsigned long osalCpuUs(uint64_t cycles)
+{
+    return (unsigned long)(cycles * 1000000U / OSAL_CYCLE_FREQ());
+}
+
+/*********************************************************************
+ * @fn osal_cpu_init
+ *
+ * @brief   启动周期计数器并清零统计，由osal_init_system()调用。
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_cpu_init(void)
+{
+    OSAL_CYCLE_INIT();
+    osal_cpu_reset();
+}
+
+/*********************************************************************
+ * @fn osal_cpu_account
+ *
+ * @brief   记录一次任务事件处理的耗时。
+ *
+ * @param   task_id   - 任务ID
+ * @param   events    - 传给处理函数的事件
+ * @param   retEvents - 处理函数返回的未处理事件
+ * @param   start     - 调用处理函数前的周期计数
+ *
+ * @return  none
+ */
+void osal_cpu_account(uint8 task_id, uint16 events, uint16 retEvents, uint32 start)
+{
+    uint32 cycles = osalCpuElapse() - start;
+#if OSAL_CPU_STATS_EVENTS
+    uint32 done = events & ~retEvents;
+#endif
+
+#if OSAL_PREEMPT
+    cycles -= osalCpuTakePreempted(cycles);
+#endif
+
+    if (task_id >= OSAL_CPU_STATS_TASKS)
+    {
+        return;
+    }
+
+    osalCpuStatAdd(&cpuTask[task_id], cycles);
+
+#if OSAL_CPU_STATS_EVENTS
+    if (done)
+    {
+        osalCpuStatAdd(&cpuEvent[task_id][31 - __CLZ(done & (~done + 1))], cycles);
+    }
+#endif
+}
+
+/*********************************************************************
+ * @fn osal_cpu_idle
+ *
+ * @brief   主循环没有任务可运行(含无滴答模式的睡眠)时调用，
+ *          自上次统计以来的时间全部计为空闲，主循环不必另外读取计数器。
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_cpu_idle(void)
+{
+    uint32 last = cpuStamp;
+    uint32 cycles = osalCpuElapse() - last;
+
+#if OSAL_PREEMPT
+    cycles -= osalCpuTakePreempted(cycles);
+#endif
+    cpuIdle += cycles;
+}
+
+#if OSAL_PREEMPT
+/*********************************************************************
+ * @fn osal_cpu_account_preempt
+ *
+ * @brief   记录一次抢占任务事件处理的耗时，由osal_preempt_run()调用。
+ *          耗时同时记入cpuPreempted，主循环下一次统计时从被抢占的部分中扣除。
+ *
+ * @param   task_id   - 任务ID
+ * @param   events    - 传给处理函数的事件
+ * @param   retEvents - 处理函数返回的未处理事件
+ * @param   start     - 调用处理函数前的周期计数
+ *
+ * @return  none
+ */
+void osal_cpu_account_preempt(uint8 task_id, uint16 events, uint16 retEvents, uint32 start)
+{
+    uint32 cycles = OSAL_CYCLE_COUNT() - start;
+#if OSAL_CPU_STATS_EVENTS
+    uint32 done = events & ~retEvents;
+#endif
+
+    cpuPreempted += cycles;
+
+    if (task_id >= OSAL_CPU_STATS_TASKS)
+    {
+        return;
+    }
+
+    osalCpuStatAdd(&cpuTask[task_id], cycles);
+
+#if OSAL_CPU_STATS_EVENTS
+    if (done)
+    {
+        osalCpuStatAdd(&cpuEvent[task_id][31 - __CLZ(done & (~done + 1))], cycles);
+    }
+#endif
+}
+#endif
+
+/*********************************************************************
+ * @fn osal_cpu_task_stat
+ *
+ * @brief   读取任务的耗时统计。
+ *
+ * @param   task_id - 任务ID
+ * @param   stat    - 输出的统计
+ *
+ * @return  SUCCESS, INVALID_TASK
+ */
+uint8 osal_cpu_task_stat(uint8 task_id, osalCpuStat_t *stat)
+{
+    if (task_id >= OSAL_CPU_STATS_TASKS)
+    {
+        return (INVALID_TASK);
+    }
+
+    *stat = cpuTask[task_id];
+    return (SUCCESS);
+}
+
+/*********************************************************************
+ * @fn osal_cpu_event_stat
+ *
+ * @brief   读取任务某一事件的耗时统计。
+ *
+ * @param   task_id   - 任务ID
+ * @param   event_bit - 事件位号(0-15)
+ * @param   stat      - 输出的统计
+ *
+ * @return  SUCCESS, INVALID_TASK, INVALID_EVENT_ID
+ */
+uint8 osal_cpu_event_stat(uint8 task_id, uint8 event_bit, osalCpuStat_t *stat)
+{
+    if (task_id >= OSAL_CPU_STATS_TASKS)
+    {
+        return (INVALID_TASK);
+    }
+
+#if OSAL_CPU_STATS_EVENTS
+    if (event_bit < 16)
+    {
+        *stat = cpuEvent[task_id][event_bit];
+        return (SUCCESS);
+    }
+#endif
+    return (INVALID_EVENT_ID);
+}
+
+//没有任务运行的累计周期计数
+uint64_t osal_cpu_idle_cycles(void)
+{
+    return cpuIdle;
+}
+
+//自上次清零以来经过的周期计数
+uint64_t osal_cpu_elapsed_cycles(void)
+{
+    osalCpuElapse();
+    return cpuElapsed;
+}
+
+/*********************************************************************
+ * @fn osal_cpu_reset
+ *
+ * @brief   清零全部统计，开始新的统计窗口。
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_cpu_reset(void)
+{
+    osal_memset(cpuTask, 0, sizeof(cpuTask));
+#if OSAL_CPU_STATS_EVENTS
+    osal_memset(cpuEvent, 0, sizeof(cpuEvent));
+#endif
+    cpuIdle = 0;
+    cpuElapsed = 0;
+#if OSAL_PREEMPT
+    cpuPreempted = 0;
+#endif
+    cpuStamp = OSAL_CYCLE_COUNT();
+}
+
+/*********************************************************************
+ * @fn osal_cpu_dump
+ *
+ * @brief   以每行一个JSON对象的形式输出统计，时间单位为微秒，负载单位为千分比。
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_cpu_dump(void)
+{
+    uint64_t elapsed = osal_cpu_elapsed_cycles();
+    uint8 id;
+#if OSAL_CPU_STATS_EVENTS
+    uint8 bit;
+    osalCpuStat_t *ev;
+#endif
+
+    if (elapsed == 0)
+    {
+        return;
+    }
+
+    printf("{\"cpu\":\"window\",\"time\":%lu,\"clock\":%lu,\"idle\":%lu,\"idle_pm\":%lu}\n",
+           osalCpuUs(elapsed), (unsigned long)osal_GetSystemClock(), osalCpuUs(cpuIdle),
+           (unsigned long)(cpuIdle * 1000U / elapsed));
+
+    for (id = 0; (id < tasksCnt) && (id < OSAL_CPU_STATS_TASKS); id++)
+    {
+        if (cpuTask[id].calls == 0)
+        {
+            continue;
+        }
+
+        printf("{\"cpu\":\"task\",\"id\":%u,\"calls\":%lu,\"total\":%lu,\"worst\":%lu,\"load_pm\":%lu}\n",
+               (unsigned)id, (unsigned long)cpuTask[id].calls, osalCpuUs(cpuTask[id].total),
+               osalCpuUs(cpuTask[id].worst), (unsigned long)(cpuTask[id].total * 1000U / elapsed));
+
+#if OSAL_CPU_STATS_EVENTS
+        for (bit = 0; bit < 16; bit++)
+        {
+            ev = &cpuEvent[id][bit];
+            if (ev->calls)
+            {
+                printf("{\"cpu\":\"event\",\"id\":%u,\"event\":%u,\"calls\":%lu,\"total\":%lu,\"worst\":%lu}\n",
+                       (unsigned)id, (unsigned)(1U << bit), (unsigned long)ev->calls,
+                       osalCpuUs(ev->total), osalCpuUs(ev->worst));
+            }
+        }
+#endif
+    }
+}
+
+/*********************************************************************
+ * @fn osal_cpu_dump_init
+ *
+ * @brief   统计输出任务初始化，每OSAL_CPU_DUMP_PERIOD毫秒输出一次统计并开始新的统计窗口。
+ *          用法：osal_add_Task(osal_cpu_dump_init, osal_cpu_dump_event_process, 0);
+ *
+ * @param   task_id - 任务ID
+ *
+ * @return  none
+ */
+void osal_cpu_dump_init(uint8 task_id)
+{
+    osal_start_reload_timer(task_id, OSAL_CPU_DUMP_EVENT, OSAL_CPU_DUMP_PERIOD);
+}
+
+uint16 osal_cpu_dump_event_process(uint8 task_id, uint16 task_event)
+{
+    if (task_event & OSAL_CPU_DUMP_EVENT)
+    {
+        osal_cpu_dump();
+        osal_cpu_reset();
+        return (task_event ^ OSAL_CPU_DUMP_EVENT);
+    }
+
+    return 0;
+}
+
+#endif
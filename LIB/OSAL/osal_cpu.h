@@ -0,0 +1,49 @@
+#ifndef OSAL_CPU_H
+#define OSAL_CPU_H
+
+#include "osal.h"
+#include "osal_event.h"
+#include "type.h"
+
+#if !defined(OSAL_CPU_STATS)
+#define OSAL_CPU_STATS              0       //定义为1则统计各任务、各事件的处理耗时和空闲时间(osal_cpu.c)
+#endif
+
+#if OSAL_CPU_STATS
+#if !defined(OSAL_CPU_STATS_TASKS)
+#define OSAL_CPU_STATS_TASKS        8       //参与统计的任务数，任务ID小于该值的任务参与统计
+#endif
+#if !defined(OSAL_CPU_STATS_EVENTS)
+#define OSAL_CPU_STATS_EVENTS       1       //定义为1则同时按事件统计，每个任务占用16项
+#endif
+#if !defined(OSAL_CPU_DUMP_PERIOD)
+#define OSAL_CPU_DUMP_PERIOD        1000    //统计输出任务的输出周期，单位毫秒
+#endif
+
+#define OSAL_CPU_DUMP_EVENT         0x0001  //统计输出任务的定时输出事件
+
+// 耗时统计，单位为周期计数(OSAL_CYCLE_FREQ())
+typedef struct
+{
+    uint32 calls;   //调用次数
+    uint32 worst;   //单次最长耗时
+    uint64_t total; //累计耗时
+} osalCpuStat_t;
+
+extern void osal_cpu_init(void);
+extern void osal_cpu_account(uint8 task_id, uint16 events, uint16 retEvents, uint32 start);
+extern void osal_cpu_idle(void);
+#if OSAL_PREEMPT
+extern void osal_cpu_account_preempt(uint8 task_id, uint16 events, uint16 retEvents, uint32 start);
+#endif
+extern uint8 osal_cpu_task_stat(uint8 task_id, osalCpuStat_t *stat);
+extern uint8 osal_cpu_event_stat(uint8 task_id, uint8 event_bit, osalCpuStat_t *stat);
+extern uint64_t osal_cpu_idle_cycles(void);
+extern uint64_t osal_cpu_elapsed_cycles(void);
+extern void osal_cpu_reset(void);
+extern void osal_cpu_dump(void);
+extern void osal_cpu_dump_init(uint8 task_id);
+extern uint16 osal_cpu_dump_event_process(uint8 task_id, uint16 task_event);
+#endif
+
+#endif
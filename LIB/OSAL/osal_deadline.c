@@ -0,0 +1,420 @@
+/****************************************************************************************
+ * 文件名  ：osal_deadline.c
+ * 描述    ：绝对时刻定时器，按32位绝对到期时刻管理，周期定时器从上一次的到期时刻累加重载，
+ *           滴答处理延后也不会累积相位误差
+ * 说明    ：时刻比较按有符号差值进行，32位回绕后仍然正确，到期时刻与当前时刻相差不能超过2^31个单位
+ *           (毫秒单位约24天，微秒单位约35分钟)。到期检查在每个系统滴答中进行，
+ *           微秒单位提高的是周期和时刻的表示精度(如400Hz的2500us周期)，事件仍在滴答中发出。
+ ***************************************************************************************/
+#include "osal_deadline.h"
+#include "osal_event.h"
+#include "osal_timer.h"
+#include "timer.h"
+
+#if OSAL_DEADLINE_TIMER
+
+typedef struct osalDeadlineRec
+{
+    struct osalDeadlineRec *next;
+    uint32 deadline; // 到期时刻
+    uint32 period;   // 重载周期，0表示单次定时
+    uint16 overruns; // 因滴答延后而跳过的周期数，在0xFFFF饱和
+    uint16 event_flag;
+    uint8 task_id;
+    uint8 used;
+} osalDeadlineRec_t;
+
+static osalDeadlineRec_t dlPool[OSAL_DEADLINE_TIMERS]; // 定时器静态池
+static osalDeadlineRec_t *dlHead;                      // 按到期时刻升序排列的活动定时器链表
+
+#if OSAL_DEADLINE_US
+static uint32 dlCycleLast; // 上次换算时的周期计数
+static uint32 dlCycleRem;  // 不足1微秒的周期数
+static uint32 dlUs;        // 微秒时钟
+#endif
+
+// a是否不早于b，按有符号差值比较
+#define DEADLINE_REACHED(a, b) ((int32)((a) - (b)) >= 0)
+
+//按到期时刻插入链表，相同到期时刻的按先后顺序排列，调用者需关中断
+static void osalDeadlineLink(osalDeadlineRec_t *tmr)
+{
+    osalDeadlineRec_t **link = &dlHead;
+
+    while ((*link != NULL) && DEADLINE_REACHED(tmr->deadline, (*link)->deadline))
+    {
+        link = &(*link)->next;
+    }
+
+    tmr->next = *link;
+    *link = tmr;
+}
+
+//从链表中摘除，调用者需关中断
+static void osalDeadlineUnlink(osalDeadlineRec_t *tmr)
+{
+    osalDeadlineRec_t **link = &dlHead;
+
+    while ((*link != NULL) && (*link != tmr))
+    {
+        link = &(*link)->next;
+    }
+
+    if (*link)
+    {
+        *link = tmr->next;
+    }
+    tmr->next = NULL;
+}
+
+//查找定时器，调用者需关中断
+static osalDeadlineRec_t *osalDeadlineFind(uint8 task_id, uint16 event_flag)
+{
+    uint8 i;
+
+    for (i = 0; i < OSAL_DEADLINE_TIMERS; i++)
+    {
+        if (dlPool[i].used && (dlPool[i].task_id == task_id) && (dlPool[i].event_flag == event_flag))
+        {
+            return &dlPool[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*********************************************************************
+ * @fn osal_deadline_init
+ *
+ * @brief   初始化绝对时刻定时器，由osalTimerInit()调用。
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_deadline_init(void)
+{
+    osal_memset(dlPool, 0, sizeof(dlPool));
+    dlHead = NULL;
+
+#if OSAL_DEADLINE_US
+    OSAL_CYCLE_INIT();
+    dlCycleLast = OSAL_CYCLE_COUNT();
+    dlCycleRem = 0;
+    dlUs = 0;
+#endif
+}
+
+/*********************************************************************
+ * @fn osal_deadline_now
+ *
+ * @brief   读取绝对时刻定时器的当前时刻。
+ *          微秒单位时由周期计数器的增量换算累加，周期计数器一圈内至少要调用一次，
+ *          每个系统滴答中都会调用，无滴答模式的单次睡眠时长也不超过一圈。
+ *
+ * @param   none
+ *
+ * @return  当前时刻(毫秒或微秒)
+ */
+uint32 osal_deadline_now(void)
+{
+#if OSAL_DEADLINE_US
+    halIntState_t intState;
+    uint32 now;
+    uint32 delta;
+    uint32 perUs = OSAL_CYCLE_FREQ() / 1000000U;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+
+    now = OSAL_CYCLE_COUNT();
+    delta = now - dlCycleLast;
+    dlCycleLast = now;
+
+    dlUs += delta / perUs;
+    dlCycleRem += delta % perUs;
+    if (dlCycleRem >= perUs)
+    {
+        dlCycleRem -= perUs;
+        dlUs++;
+    }
+    now = dlUs;
+
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    return now;
+#else
+    return osal_GetSystemClock();
+#endif
+}
+
+/*********************************************************************
+ * @fn osal_start_deadline_timer
+ *
+ * @brief   启动一个在绝对时刻deadline到期的定时器，已存在则重新设定。
+ *          period不为0时为周期定时器，每次到期后下一次到期时刻为上一次到期时刻加period。
+ *
+ * @param   task_id  - 任务ID
+ * @param   event_id - 到期时通知的事件
+ * @param   deadline - 到期时刻(与osal_deadline_now()同单位)，已过去时在下一个滴答到期
+ * @param   period   - 重载周期，0表示单次定时
+ *
+ * @return  SUCCESS, 或 NO_TIMER_AVAIL
+ */
+uint8 osal_start_deadline_timer(uint8 task_id, uint16 event_id, uint32 deadline, uint32 period)
+{
+    halIntState_t intState;
+    osalDeadlineRec_t *tmr;
+    uint8 i;
+
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
+
+    tmr = osalDeadlineFind(task_id, event_id);
+    if (tmr)
+    {
+        osalDeadlineUnlink(tmr);
+    }
+    else
+    {
+        for (i = 0; i < OSAL_DEADLINE_TIMERS; i++)
+        {
+            if (!dlPool[i].used)
+            {
+                tmr = &dlPool[i];
+                tmr->used = TRUE;
+                tmr->task_id = task_id;
+                tmr->event_flag = event_id;
+                break;
+            }
+        }
+    }
+
+    if (tmr)
+    {
+        tmr->deadline = deadline;
+        tmr->period = period;
+        tmr->overruns = 0;
+        osalDeadlineLink(tmr);
+    }
+
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+
+    return ((tmr != NULL) ? SUCCESS : NO_TIMER_AVAIL);
+}
+
+/*********************************************************************
+ * @fn osal_start_periodic_timer
+ *
+ * @brief   启动一个从当前时刻起每period到期一次的周期定时器。
+ *
+ * @param   task_id  - 任务ID
+ * @param   event_id - 到期时通知的事件
+ * @param   period   - 周期(与osal_deadline_now()同单位)，不能为0
+ *
+ * @return  SUCCESS, INVALID_EVENT_ID, 或 NO_TIMER_AVAIL
+ */
+uint8 osal_start_periodic_timer(uint8 task_id, uint16 event_id, uint32 period)
+{
+    if (period == 0)
+    {
+        return (INVALID_EVENT_ID);
+    }
+
+    return osal_start_deadline_timer(task_id, event_id, osal_deadline_now() + period, period);
+}
+
+/*********************************************************************
+ * @fn osal_stop_deadline_timer
+ *
+ * @brief   停止绝对时刻定时器。
+ *
+ * @param   task_id  - 任务ID
+ * @param   event_id - 定时器事件
+ *
+ * @return  SUCCESS 或 INVALID_EVENT_ID
+ */
+uint8 osal_stop_deadline_timer(uint8 task_id, uint16 event_id)
+{
+    halIntState_t intState;
+    osalDeadlineRec_t *tmr;
+
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
+
+    tmr = osalDeadlineFind(task_id, event_id);
+    if (tmr)
+    {
+        osalDeadlineUnlink(tmr);
+        tmr->used = FALSE;
+    }
+
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+
+    return ((tmr != NULL) ? SUCCESS : INVALID_EVENT_ID);
+}
+
+/*********************************************************************
+ * @fn osal_get_deadline
+ *
+ * @brief   读取定时器下一次的到期时刻。周期定时器的事件处理中，
+ *          减去周期即为本次事件的标称时刻，可用作采样时间戳。
+ *
+ * @param   task_id  - 任务ID
+ * @param   event_id - 定时器事件
+ * @param   deadline - 输出的到期时刻
+ *
+ * @return  SUCCESS 或 INVALID_EVENT_ID
+ */
+uint8 osal_get_deadline(uint8 task_id, uint16 event_id, uint32 *deadline)
+{
+    halIntState_t intState;
+    osalDeadlineRec_t *tmr;
+
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
+
+    tmr = osalDeadlineFind(task_id, event_id);
+    if (tmr)
+    {
+        *deadline = tmr->deadline;
+    }
+
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+
+    return ((tmr != NULL) ? SUCCESS : INVALID_EVENT_ID);
+}
+
+/*********************************************************************
+ * @fn osal_deadline_overruns
+ *
+ * @brief   读取周期定时器因滴答延后超过一个周期而跳过的周期数，在0xFFFF饱和，
+ *          重新启动定时器时清零。
+ *
+ * @param   task_id  - 任务ID
+ * @param   event_id - 定时器事件
+ *
+ * @return  跳过的周期数(最大0xFFFF)，定时器不存在时返回0
+ */
+uint16 osal_deadline_overruns(uint8 task_id, uint16 event_id)
+{
+    halIntState_t intState;
+    osalDeadlineRec_t *tmr;
+    uint16 overruns = 0;
+
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
+
+    tmr = osalDeadlineFind(task_id, event_id);
+    if (tmr)
+    {
+        overruns = tmr->overruns;
+    }
+
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+
+    return overruns;
+}
+
+/*********************************************************************
+ * @fn osal_deadline_update
+ *
+ * @brief   处理到期的定时器，由osalTimerUpdate()在每次滴答更新后调用。
+ *          链表按到期时刻排序，只需检查表头。周期定时器从上一次的到期时刻重载，
+ *          滴答延后超过整个周期时跳过错过的周期，保持原有相位。
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_deadline_update(void)
+{
+    halIntState_t intState;
+    osalDeadlineRec_t *tmr;
+    uint32 now = osal_deadline_now();
+    uint32 missed;
+    uint16 event_flag;
+    uint8 task_id;
+
+    while (1)
+    {
+        HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
+
+        tmr = dlHead;
+        if ((tmr == NULL) || !DEADLINE_REACHED(now, tmr->deadline))
+        {
+            HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+            break;
+        }
+
+        dlHead = tmr->next;
+        task_id = tmr->task_id;
+        event_flag = tmr->event_flag;
+
+        if (tmr->period)
+        {
+            // 从上一次的到期时刻重载，不受本次处理延后的影响
+            tmr->deadline += tmr->period;
+            if (DEADLINE_REACHED(now, tmr->deadline))
+            {
+                missed = (now - tmr->deadline) / tmr->period + 1;
+                tmr->deadline += missed * tmr->period;
+                // 计数饱和，不回绕为较小的值
+                if (missed >= (uint32)(0xFFFFU - tmr->overruns))
+                {
+                    tmr->overruns = 0xFFFF;
+                }
+                else
+                {
+                    tmr->overruns += (uint16)missed;
+                }
+            }
+            osalDeadlineLink(tmr);
+        }
+        else
+        {
+            tmr->used = FALSE;
+        }
+
+        HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+
+        // 通知任务超时
+        osal_set_event(task_id, event_flag);
+    }
+}
+
+/*********************************************************************
+ * @fn osal_deadline_next_timeout
+ *
+ * @brief   计算距最早的绝对时刻定时器到期还有多少毫秒，供无滴答模式决定睡眠时长。
+ *
+ * @param   none
+ *
+ * @return  毫秒数(向上取整)，已到期时返回1，没有活动定时器时返回0
+ */
+uint32 osal_deadline_next_timeout(void)
+{
+    halIntState_t intState;
+    uint32 now = osal_deadline_now();
+    int32 remain = 0;
+    uint8 active;
+
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
+    active = (dlHead != NULL);
+    if (active)
+    {
+        remain = (int32)(dlHead->deadline - now);
+    }
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+
+    if (!active)
+    {
+        return 0;
+    }
+    if (remain <= 0)
+    {
+        return 1;
+    }
+#if OSAL_DEADLINE_US
+    return ((uint32)remain + 999U) / 1000U;
+#else
+    return (uint32)remain;
+#endif
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef OSAL_DEADLINE_H
+#define OSAL_DEADLINE_H
+
+#include "osal.h"
+#include "type.h"
+
+#if !defined(OSAL_DEADLINE_TIMER)
+#define OSAL_DEADLINE_TIMER         0       //定义为1则编译绝对时刻定时器(osal_deadline.c)
+#endif
+
+#if OSAL_DEADLINE_TIMER
+#if !defined(OSAL_DEADLINE_TIMERS)
+#define OSAL_DEADLINE_TIMERS        8       //绝对时刻定时器静态池大小
+#endif
+#if !defined(OSAL_DEADLINE_US)
+#define OSAL_DEADLINE_US            0       //0：时间单位为毫秒(系统时钟)；1：时间单位为微秒(由周期计数器换算)
+#endif
+
+extern void osal_deadline_init(void);
+extern uint32 osal_deadline_now(void);
+extern uint8 osal_start_deadline_timer(uint8 task_id, uint16 event_id, uint32 deadline, uint32 period);
+extern uint8 osal_start_periodic_timer(uint8 task_id, uint16 event_id, uint32 period);
+extern uint8 osal_stop_deadline_timer(uint8 task_id, uint16 event_id);
+extern uint8 osal_get_deadline(uint8 task_id, uint16 event_id, uint32 *deadline);
+extern uint16 osal_deadline_overruns(uint8 task_id, uint16 event_id);
+extern void osal_deadline_update(void);
+extern uint32 osal_deadline_next_timeout(void);
+#endif
+
+#endif
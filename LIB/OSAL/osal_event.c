@@ -1,8 +1,20 @@
 #include "osal_event.h"
 #include "osal_memory.h"
+#include "osal_cpu.h"
 
 OsalTadkREC_t *TaskHead;
 OsalTadkREC_t *TaskActive;
+uint32 osalReadyMask; // 就绪位图，按优先级排位，最高优先级任务对应最高位
+#if OSAL_PREEMPT
+uint32 osalPreemptMask;       // 抢占任务的就绪位，抢占任务优先级最高，占就绪位图的高位
+static uint32 osalPreemptIds; // 抢占任务，按任务ID置位
+#endif
+
+static OsalTadkREC_t *osalTaskTable[OSAL_MAX_TASKS]; // 按任务ID索引的任务表
+static OsalTadkREC_t *osalTaskRank[OSAL_MAX_TASKS];  // 按优先级排位索引的任务表
+
+static halAtomic_t osalIsrEvents[OSAL_MAX_TASKS]; // 中断中置位、尚未并入任务的事件，按任务ID索引
+static halAtomic_t osalIsrPending;                // 有待并入事件的任务，按任务ID置位
 
 uint8 Task_id;  // 任务ID统计
 uint8 tasksCnt; // 任务数量统计
@@ -21,17 +33,29 @@ uint8 tasksCnt; // 任务数量统计
  */
 uint8 osal_set_event(byte task_id, uint16 event_flag)
 {
+    halIntState_t intState;
     OsalTadkREC_t *srchTask;
 
     srchTask = osalFindTask(task_id);
     if (srchTask)
     {
         // 关闭中断
-        HAL_ENTER_CRITICAL_SECTION();
-        // 设置事件位
+        HAL_ENTER_CRITICAL_SECTION(intState);
+        // 设置事件位并标记任务就绪
         srchTask->events |= event_flag;
+        if (srchTask->events)
+        {
+            osalReadyMask |= srchTask->readyBit;
+        }
+#if OSAL_PREEMPT
+        // 抢占任务由PendSV执行，开中断后立即抢占当前的事件处理
+        if (srchTask->readyBit & osalPreemptMask)
+        {
+            OSAL_PREEMPT_PEND();
+        }
+#endif
         // 恢复中断
-        HAL_EXIT_CRITICAL_SECTION();
+        HAL_EXIT_CRITICAL_SECTION(intState);
     }
     else
         return (INVALID_TASK);
@@ -39,6 +63,71 @@ uint8 osal_set_event(byte task_id, uint16 event_flag)
     return (ZSUCCESS);
 }
 
+/*********************************************************************
+ * @fn osal_isr_set_event
+ *
+ * @brief
+ *
+ *    供中断使用的置事件接口。事件位通过原子操作记入待并入表，不关闭中断、
+ *    不查找任务链表；主循环在选择下一个就绪任务时把它们并入任务事件。
+ *    任务上下文中仍应使用osal_set_event。
+ *
+ * @param   uint8 task_id - 接收任务的ID
+ * @param   uint16 event_flag - 要设置的事件
+ *
+ * @return  ZSUCCESS, INVALID_TASK
+ */
+uint8 osal_isr_set_event(uint8 task_id, uint16 event_flag)
+{
+    if (task_id >= Task_id)
+    {
+        return (INVALID_TASK);
+    }
+
+    // 先记事件再标记任务，并入时先取标记再取事件，事件不会丢失
+    halAtomicOr(&osalIsrEvents[task_id], event_flag);
+    halAtomicOr(&osalIsrPending, 1UL << task_id);
+
+#if OSAL_PREEMPT
+    // 抢占任务的事件由PendSV并入，不必等主循环
+    if (osalPreemptIds & (1UL << task_id))
+    {
+        OSAL_PREEMPT_PEND();
+    }
+#endif
+
+    return (ZSUCCESS);
+}
+
+/*********************************************************************
+ * @fn osalIsrEventsMerge
+ *
+ * @brief   把中断中置位的事件并入各任务的事件变量。
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void osalIsrEventsMerge(void)
+{
+    uint32 pending;
+    uint32 events;
+    uint8 id;
+
+    pending = halAtomicXchg(&osalIsrPending, 0);
+    while (pending)
+    {
+        id = (uint8)(31 - __CLZ(pending));
+        pending &= ~(1UL << id);
+
+        events = halAtomicXchg(&osalIsrEvents[id], 0);
+        if (events)
+        {
+            osal_set_event(id, (uint16)events);
+        }
+    }
+}
+
 /*********************************************************************
  * @fn osal_clear_event
  *
@@ -53,17 +142,22 @@ uint8 osal_set_event(byte task_id, uint16 event_flag)
  */
 uint8 osal_clear_event(uint8 task_id, uint16 event_flag)
 {
+    halIntState_t intState;
     OsalTadkREC_t *srchTask;
 
     srchTask = osalFindTask(task_id);
     if (srchTask)
     {
         // 关闭中断
-        HAL_ENTER_CRITICAL_SECTION();
-        // 清除事件位
+        HAL_ENTER_CRITICAL_SECTION(intState);
+        // 清除事件位，事件全部清除后任务不再就绪
         srchTask->events &= ~event_flag;
+        if (srchTask->events == 0)
+        {
+            osalReadyMask &= ~srchTask->readyBit;
+        }
         // 恢复中断
-        HAL_EXIT_CRITICAL_SECTION();
+        HAL_EXIT_CRITICAL_SECTION(intState);
     }
     else
         return (INVALID_TASK);
@@ -85,6 +179,55 @@ void osal_init_TaskHead(void)
     TaskHead = (OsalTadkREC_t *)NULL;
     TaskActive = (OsalTadkREC_t *)NULL;
     Task_id = 0;
+    osalReadyMask = 0;
+    osalIsrPending = 0;
+#if OSAL_PREEMPT
+    osalPreemptMask = 0;
+    osalPreemptIds = 0;
+#endif
+}
+
+/***************************************************************************
+ * @fn osalRankTasks
+ *
+ * @brief   按任务链表的优先级顺序重新分配就绪位，并按事件重建就绪位图。
+ *          只在添加任务时调用，调度和置事件时不再需要遍历链表。
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void osalRankTasks(void)
+{
+    halIntState_t intState;
+    OsalTadkREC_t *TaskSech;
+    uint8 rank = 0;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+
+    osalReadyMask = 0;
+#if OSAL_PREEMPT
+    osalPreemptMask = 0;
+    osalPreemptIds = 0;
+#endif
+    for (TaskSech = TaskHead; TaskSech; TaskSech = TaskSech->next)
+    {
+        TaskSech->readyBit = 0x80000000UL >> rank;
+        osalTaskRank[rank++] = TaskSech;
+        if (TaskSech->events)
+        {
+            osalReadyMask |= TaskSech->readyBit;
+        }
+#if OSAL_PREEMPT
+        if (TaskSech->taskPriority >= OSAL_PREEMPT_PRIO)
+        {
+            osalPreemptMask |= TaskSech->readyBit;
+            osalPreemptIds |= 1UL << TaskSech->taskID;
+        }
+#endif
+    }
+
+    HAL_EXIT_CRITICAL_SECTION(intState);
 }
 
 /***************************************************************************
@@ -128,6 +271,13 @@ void osal_add_Task(pTaskInitFn pfnInit,
     OsalTadkREC_t *TaskNew;
     OsalTadkREC_t *TaskSech;
     OsalTadkREC_t **TaskPTR;
+
+    // 任务表已满
+    if (Task_id >= OSAL_MAX_TASKS)
+    {
+        return;
+    }
+
     TaskNew = osal_mem_alloc(sizeof(OsalTadkREC_t));
     if (TaskNew)
     {
@@ -135,9 +285,12 @@ void osal_add_Task(pTaskInitFn pfnInit,
         TaskNew->pfnEventProcessor = pfnEventProcessor;
         TaskNew->taskID = Task_id++;
         TaskNew->events = 0;
+        TaskNew->readyBit = 0;
         TaskNew->taskPriority = taskPriority;
         TaskNew->next = (OsalTadkREC_t *)NULL;
 
+        osalTaskTable[TaskNew->taskID] = TaskNew;
+
         TaskPTR = &TaskHead;
         TaskSech = TaskHead;
 
@@ -149,12 +302,14 @@ void osal_add_Task(pTaskInitFn pfnInit,
             {
                 TaskNew->next = TaskSech;
                 *TaskPTR = TaskNew;
+                osalRankTasks();
                 return;
             }
             TaskPTR = &TaskSech->next;
             TaskSech = TaskSech->next;
         }
         *TaskPTR = TaskNew;
+        osalRankTasks();
     }
     return;
 }
@@ -164,7 +319,9 @@ void osal_add_Task(pTaskInitFn pfnInit,
  *
  * @brief   此函数将返回下一个活动任务。
  *
- * 注意:    任务队列按优先级排序。我们可以在第一个"就绪"任务（事件元素非零）处停止
+ * 注意:    就绪位按优先级排位，最高位对应最高优先级任务，
+ *          前导零计数即为最高优先级就绪任务的排位。
+ *          先并入中断中通过osal_isr_set_event置位的事件。
  *
  * @param   none
  *
@@ -172,22 +329,24 @@ void osal_add_Task(pTaskInitFn pfnInit,
  */
 OsalTadkREC_t *osalNextActiveTask(void)
 {
-    OsalTadkREC_t *TaskSech;
+    uint32 ready;
 
-    // 从开头开始
-    TaskSech = TaskHead;
+    if (osalIsrPending)
+    {
+        osalIsrEventsMerge();
+    }
+
+    ready = osalReadyMask;
+#if OSAL_PREEMPT
+    // 抢占任务由PendSV执行，主循环只运行协作任务
+    ready &= ~osalPreemptMask;
+#endif
 
-    // 查找直到找到或未找到
-    while (TaskSech)
+    if (ready == 0)
     {
-        if (TaskSech->events)
-        {
-            // 任务是最高优先级且已就绪
-            return TaskSech;
-        }
-        TaskSech = TaskSech->next;
+        return NULL;
     }
-    return NULL;
+    return osalTaskRank[__CLZ(ready)];
 }
 
 /*********************************************************************
@@ -195,7 +354,7 @@ OsalTadkREC_t *osalNextActiveTask(void)
  *
  * @brief   此函数将根据任务ID返回对应任务。
  *
- * 注意:    任务队列按优先级排序。我们可以在第一个"就绪"任务（事件元素非零）处停止
+ * 注意:    任务ID按添加顺序分配，直接索引任务表
  *
  * @param   task_id  任务ID
  *
@@ -203,15 +362,77 @@ OsalTadkREC_t *osalNextActiveTask(void)
  */
 OsalTadkREC_t *osalFindTask(uint8 taskID)
 {
-    OsalTadkREC_t *TaskSech;
-    TaskSech = TaskHead;
-    while (TaskSech)
+    if (taskID < Task_id)
+    {
+        return (osalTaskTable[taskID]);
+    }
+    return ((OsalTadkREC_t *)NULL);
+}
+
+#if OSAL_PREEMPT
+/*********************************************************************
+ * @fn osal_preempt_run
+ *
+ * @brief   抢占任务调度，由PendSV中断调用(timer.c)。
+ *          PendSV为最低优先级中断，在其中按优先级运行有事件的抢占任务，
+ *          被打断的协作任务事件处理函数在PendSV返回后继续执行，所有任务共用一个栈。
+ *          抢占任务之间不再互相抢占，仍按优先级依次运行至完成。
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_preempt_run(void)
+{
+    halIntState_t intState;
+    OsalTadkREC_t *task;
+    uint32 ready;
+    uint16 events;
+    uint16 retEvents;
+#if OSAL_CPU_STATS
+    uint32 cpuStart; // 调用任务事件处理函数前的周期计数
+#endif
+
+    while (1)
     {
-        if (TaskSech->taskID == taskID)
+        if (osalIsrPending)
         {
-            return (TaskSech);
+            osalIsrEventsMerge();
+        }
+
+        HAL_ENTER_CRITICAL_SECTION(intState);
+        ready = osalReadyMask & osalPreemptMask;
+        if (ready == 0)
+        {
+            HAL_EXIT_CRITICAL_SECTION(intState);
+            break;
+        }
+        task = osalTaskRank[__CLZ(ready)];
+        events = task->events;
+        // 清除此任务的事件标志
+        task->events = 0;
+        osalReadyMask &= ~task->readyBit;
+        HAL_EXIT_CRITICAL_SECTION(intState);
+
+        if (task->pfnEventProcessor)
+        {
+#if OSAL_CPU_STATS
+            cpuStart = OSAL_CYCLE_COUNT();
+#endif
+            retEvents = (task->pfnEventProcessor)(task->taskID, events);
+#if OSAL_CPU_STATS
+            osal_cpu_account_preempt(task->taskID, events, retEvents, cpuStart);
+#endif
+
+            // 将未处理完的事件重新添加回当前任务
+            HAL_ENTER_CRITICAL_SECTION(intState);
+            task->events |= retEvents;
+            if (task->events)
+            {
+                osalReadyMask |= task->readyBit;
+            }
+            HAL_EXIT_CRITICAL_SECTION(intState);
         }
-        TaskSech = TaskSech->next;
     }
-    return ((OsalTadkREC_t *)NULL);
-}
\ No newline at end of file
+}
+#endif
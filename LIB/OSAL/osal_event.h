@@ -4,6 +4,21 @@
 #include "type.h"
 #include "osal_timer.h"
 
+#if !defined(OSAL_MAX_TASKS)
+#define OSAL_MAX_TASKS  32      //最大任务数量，任务表按任务ID直接索引，就绪位图为32位
+#endif
+
+#if (OSAL_MAX_TASKS > 32)
+#error OSAL_MAX_TASKS must not exceed 32!
+#endif
+
+#if !defined(OSAL_PREEMPT)
+#define OSAL_PREEMPT    0       //定义为1则开启抢占：优先级不低于OSAL_PREEMPT_PRIO的任务在PendSV中运行，可抢占低优先级任务的事件处理
+#endif
+#if !defined(OSAL_PREEMPT_PRIO)
+#define OSAL_PREEMPT_PRIO 128   //抢占任务的最低优先级
+#endif
+
 typedef void (*pTaskInitFn)(uint8 task_id);
 typedef uint16(*pTaskEventHandlerFn)(uint8 task_id, uint16 task_event);
 
@@ -18,9 +33,14 @@ typedef struct OSALTaskREC
     uint8                taskID;                //任务ID
     uint8                taskPriority;          //任务优先级
     uint16               events;                //任务事件
+    uint32               readyBit;              //就绪位图中的位，按优先级排序，最高优先级为最高位
 } OsalTadkREC_t;
 
 extern OsalTadkREC_t  *TaskActive;
+extern uint32          osalReadyMask;           //就绪位图，有事件的任务对应位置1
+#if OSAL_PREEMPT
+extern uint32          osalPreemptMask;         //抢占任务在就绪位图中对应的位
+#endif
 
 extern void osal_start_system(void);
 extern void osal_add_Task(pTaskInitFn pfnInit, pTaskEventHandlerFn pfnEventProcessor, uint8 taskPriority);
@@ -30,5 +50,9 @@ extern OsalTadkREC_t *osalNextActiveTask(void);
 extern OsalTadkREC_t *osalFindTask(uint8 taskID);
 extern uint8 osal_set_event(byte task_id, uint16 event_flag);
 extern uint8 osal_clear_event(uint8 task_id, uint16 event_flag);
+extern uint8 osal_isr_set_event(uint8 task_id, uint16 event_flag);
+#if OSAL_PREEMPT
+extern void osal_preempt_run(void);
+#endif
 
 #endif
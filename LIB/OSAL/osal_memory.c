@@ -1,6 +1,8 @@
 #include "osal_memory.h"
 #include "type.h"
 
+#if !OSALMEM_TLSF
+
 #if ( MAXMEMHEAP >= 32768 )             //内存管理默认使用15位数据标识，最大能管理32768字节
 #error MAXMEMHEAP is too big to manage!
 #endif
@@ -146,15 +148,15 @@ void osal_mem_init(void)
  */
 void osal_mem_kick(void)
 {
-    //halIntState_t  intState;
-    HAL_ENTER_CRITICAL_SECTION();  // Hold off interrupts.
+    halIntState_t intState;
+    HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
 
     /* Logic in osal_mem_free() will ratchet ff1 back down to the first free
      * block in the small-block bucket.
      */
     ff1 = ff2;
 
-    HAL_EXIT_CRITICAL_SECTION();  // Re-enable interrupts.
+    HAL_EXIT_CRITICAL_SECTION(intState);  // Re-enable interrupts.
 }
 
 /*********************************************************************
@@ -168,6 +170,7 @@ void osal_mem_kick(void)
  */
 void *osal_mem_alloc(uint16 size)
 {
+    halIntState_t intState;
     osalMemHdr_t  *prev;
     osalMemHdr_t  *hdr;
     uint16  tmp;
@@ -199,7 +202,7 @@ void *osal_mem_alloc(uint16 size)
         }
     }
 
-    HAL_ENTER_CRITICAL_SECTION();       // Hold off interrupts.
+    HAL_ENTER_CRITICAL_SECTION(intState);       // Hold off interrupts.
 
     // Smaller allocations are first attempted in the small-block bucket.
     if(size <= OSALMEM_SMALL_BLKSZ)
@@ -298,7 +301,7 @@ void *osal_mem_alloc(uint16 size)
         hdr++;                              //偏移，返回实际申请的内存地址
     }
 
-    HAL_EXIT_CRITICAL_SECTION();            // Re-enable interrupts.
+    HAL_EXIT_CRITICAL_SECTION(intState);    // Re-enable interrupts.
 
     return (void *)hdr;
 }
@@ -315,7 +318,7 @@ void *osal_mem_alloc(uint16 size)
 void osal_mem_free(void *ptr)
 {
     osalMemHdr_t  *currHdr;
-    //halIntState_t   intState;
+    halIntState_t intState;
 
 #if ( OSALMEM_GUARD )
     // Try to protect against premature use by HAL / OSAL.
@@ -325,7 +328,7 @@ void osal_mem_free(void *ptr)
     }
 #endif
 
-    HAL_ENTER_CRITICAL_SECTION();  // Hold off interrupts.
+    HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
 
     currHdr = (osalMemHdr_t *)ptr - 1;
 
@@ -341,7 +344,7 @@ void osal_mem_free(void *ptr)
     blkFree++;
 #endif
 
-    HAL_EXIT_CRITICAL_SECTION();  // Re-enable interrupts.
+    HAL_EXIT_CRITICAL_SECTION(intState);  // Re-enable interrupts.
 }
 
 #if OSALMEM_METRICS
@@ -396,7 +399,7 @@ uint16 osal_heap_block_free(void)
  *
  * @return  Current number of bytes allocated.
  */
-uint16 osal_heap_mem_used(void)
+osalMemSize_t osal_heap_mem_used(void)
 {
     return memAlo;
 }
@@ -410,7 +413,7 @@ uint16 osal_heap_mem_used(void)
  *
  * @return  Highest number of bytes ever used by the stack.
  */
-uint16 osal_heap_high_water(void)
+osalMemSize_t osal_heap_high_water(void)
 {
 #if ( OSALMEM_METRICS )
     return memMax;
@@ -425,4 +428,49 @@ uint16 osal_heap_mem_usage_rate(void)
     return (uint16)(memAlo / (MAXMEMHEAP / 100));
 }
 
+/*********************************************************************
+ * @fn osal_heap_largest_free
+ *
+ * @brief   Return the largest block that could be allocated now.
+ *          遍历整个堆，相邻空闲块按分配时的合并规则计为一块，用于评估内存碎片。
+ *
+ * @param   none
+ *
+ * @return  当前可分配的最大字节数。
+ */
+osalMemSize_t osal_heap_largest_free(void)
+{
+    halIntState_t intState;
+    osalMemHdr_t *hdr = (osalMemHdr_t *)theHeap;
+    uint16 run = 0;
+    uint16 largest = 0;
+    uint16 tmp;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+
+    while((tmp = *hdr) != 0)
+    {
+        if(tmp & OSALMEM_IN_USE)
+        {
+            tmp ^= OSALMEM_IN_USE;
+            run = 0;
+        }
+        else
+        {
+            run += tmp;
+            if(largest < run)
+            {
+                largest = run;
+            }
+        }
+        hdr = (osalMemHdr_t *)((byte *)hdr + tmp);
+    }
+
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    return (largest > HDRSZ) ? (largest - HDRSZ) : 0;
+}
+
+#endif
+
 #endif
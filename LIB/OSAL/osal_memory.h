@@ -3,10 +3,22 @@
 
 #include "type.h"
 
-#define MAXMEMHEAP              1024*8       //内存池大小，单位字节
+#if !defined(MAXMEMHEAP)
+#define MAXMEMHEAP              (1024*8)     //内存池大小，单位字节
+#endif
 
 #define OSALMEM_METRICS         1            //定义有效则开启内存统计
 
+#if !defined(OSALMEM_TLSF)
+#define OSALMEM_TLSF            0            //定义为1则使用TLSF内存管理(osal_memory_tlsf.c)，分配释放耗时固定，堆可超过32KB
+#endif
+
+#if OSALMEM_TLSF
+typedef uint32 osalMemSize_t;
+#else
+typedef uint16 osalMemSize_t;
+#endif
+
 void osal_mem_init(void);
 void osal_mem_kick(void);
 void *osal_mem_alloc(uint16 size);
@@ -16,9 +28,10 @@ void osal_mem_free(void *ptr);
 uint16 osal_heap_block_max(void);
 uint16 osal_heap_block_cnt(void);
 uint16 osal_heap_block_free(void);
-uint16 osal_heap_mem_used(void);
-uint16 osal_heap_high_water(void);
+osalMemSize_t osal_heap_mem_used(void);
+osalMemSize_t osal_heap_high_water(void);
 uint16 osal_heap_mem_usage_rate(void);
+osalMemSize_t osal_heap_largest_free(void);
 #endif
 
 #endif
@@ -0,0 +1,564 @@
+#include "osal_memory.h"
+#include "type.h"
+
+#if OSALMEM_TLSF
+
+/*
+ * TLSF(两级分离适配)内存管理
+ *
+ * 空闲块按大小分入两级链表：一级按2的幂划分(fl)，二级把每个2的幂区间再等分为
+ * 2^OSALMEM_TLSF_SL_LOG2份(sl)，两级各有一个位图记录哪些链表非空。
+ * 分配时先把申请大小向上取整到所在区间的上界，再用位图查找第一个非空链表，
+ * 取出的空闲块必然够用；释放时与前后相邻空闲块立即合并。
+ * 分配和释放都只有固定次数的位操作和链表操作，耗时与堆中块数无关。
+ */
+
+#if !defined ( OSALMEM_TLSF_SL_LOG2 )
+#define OSALMEM_TLSF_SL_LOG2    3       //二级链表数的对数，每个2的幂区间分为8份
+#endif
+
+#if !defined ( OSALMEM_TLSF_FL_MAX )
+#define OSALMEM_TLSF_FL_MAX     16      //最大块大小的对数，可管理的块不超过2^(FL_MAX+1)字节
+#endif
+
+#if !defined ( OSALMEM_GUARD )
+#define OSALMEM_GUARD  TRUE
+#define OSALMEM_READY  0xE2
+#endif
+
+#if !defined ( OSALMEM_TLSF_ALIGN_LOG2 )
+#if defined(__SIZEOF_POINTER__) && (__SIZEOF_POINTER__ == 8)
+#define OSALMEM_TLSF_ALIGN_LOG2 3       //64位主机：halDataAlign_t为8字节
+#else
+#define OSALMEM_TLSF_ALIGN_LOG2 2       //对齐单位的对数，须与halDataAlign_t的长度一致
+#endif
+#endif
+
+#define TLSF_SL_COUNT       (1 << OSALMEM_TLSF_SL_LOG2)
+#define TLSF_ALIGN          (1UL << OSALMEM_TLSF_ALIGN_LOG2)
+#define TLSF_FL_SHIFT       (OSALMEM_TLSF_SL_LOG2 + OSALMEM_TLSF_ALIGN_LOG2)
+#define TLSF_FL_COUNT       (OSALMEM_TLSF_FL_MAX - TLSF_FL_SHIFT + 2)
+#define TLSF_SMALL_BLOCK    (1UL << TLSF_FL_SHIFT)     //小于此值的块全部放在第0级，按对齐单位线性划分
+
+#if ( MAXMEMHEAP >= (2UL << OSALMEM_TLSF_FL_MAX) )
+#error MAXMEMHEAP is too big for OSALMEM_TLSF_FL_MAX!
+#endif
+
+#if ( TLSF_SL_COUNT > 32 ) || ( TLSF_FL_COUNT > 32 )
+#error TLSF bitmap does not fit in 32 bits!
+#endif
+
+//块大小的低两位用作标志(块大小总是对齐单位的整数倍)
+#define TLSF_BLK_FREE       0x01UL      //本块空闲
+#define TLSF_BLK_PREV_FREE  0x02UL      //物理上的前一块空闲
+#define TLSF_BLK_FLAGS      (TLSF_BLK_FREE | TLSF_BLK_PREV_FREE)
+
+//内存块控制头，nextFree和prevFree只在块空闲时有效，分配后作为数据区的一部分
+typedef struct osalTlsfBlk
+{
+    struct osalTlsfBlk *prevPhys;   //物理上的前一块
+    uint32 size;                    //数据区大小 | 标志
+    struct osalTlsfBlk *nextFree;   //同一链表中的下一个空闲块
+    struct osalTlsfBlk *prevFree;   //同一链表中的上一个空闲块
+} osalTlsfBlk_t;
+
+#define TLSF_HDRSZ          ((uint32)(sizeof(osalTlsfBlk_t *) + sizeof(uint32) + TLSF_ALIGN - 1) & ~(uint32)(TLSF_ALIGN - 1))
+#define TLSF_BLK_MIN        (sizeof(osalTlsfBlk_t) - TLSF_HDRSZ)      //数据区至少能放下两个空闲链表指针
+#define TLSF_BLK_SIZE(b)    ((b)->size & ~TLSF_BLK_FLAGS)
+#define TLSF_BLK_NEXT(b)    ((osalTlsfBlk_t *)((byte *)(b) + TLSF_HDRSZ + TLSF_BLK_SIZE(b)))
+
+#if ( OSALMEM_GUARD )
+static byte ready = 0;
+#endif
+
+static uint32 flBitmap;                                 //一级位图
+static uint32 slBitmap[TLSF_FL_COUNT];                  //二级位图
+static osalTlsfBlk_t *freeList[TLSF_FL_COUNT][TLSF_SL_COUNT];
+
+#if defined( EXTERNAL_RAM )
+static byte  *theHeap = (byte *)EXT_RAM_BEG;
+#else
+static halDataAlign_t _theHeap[ MAXMEMHEAP / sizeof(halDataAlign_t) ];
+static byte  *theHeap = (byte *)_theHeap;
+#endif
+
+#if OSALMEM_METRICS
+static uint16 blkMax;           // Max cnt of all blocks ever seen at once.
+static uint16 blkCnt;           // Current cnt of all blocks.
+static uint16 blkFree;          // Current cnt of free blocks.
+static osalMemSize_t memAlo;    // Current total memory allocated.
+static osalMemSize_t memMax;    // Max total memory ever allocated at once.
+#endif
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+//最高置位位的序号，x不为0
+#define TLSF_FLS(x)     (31 - __CLZ(x))
+//最低置位位的序号，x不为0
+#define TLSF_FFS(x)     (31 - __CLZ((x) & (~(x) + 1)))
+
+/*********************************************************************
+ * @fn osalTlsfMapping
+ *
+ * @brief   计算大小为size的空闲块所在的一级、二级链表序号。
+ *
+ * @param   size - 块数据区大小
+ *          fl   - 输出一级序号
+ *          sl   - 输出二级序号
+ *
+ * @return  void
+ */
+static void osalTlsfMapping(uint32 size, uint8 *fl, uint8 *sl)
+{
+    uint8 f;
+
+    if(size < TLSF_SMALL_BLOCK)
+    {
+        *fl = 0;
+        *sl = (uint8)(size / (TLSF_SMALL_BLOCK / TLSF_SL_COUNT));
+    }
+    else
+    {
+        f = (uint8)TLSF_FLS(size);
+        *sl = (uint8)((size >> (f - OSALMEM_TLSF_SL_LOG2)) ^ TLSF_SL_COUNT);
+        *fl = (uint8)(f - TLSF_FL_SHIFT + 1);
+    }
+}
+
+/*********************************************************************
+ * @fn osalTlsfRemove
+ *
+ * @brief   把空闲块从所在链表中摘除，链表变空时清除位图。
+ *
+ * @param   blk - 空闲块
+ *
+ * @return  void
+ */
+static void osalTlsfRemove(osalTlsfBlk_t *blk)
+{
+    uint8 fl, sl;
+
+    osalTlsfMapping(TLSF_BLK_SIZE(blk), &fl, &sl);
+
+    if(blk->nextFree)
+    {
+        blk->nextFree->prevFree = blk->prevFree;
+    }
+    if(blk->prevFree)
+    {
+        blk->prevFree->nextFree = blk->nextFree;
+    }
+    else
+    {
+        freeList[fl][sl] = blk->nextFree;
+        if(freeList[fl][sl] == NULL)
+        {
+            slBitmap[fl] &= ~(1UL << sl);
+            if(slBitmap[fl] == 0)
+            {
+                flBitmap &= ~(1UL << fl);
+            }
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn osalTlsfInsert
+ *
+ * @brief   把空闲块插入对应链表的表头并设置位图。
+ *
+ * @param   blk - 空闲块
+ *
+ * @return  void
+ */
+static void osalTlsfInsert(osalTlsfBlk_t *blk)
+{
+    uint8 fl, sl;
+
+    osalTlsfMapping(TLSF_BLK_SIZE(blk), &fl, &sl);
+
+    blk->prevFree = NULL;
+    blk->nextFree = freeList[fl][sl];
+    if(blk->nextFree)
+    {
+        blk->nextFree->prevFree = blk;
+    }
+    freeList[fl][sl] = blk;
+    flBitmap |= 1UL << fl;
+    slBitmap[fl] |= 1UL << sl;
+}
+
+/*********************************************************************
+ * @fn osalTlsfFind
+ *
+ * @brief   查找一个数据区不小于size的空闲块。
+ *          size先向上取整到所在二级区间的上界，之后找到的任意块都满足要求。
+ *
+ * @param   size - 需要的数据区大小(已对齐)
+ *
+ * @return  osalTlsfBlk_t * - 空闲块；没有合适的块时返回NULL
+ */
+static osalTlsfBlk_t *osalTlsfFind(uint32 size)
+{
+    uint32 map;
+    uint8 fl, sl;
+
+    if(size >= TLSF_SMALL_BLOCK)
+    {
+        size += (1UL << (TLSF_FLS(size) - OSALMEM_TLSF_SL_LOG2)) - 1;
+    }
+    osalTlsfMapping(size, &fl, &sl);
+    if(fl >= TLSF_FL_COUNT)
+    {
+        return NULL;
+    }
+
+    map = slBitmap[fl] & (~0UL << sl);
+    if(map == 0)
+    {
+        //本级没有更大的块，到更高一级中找
+        map = (fl + 1 < 32) ? (flBitmap & (~0UL << (fl + 1))) : 0;
+        if(map == 0)
+        {
+            return NULL;
+        }
+        fl = (uint8)TLSF_FFS(map);
+        map = slBitmap[fl];
+    }
+    sl = (uint8)TLSF_FFS(map);
+
+    return freeList[fl][sl];
+}
+
+/*********************************************************************
+ * @fn osal_mem_init
+ *
+ * @brief   Initialize the heap memory management system.
+ *          整个堆初始化为一个空闲块，末尾保留一个大小为0的已用块作为边界。
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void osal_mem_init(void)
+{
+    osalTlsfBlk_t *blk;
+    osalTlsfBlk_t *end;
+    uint8 i, j;
+
+    flBitmap = 0;
+    for(i = 0; i < TLSF_FL_COUNT; i++)
+    {
+        slBitmap[i] = 0;
+        for(j = 0; j < TLSF_SL_COUNT; j++)
+        {
+            freeList[i][j] = NULL;
+        }
+    }
+
+    blk = (osalTlsfBlk_t *)theHeap;
+    blk->prevPhys = NULL;
+    blk->size = ((((uint32)MAXMEMHEAP / TLSF_ALIGN) * TLSF_ALIGN) - 2 * TLSF_HDRSZ) | TLSF_BLK_FREE;
+
+    end = TLSF_BLK_NEXT(blk);
+    end->prevPhys = blk;
+    end->size = TLSF_BLK_PREV_FREE;
+
+    osalTlsfInsert(blk);
+
+#if ( OSALMEM_GUARD )
+    ready = OSALMEM_READY;
+#endif
+
+#if ( OSALMEM_METRICS )
+    blkCnt = blkFree = 1;
+    memAlo = 0;
+#endif
+}
+
+/*********************************************************************
+ * @fn osal_mem_kick
+ *
+ * @brief   TLSF没有固定长度分配区域，保留此函数以兼容原接口。
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void osal_mem_kick(void)
+{
+}
+
+/*********************************************************************
+ * @fn osal_mem_alloc
+ *
+ * @brief   Implementation of the allocator functionality.
+ *
+ * @param   size - number of bytes to allocate from the heap.
+ *
+ * @return  void * - pointer to the heap allocation; NULL if error or failure.
+ */
+void *osal_mem_alloc(uint16 size)
+{
+    halIntState_t intState;
+    osalTlsfBlk_t *blk;
+    osalTlsfBlk_t *rest;
+    uint32 need;
+    uint32 remain;
+
+#if ( OSALMEM_GUARD )
+    // Try to protect against premature use by HAL / OSAL.
+    if(ready != OSALMEM_READY)
+    {
+        osal_mem_init();
+    }
+#endif
+
+    //根据实际的芯片的字长halDataAlign_t进行字节对齐
+    need = ((uint32)size + TLSF_ALIGN - 1) & ~(uint32)(TLSF_ALIGN - 1);
+    if(need < TLSF_BLK_MIN)
+    {
+        need = TLSF_BLK_MIN;
+    }
+
+    HAL_ENTER_CRITICAL_SECTION(intState);       // Hold off interrupts.
+
+    blk = osalTlsfFind(need);
+    if(blk != NULL)
+    {
+        osalTlsfRemove(blk);
+
+        remain = TLSF_BLK_SIZE(blk) - need;
+        if(remain >= TLSF_HDRSZ + TLSF_BLK_MIN)
+        {
+            //剩余空间足够组成一个空闲块，分割后放回链表
+            blk->size = need | (blk->size & TLSF_BLK_PREV_FREE);
+            rest = TLSF_BLK_NEXT(blk);
+            rest->prevPhys = blk;
+            rest->size = (remain - TLSF_HDRSZ) | TLSF_BLK_FREE;
+            TLSF_BLK_NEXT(rest)->prevPhys = rest;
+            osalTlsfInsert(rest);
+
+#if ( OSALMEM_METRICS )
+            blkCnt++;
+            if(blkMax < blkCnt)
+            {
+                blkMax = blkCnt;
+            }
+#endif
+        }
+        else
+        {
+            blk->size &= ~TLSF_BLK_FREE;
+            TLSF_BLK_NEXT(blk)->size &= ~TLSF_BLK_PREV_FREE;
+
+#if ( OSALMEM_METRICS )
+            blkFree--;
+#endif
+        }
+
+#if ( OSALMEM_METRICS )
+        memAlo += TLSF_HDRSZ + TLSF_BLK_SIZE(blk);
+        if(memMax < memAlo)
+        {
+            memMax = memAlo;
+        }
+#endif
+
+        blk = (osalTlsfBlk_t *)((byte *)blk + TLSF_HDRSZ);
+    }
+
+    HAL_EXIT_CRITICAL_SECTION(intState);        // Re-enable interrupts.
+
+    return (void *)blk;
+}
+
+/*********************************************************************
+ * @fn osal_mem_free
+ *
+ * @brief   Implementation of the de-allocator functionality.
+ *          释放时立即与物理相邻的空闲块合并。
+ *
+ * @param   ptr - pointer to the memory to free.
+ *
+ * @return  void
+ */
+void osal_mem_free(void *ptr)
+{
+    halIntState_t intState;
+    osalTlsfBlk_t *blk;
+    osalTlsfBlk_t *next;
+    osalTlsfBlk_t *prev;
+
+#if ( OSALMEM_GUARD )
+    // Try to protect against premature use by HAL / OSAL.
+    if(ready != OSALMEM_READY)
+    {
+        osal_mem_init();
+    }
+#endif
+
+    if(ptr == NULL)
+    {
+        return;
+    }
+
+    HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
+
+    blk = (osalTlsfBlk_t *)((byte *)ptr - TLSF_HDRSZ);
+
+#if OSALMEM_METRICS
+    memAlo -= TLSF_HDRSZ + TLSF_BLK_SIZE(blk);
+    blkFree++;
+#endif
+
+    //与前一个空闲块合并
+    if(blk->size & TLSF_BLK_PREV_FREE)
+    {
+        prev = blk->prevPhys;
+        osalTlsfRemove(prev);
+        prev->size += TLSF_HDRSZ + TLSF_BLK_SIZE(blk);
+        blk = prev;
+
+#if OSALMEM_METRICS
+        blkCnt--;
+        blkFree--;
+#endif
+    }
+
+    //与后一个空闲块合并
+    next = TLSF_BLK_NEXT(blk);
+    if(next->size & TLSF_BLK_FREE)
+    {
+        osalTlsfRemove(next);
+        blk->size += TLSF_HDRSZ + TLSF_BLK_SIZE(next);
+
+#if OSALMEM_METRICS
+        blkCnt--;
+        blkFree--;
+#endif
+    }
+
+    blk->size |= TLSF_BLK_FREE;
+    next = TLSF_BLK_NEXT(blk);
+    next->prevPhys = blk;
+    next->size |= TLSF_BLK_PREV_FREE;
+    osalTlsfInsert(blk);
+
+    HAL_EXIT_CRITICAL_SECTION(intState);  // Re-enable interrupts.
+}
+
+#if OSALMEM_METRICS
+/*********************************************************************
+ * @fn osal_heap_block_max
+ *
+ * @brief   Return the maximum number of blocks ever allocated at once.
+ *
+ * @param   none
+ *
+ * @return  Maximum number of blocks ever allocated at once.
+ */
+uint16 osal_heap_block_max(void)
+{
+    return blkMax;
+}
+
+/*********************************************************************
+ * @fn osal_heap_block_cnt
+ *
+ * @brief   Return the current number of blocks now allocated.
+ *
+ * @param   none
+ *
+ * @return  Current number of blocks now allocated.
+ */
+uint16 osal_heap_block_cnt(void)
+{
+    return blkCnt;
+}
+
+/*********************************************************************
+ * @fn osal_heap_block_free
+ *
+ * @brief   Return the current number of free blocks.
+ *
+ * @param   none
+ *
+ * @return  Current number of free blocks.
+ */
+uint16 osal_heap_block_free(void)
+{
+    return blkFree;
+}
+
+/*********************************************************************
+ * @fn osal_heap_mem_used
+ *
+ * @brief   Return the current number of bytes allocated.
+ *
+ * @param   none
+ *
+ * @return  Current number of bytes allocated.
+ */
+osalMemSize_t osal_heap_mem_used(void)
+{
+    return memAlo;
+}
+
+/*********************************************************************
+ * @fn osal_heap_high_water
+ *
+ * @brief   Return the highest byte ever allocated in the heap.
+ *
+ * @param   none
+ *
+ * @return  Highest number of bytes ever used by the stack.
+ */
+osalMemSize_t osal_heap_high_water(void)
+{
+    return memMax;
+}
+
+//返回内存使用率
+uint16 osal_heap_mem_usage_rate(void)
+{
+    return (uint16)(memAlo / (MAXMEMHEAP / 100));
+}
+
+/*********************************************************************
+ * @fn osal_heap_largest_free
+ *
+ * @brief   Return the largest block that could be allocated now.
+ *          TLSF释放时立即合并，遍历物理块取最大的空闲块即可，用于评估内存碎片。
+ *
+ * @param   none
+ *
+ * @return  当前可分配的最大字节数。
+ */
+osalMemSize_t osal_heap_largest_free(void)
+{
+    halIntState_t intState;
+    osalTlsfBlk_t *blk = (osalTlsfBlk_t *)theHeap;
+    osalMemSize_t largest = 0;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+
+    while(TLSF_BLK_SIZE(blk) != 0)
+    {
+        if((blk->size & TLSF_BLK_FREE) && (largest < TLSF_BLK_SIZE(blk)))
+        {
+            largest = TLSF_BLK_SIZE(blk);
+        }
+        blk = TLSF_BLK_NEXT(blk);
+    }
+
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    return largest;
+}
+
+#endif
+
+#endif
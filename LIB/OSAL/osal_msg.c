@@ -4,6 +4,186 @@
 
 #define SYS_EVENT_MSG 0x8000
 
+// 每个任务独立的消息队列，头尾指针均指向消息数据区(消息头之后)
+static void *msgQHead[OSAL_MAX_TASKS];
+static void *msgQTail[OSAL_MAX_TASKS];
+
+#if OSAL_MSG_POOL
+// 消息池中每块占用的字数(消息头 + 数据区，按halDataAlign_t对齐)
+#define OSAL_MSG_POOL_WORDS(size) \
+    ((sizeof(osal_msg_hdr_t) + (size) + sizeof(halDataAlign_t) - 1) / sizeof(halDataAlign_t))
+
+typedef struct
+{
+    halDataAlign_t *base; // 池存储区
+    uint16 size;          // 每块数据区大小
+    uint16 words;         // 每块占用的字数
+    uint16 cnt;           // 块数
+    uint16 used;          // 当前已分配块数
+    uint16 max;           // 历史最大已分配块数
+    osal_msg_hdr_t *free; // 空闲块链表
+} osalMsgPool_t;
+
+static halDataAlign_t msgPoolSmall[OSAL_MSG_POOL_SMALL_CNT * OSAL_MSG_POOL_WORDS(OSAL_MSG_POOL_SMALL_SIZE)];
+static halDataAlign_t msgPoolMedium[OSAL_MSG_POOL_MEDIUM_CNT * OSAL_MSG_POOL_WORDS(OSAL_MSG_POOL_MEDIUM_SIZE)];
+static halDataAlign_t msgPoolLarge[OSAL_MSG_POOL_LARGE_CNT * OSAL_MSG_POOL_WORDS(OSAL_MSG_POOL_LARGE_SIZE)];
+
+// 按数据区大小从小到大排列
+static osalMsgPool_t msgPools[OSAL_MSG_POOL_NUM] = {
+    {msgPoolSmall, OSAL_MSG_POOL_SMALL_SIZE, OSAL_MSG_POOL_WORDS(OSAL_MSG_POOL_SMALL_SIZE), OSAL_MSG_POOL_SMALL_CNT, 0, 0, NULL},
+    {msgPoolMedium, OSAL_MSG_POOL_MEDIUM_SIZE, OSAL_MSG_POOL_WORDS(OSAL_MSG_POOL_MEDIUM_SIZE), OSAL_MSG_POOL_MEDIUM_CNT, 0, 0, NULL},
+    {msgPoolLarge, OSAL_MSG_POOL_LARGE_SIZE, OSAL_MSG_POOL_WORDS(OSAL_MSG_POOL_LARGE_SIZE), OSAL_MSG_POOL_LARGE_CNT, 0, 0, NULL},
+};
+
+static uint16 msgPoolOverflow; // 因池用尽而改从堆分配的次数
+#endif
+
+/*********************************************************************
+ * @fn osal_msg_init
+ *
+ * @brief
+ *
+ *    初始化所有任务的消息队列。
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_msg_init(void)
+{
+    uint8 i;
+
+    for (i = 0; i < OSAL_MAX_TASKS; i++)
+    {
+        msgQHead[i] = NULL;
+        msgQTail[i] = NULL;
+    }
+
+#if OSAL_MSG_POOL
+    // 把每个池的所有块串成空闲链表
+    for (i = 0; i < OSAL_MSG_POOL_NUM; i++)
+    {
+        osalMsgPool_t *pool = &msgPools[i];
+        uint16 blk;
+
+        pool->free = NULL;
+        pool->used = 0;
+        pool->max = 0;
+        for (blk = pool->cnt; blk > 0; blk--)
+        {
+            osal_msg_hdr_t *hdr = (osal_msg_hdr_t *)(pool->base + (blk - 1) * pool->words);
+            hdr->next = pool->free;
+            hdr->pool_id = i;
+            pool->free = hdr;
+        }
+    }
+    msgPoolOverflow = 0;
+#endif
+}
+
+#if OSAL_MSG_POOL
+/*********************************************************************
+ * @fn osal_msg_pool_alloc
+ *
+ * @brief
+ *
+ *    从能容纳len字节的最小消息池中取出一块，该池用尽时依次尝试更大的池。
+ *
+ * @param   uint16 len  - 所需数据区长度
+ *
+ * @return  指向消息头的指针，所有合适的池都已用尽时返回NULL
+ */
+static osal_msg_hdr_t *osal_msg_pool_alloc(uint16 len)
+{
+    halIntState_t intState;
+    osal_msg_hdr_t *hdr = NULL;
+    uint8 fits = FALSE;
+    uint8 i;
+
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
+
+    for (i = 0; i < OSAL_MSG_POOL_NUM; i++)
+    {
+        osalMsgPool_t *pool = &msgPools[i];
+
+        if (len > pool->size)
+        {
+            continue;
+        }
+        fits = TRUE;
+
+        hdr = pool->free;
+        if (hdr != NULL)
+        {
+            pool->free = hdr->next;
+            pool->used++;
+            if (pool->max < pool->used)
+            {
+                pool->max = pool->used;
+            }
+            break;
+        }
+    }
+
+    if ((hdr == NULL) && fits)
+    {
+        msgPoolOverflow++;
+    }
+
+    HAL_EXIT_CRITICAL_SECTION(intState); // 恢复中断
+
+    return hdr;
+}
+
+/*********************************************************************
+ * @fn osal_msg_pool_used
+ *
+ * @brief
+ *
+ *    返回消息池当前已分配的块数。
+ *
+ * @param   uint8 pool  - 消息池序号，0为小池，依次增大
+ *
+ * @return  已分配的块数
+ */
+uint16 osal_msg_pool_used(uint8 pool)
+{
+    return (pool < OSAL_MSG_POOL_NUM) ? msgPools[pool].used : 0;
+}
+
+/*********************************************************************
+ * @fn osal_msg_pool_high_water
+ *
+ * @brief
+ *
+ *    返回消息池历史上同时分配的最大块数，用于调整池的块数。
+ *
+ * @param   uint8 pool  - 消息池序号，0为小池，依次增大
+ *
+ * @return  历史最大已分配块数
+ */
+uint16 osal_msg_pool_high_water(uint8 pool)
+{
+    return (pool < OSAL_MSG_POOL_NUM) ? msgPools[pool].max : 0;
+}
+
+/*********************************************************************
+ * @fn osal_msg_pool_overflow
+ *
+ * @brief
+ *
+ *    返回因消息池用尽而改从堆分配的次数。
+ *
+ * @param   none
+ *
+ * @return  溢出次数
+ */
+uint16 osal_msg_pool_overflow(void)
+{
+    return msgPoolOverflow;
+}
+#endif
+
 /*********************************************************************
  * @fn osal_msg_allocate
  *
@@ -12,23 +192,33 @@
  *    此函数由任务调用，用于分配一个消息缓冲区，
  *    任务将在其中编码它希望发送的特定消息。这种通用缓冲区方案
  *    用于严格限制由于微处理器RAM大小限制而在系统内创建的消息缓冲区。
- *    注意所有消息缓冲区都是固定大小的（至少最初是这样）。
- *    参数len保留以备将来创建具有不同固定消息大小的消息池时使用
- *    （例如，可以维护和分配大、中、小三种尺寸的消息缓冲池）。
+ *    开启OSAL_MSG_POOL时，按len从小、中、大三种固定大小的消息池中分配，
+ *    分配时间固定且不产生堆碎片；池用尽或消息过大时才从堆中分配。
  *
  * @param   uint8 len  - 所需缓冲区长度
  * @return  指向已分配缓冲区的指针，如果分配失败则返回NULL
  */
 uint8 *osal_msg_allocate(uint16 len)
 {
-    osal_msg_hdr_t *hdr;
+    osal_msg_hdr_t *hdr = NULL;
 
     if (len == 0)
     {
         return (NULL);
     }
 
-    hdr = (osal_msg_hdr_t *)osal_mem_alloc((short)(len + sizeof(osal_msg_hdr_t)));
+#if OSAL_MSG_POOL
+    hdr = osal_msg_pool_alloc(len);
+    if (hdr == NULL)
+#endif
+    {
+        hdr = (osal_msg_hdr_t *)osal_mem_alloc((short)(len + sizeof(osal_msg_hdr_t)));
+        if (hdr)
+        {
+            hdr->pool_id = OSAL_MSG_POOL_HEAP;
+        }
+    }
+
     if (hdr)
     {
         hdr->next = NULL;
@@ -57,6 +247,9 @@ uint8 *osal_msg_allocate(uint16 len)
  */
 uint8 osal_msg_deallocate(uint8 *msg_ptr)
 {
+#if OSAL_MSG_POOL
+    halIntState_t intState;
+#endif
     uint8 *x;
 
     if (msg_ptr == NULL)
@@ -72,6 +265,22 @@ uint8 osal_msg_deallocate(uint8 *msg_ptr)
 
     x = (uint8 *)((uint8 *)msg_ptr - sizeof(osal_msg_hdr_t));
 
+#if OSAL_MSG_POOL
+    if (((osal_msg_hdr_t *)x)->pool_id < OSAL_MSG_POOL_NUM)
+    {
+        // 归还到所属消息池
+        osalMsgPool_t *pool = &msgPools[((osal_msg_hdr_t *)x)->pool_id];
+
+        HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
+        ((osal_msg_hdr_t *)x)->next = pool->free;
+        pool->free = (osal_msg_hdr_t *)x;
+        pool->used--;
+        HAL_EXIT_CRITICAL_SECTION(intState); // 恢复中断
+
+        return (SUCCESS);
+    }
+#endif
+
     osal_mem_free((void *)x);
 
     return (SUCCESS);
@@ -95,6 +304,7 @@ uint8 osal_msg_deallocate(uint8 *msg_ptr)
  */
 uint8 osal_msg_send(uint8 destination_task, uint8 *msg_ptr)
 {
+    halIntState_t intState;
     if (msg_ptr == NULL)
     {
         return (INVALID_MSG_POINTER);
@@ -116,8 +326,22 @@ uint8 osal_msg_send(uint8 destination_task, uint8 *msg_ptr)
 
     OSAL_MSG_ID(msg_ptr) = destination_task;
 
-    // 将消息入队
-    osal_msg_enqueue(&osal_qHead, msg_ptr);
+    // 关闭中断
+    HAL_ENTER_CRITICAL_SECTION(intState);
+
+    // 将消息加入目标任务队列的尾部
+    if (msgQTail[destination_task] != NULL)
+    {
+        OSAL_MSG_NEXT(msgQTail[destination_task]) = msg_ptr;
+    }
+    else
+    {
+        msgQHead[destination_task] = msg_ptr;
+    }
+    msgQTail[destination_task] = msg_ptr;
+
+    // 恢复中断
+    HAL_EXIT_CRITICAL_SECTION(intState);
 
     // 向目标任务发出有消息等待的信号
     osal_set_event(destination_task, SYS_EVENT_MSG);
@@ -140,41 +364,32 @@ uint8 osal_msg_send(uint8 destination_task, uint8 *msg_ptr)
  */
 uint8 *osal_msg_receive(uint8 task_id)
 {
-    osal_msg_hdr_t *listHdr;
-    osal_msg_hdr_t *prevHdr = NULL;
-    osal_msg_hdr_t *foundHdr = NULL;
+    halIntState_t intState;
+    void *foundMsg;
 
-    // 关闭中断
-    HAL_ENTER_CRITICAL_SECTION();
+    if (task_id >= OSAL_MAX_TASKS)
+    {
+        return (NULL);
+    }
 
-    // 指向队列顶部
-    listHdr = osal_qHead;
+    // 关闭中断
+    HAL_ENTER_CRITICAL_SECTION(intState);
 
-    // 遍历队列寻找属于请求任务的消息
-    while (listHdr != NULL)
+    // 从任务队列头部取出一条消息
+    foundMsg = msgQHead[task_id];
+    if (foundMsg != NULL)
     {
-        if ((listHdr - 1)->dest_id == task_id)
-        {
-            if (foundHdr == NULL)
-            {
-                // 保存第一个匹配的消息
-                foundHdr = listHdr;
-            }
-            else
-            {
-                // 找到第二个消息，停止查找
-                break;
-            }
-        }
-        if (foundHdr == NULL)
+        msgQHead[task_id] = OSAL_MSG_NEXT(foundMsg);
+        if (msgQHead[task_id] == NULL)
         {
-            prevHdr = listHdr;
+            msgQTail[task_id] = NULL;
         }
-        listHdr = OSAL_MSG_NEXT(listHdr);
+        OSAL_MSG_NEXT(foundMsg) = NULL;
+        OSAL_MSG_ID(foundMsg) = TASK_NO_TASK;
     }
 
     // 是否还有更多消息？
-    if (listHdr != NULL)
+    if (msgQHead[task_id] != NULL)
     {
         // 是的，向任务发出有消息等待的信号
         osal_set_event(task_id, SYS_EVENT_MSG);
@@ -185,17 +400,10 @@ uint8 *osal_msg_receive(uint8 task_id)
         osal_clear_event(task_id, SYS_EVENT_MSG);
     }
 
-    // 是否找到了消息？
-    if (foundHdr != NULL)
-    {
-        // 从链表中取出
-        osal_msg_extract(&osal_qHead, foundHdr, prevHdr);
-    }
-
     // 恢复中断
-    HAL_EXIT_CRITICAL_SECTION();
+    HAL_EXIT_CRITICAL_SECTION(intState);
 
-    return ((uint8 *)foundHdr);
+    return ((uint8 *)foundMsg);
 }
 
 /**************************************************************************************************
@@ -217,16 +425,22 @@ uint8 *osal_msg_receive(uint8 task_id)
  */
 osal_event_hdr_t *osal_msg_find(uint8 task_id, uint8 event)
 {
+    halIntState_t intState;
     osal_msg_hdr_t *pHdr;
 
-    HAL_ENTER_CRITICAL_SECTION(); // 关闭中断
+    if (task_id >= OSAL_MAX_TASKS)
+    {
+        return (NULL);
+    }
+
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
 
-    pHdr = osal_qHead; // 指向队列顶部
+    pHdr = msgQHead[task_id]; // 指向该任务队列顶部
 
-    // 遍历队列查找匹配task_id和event参数的消息
+    // 遍历任务队列查找匹配event参数的消息
     while (pHdr != NULL)
     {
-        if (((pHdr - 1)->dest_id == task_id) && (((osal_event_hdr_t *)pHdr)->event == event))
+        if (((osal_event_hdr_t *)pHdr)->event == event)
         {
             break;
         }
@@ -234,7 +448,7 @@ osal_event_hdr_t *osal_msg_find(uint8 task_id, uint8 event)
         pHdr = OSAL_MSG_NEXT(pHdr);
     }
 
-    HAL_EXIT_CRITICAL_SECTION(); // 恢复中断
+    HAL_EXIT_CRITICAL_SECTION(intState); // 恢复中断
 
     return (osal_event_hdr_t *)pHdr;
 }
@@ -253,10 +467,11 @@ osal_event_hdr_t *osal_msg_find(uint8 task_id, uint8 event)
  */
 void osal_msg_enqueue(osal_msg_q_t *q_ptr, void *msg_ptr)
 {
+    halIntState_t intState;
     void *list;
 
     // 关闭中断
-    HAL_ENTER_CRITICAL_SECTION();
+    HAL_ENTER_CRITICAL_SECTION(intState);
 
     OSAL_MSG_NEXT(msg_ptr) = NULL;
     // 如果是队列中的第一条消息
@@ -275,7 +490,7 @@ void osal_msg_enqueue(osal_msg_q_t *q_ptr, void *msg_ptr)
     }
 
     // 重新启用中断
-    HAL_EXIT_CRITICAL_SECTION();
+    HAL_EXIT_CRITICAL_SECTION(intState);
 }
 
 /*********************************************************************
@@ -291,10 +506,11 @@ void osal_msg_enqueue(osal_msg_q_t *q_ptr, void *msg_ptr)
  */
 void *osal_msg_dequeue(osal_msg_q_t *q_ptr)
 {
+    halIntState_t intState;
     void *msg_ptr = NULL;
 
     // 关闭中断
-    HAL_ENTER_CRITICAL_SECTION();
+    HAL_ENTER_CRITICAL_SECTION(intState);
 
     if (*q_ptr != NULL)
     {
@@ -306,7 +522,7 @@ void *osal_msg_dequeue(osal_msg_q_t *q_ptr)
     }
 
     // 重新启用中断
-    HAL_EXIT_CRITICAL_SECTION();
+    HAL_EXIT_CRITICAL_SECTION(intState);
 
     return msg_ptr;
 }
@@ -325,15 +541,16 @@ void *osal_msg_dequeue(osal_msg_q_t *q_ptr)
  */
 void osal_msg_push(osal_msg_q_t *q_ptr, void *msg_ptr)
 {
+    halIntState_t intState;
     // 关闭中断
-    HAL_ENTER_CRITICAL_SECTION();
+    HAL_ENTER_CRITICAL_SECTION(intState);
 
     // 将消息推入队列头部
     OSAL_MSG_NEXT(msg_ptr) = *q_ptr;
     *q_ptr = msg_ptr;
 
     // 重新启用中断
-    HAL_EXIT_CRITICAL_SECTION();
+    HAL_EXIT_CRITICAL_SECTION(intState);
 }
 
 /*********************************************************************
@@ -351,8 +568,9 @@ void osal_msg_push(osal_msg_q_t *q_ptr, void *msg_ptr)
  */
 void osal_msg_extract(osal_msg_q_t *q_ptr, void *msg_ptr, void *prev_ptr)
 {
+    halIntState_t intState;
     // 关闭中断
-    HAL_ENTER_CRITICAL_SECTION();
+    HAL_ENTER_CRITICAL_SECTION(intState);
 
     if (msg_ptr == *q_ptr)
     {
@@ -368,7 +586,7 @@ void osal_msg_extract(osal_msg_q_t *q_ptr, void *msg_ptr, void *prev_ptr)
     OSAL_MSG_ID(msg_ptr) = TASK_NO_TASK;
 
     // 重新启用中断
-    HAL_EXIT_CRITICAL_SECTION();
+    HAL_EXIT_CRITICAL_SECTION(intState);
 }
 
 /*********************************************************************
@@ -386,11 +604,12 @@ void osal_msg_extract(osal_msg_q_t *q_ptr, void *msg_ptr, void *prev_ptr)
  */
 uint8 osal_msg_enqueue_max(osal_msg_q_t *q_ptr, void *msg_ptr, uint8 max)
 {
+    halIntState_t intState;
     void *list;
     uint8 ret = FALSE;
 
     // 关闭中断
-    HAL_ENTER_CRITICAL_SECTION();
+    HAL_ENTER_CRITICAL_SECTION(intState);
 
     // 如果是队列中的第一条消息
     if (*q_ptr == NULL)
@@ -418,7 +637,7 @@ uint8 osal_msg_enqueue_max(osal_msg_q_t *q_ptr, void *msg_ptr, uint8 max)
     }
 
     // 重新启用中断
-    HAL_EXIT_CRITICAL_SECTION();
+    HAL_EXIT_CRITICAL_SECTION(intState);
 
     return ret;
 }
\ No newline at end of file
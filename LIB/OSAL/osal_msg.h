@@ -7,6 +7,35 @@
 #define OSAL_MSG_NEXT(msg_ptr) 	((osal_msg_hdr_t *) (msg_ptr) - 1)->next
 #define OSAL_MSG_ID(msg_ptr) 	((osal_msg_hdr_t *) (msg_ptr) - 1)->dest_id
 
+#if !defined(OSAL_MSG_POOL)
+#define OSAL_MSG_POOL               0       //定义为1则消息优先从固定大小的消息池分配，池用尽时才使用堆
+#endif
+
+#if OSAL_MSG_POOL
+// 小、中、大三种消息池，大小为消息数据区字节数(不含消息头)，个数为池中块数
+#if !defined(OSAL_MSG_POOL_SMALL_SIZE)
+#define OSAL_MSG_POOL_SMALL_SIZE    16
+#endif
+#if !defined(OSAL_MSG_POOL_SMALL_CNT)
+#define OSAL_MSG_POOL_SMALL_CNT     8
+#endif
+#if !defined(OSAL_MSG_POOL_MEDIUM_SIZE)
+#define OSAL_MSG_POOL_MEDIUM_SIZE   32
+#endif
+#if !defined(OSAL_MSG_POOL_MEDIUM_CNT)
+#define OSAL_MSG_POOL_MEDIUM_CNT    8
+#endif
+#if !defined(OSAL_MSG_POOL_LARGE_SIZE)
+#define OSAL_MSG_POOL_LARGE_SIZE    64
+#endif
+#if !defined(OSAL_MSG_POOL_LARGE_CNT)
+#define OSAL_MSG_POOL_LARGE_CNT     4
+#endif
+#define OSAL_MSG_POOL_NUM           3
+#endif
+#define OSAL_MSG_POOL_HEAP          0xFF    //消息头中pool_id的取值，表示消息来自堆
+
+extern void osal_msg_init(void);
 extern uint8 * osal_msg_allocate(uint16 len);
 extern uint8 osal_msg_deallocate(uint8 *msg_ptr);
 extern uint8 osal_msg_send(uint8 destination_task, uint8 *msg_ptr);
@@ -18,4 +47,10 @@ extern void *osal_msg_dequeue(osal_msg_q_t *q_ptr);
 extern void osal_msg_push(osal_msg_q_t *q_ptr, void *msg_ptr);
 extern void osal_msg_extract(osal_msg_q_t *q_ptr, void *msg_ptr, void *prev_ptr);
 
+#if OSAL_MSG_POOL
+extern uint16 osal_msg_pool_used(uint8 pool);
+extern uint16 osal_msg_pool_high_water(uint8 pool);
+extern uint16 osal_msg_pool_overflow(void);
+#endif
+
 #endif
@@ -1,10 +1,114 @@
 // osal_pt.c
-#include "osal_pt.h"
-#include "osal_memory.h"
+#include "osal.h"
+#include "osal_timer.h"
+#include <stdio.h>
 #include <string.h>
 
-// 全局调度器实例
-static osal_pt_scheduler_t g_pt_scheduler;
+#ifdef OSAL_PT_ENABLE
+#include "osal_pt.h"
+
+#if OSAL_PT_MAX > 32
+#error OSAL_PT_MAX must not exceed 32!
+#endif
+
+// 全局调度器实例，由osal_start_system()调度
+osal_pt_scheduler_t osal_pt_sched;
+
+// 协程控制块静态池
+static osal_pt_t ptPool[OSAL_PT_MAX];
+static uint32_t ptUsed; // 第n位表示ptPool[n]已分配
+
+// 取最低置位的位号
+#define PT_LOWEST_BIT(x) (31U - __CLZ((x) & (~(x) + 1U)))
+
+/**
+ * @brief 加入就绪队列尾部，调用者需关中断
+ */
+static void osalPtReadyPush(osal_pt_scheduler_t *sched, osal_pt_t *pt)
+{
+    pt->state = PT_STATE_READY;
+    pt->next = NULL;
+    if (sched->ready_tail)
+    {
+        sched->ready_tail->next = pt;
+    }
+    else
+    {
+        sched->ready_head = pt;
+    }
+    sched->ready_tail = pt;
+}
+
+/**
+ * @brief 从各事件等待表中移除，调用者需关中断
+ */
+static void osalPtUnwait(osal_pt_t *pt)
+{
+    uint32_t bit = 1UL << (pt->id - 1);
+    uint16_t events = pt->wait_events;
+
+    while (events)
+    {
+        pt->sched->wait_map[PT_LOWEST_BIT(events)] &= ~bit;
+        events &= events - 1;
+    }
+}
+
+/**
+ * @brief 置位事件，等待的事件到达时转入就绪队列，调用者需关中断
+ */
+static void osalPtTrigger(osal_pt_t *pt, uint16_t events)
+{
+    pt->triggered_events |= events;
+    if ((pt->state == PT_STATE_WAITING) && (pt->triggered_events & pt->wait_events))
+    {
+        osalPtUnwait(pt);
+        osalPtReadyPush(pt->sched, pt);
+    }
+}
+
+/**
+ * @brief 按唤醒时间插入延时队列，相同唤醒时间的按先后顺序排列
+ */
+static void osalPtSleep(osal_pt_scheduler_t *sched, osal_pt_t *pt)
+{
+    osal_pt_t **link = &sched->sleep_list;
+
+    while ((*link != NULL) && ((int32_t)(pt->wakeup_time - (*link)->wakeup_time) >= 0))
+    {
+        link = &(*link)->next;
+    }
+
+    pt->state = PT_STATE_WAITING;
+    pt->next = *link;
+    *link = pt;
+}
+
+/**
+ * @brief 协程阻塞在事件上：加入所等待事件的等待表，事件已到达则直接就绪
+ */
+static void osalPtWait(osal_pt_scheduler_t *sched, osal_pt_t *pt)
+{
+    halIntState_t intState;
+    uint32_t bit = 1UL << (pt->id - 1);
+    uint16_t events = pt->wait_events;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    if (pt->triggered_events & events)
+    {
+        osalPtReadyPush(sched, pt);
+    }
+    else
+    {
+        pt->state = PT_STATE_WAITING;
+        while (events)
+        {
+            sched->wait_map[PT_LOWEST_BIT(events)] |= bit;
+            events &= events - 1;
+        }
+    }
+    HAL_EXIT_CRITICAL_SECTION(intState);
+}
 
 /**
  * @brief 初始化协程调度器
@@ -14,49 +118,53 @@ void osal_pt_scheduler_init(osal_pt_scheduler_t *sched)
     if (sched == NULL)
         return;
 
-    sched->pt_list = NULL;
-    sched->current_pt = NULL;
-    sched->next_pt_id = 1;
-    sched->system_time = 0;
-
-    // 保存全局引用
-    if (sched != &g_pt_scheduler)
-    {
-        memcpy(&g_pt_scheduler, sched, sizeof(osal_pt_scheduler_t));
-    }
+    memset(sched, 0, sizeof(osal_pt_scheduler_t));
+    sched->system_time = osal_GetSystemClock();
 }
 
 /**
- * @brief 创建协程
+ * @brief 创建协程，控制块取自静态池
+ * @return 协程ID，静态池已满时返回0
  */
 uint8_t osal_pt_create(osal_pt_scheduler_t *sched,
                        char (*entry)(osal_pt_t *, void *),
                        void *arg,
                        const char *name)
 {
+    halIntState_t intState;
+    uint32_t freeSlots;
+    osal_pt_t *new_pt;
+
     if (sched == NULL || entry == NULL)
     {
         return 0;
     }
 
-    // 分配协程控制块（在实际项目中可能需要内存池管理）
-    osal_pt_t *new_pt = (osal_pt_t *)osal_mem_alloc(sizeof(osal_pt_t));
-    if (new_pt == NULL)
+    // 分配协程控制块
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    freeSlots = ~ptUsed;
+#if OSAL_PT_MAX < 32
+    freeSlots &= (1UL << OSAL_PT_MAX) - 1;
+#endif
+    if (freeSlots == 0)
     {
+        HAL_EXIT_CRITICAL_SECTION(intState);
         return 0;
     }
+    new_pt = &ptPool[PT_LOWEST_BIT(freeSlots)];
+    ptUsed |= freeSlots & (~freeSlots + 1U);
+    HAL_EXIT_CRITICAL_SECTION(intState);
 
     // 初始化协程
     PT_INIT(&new_pt->pt);
     new_pt->sched = sched;
-    new_pt->id = sched->next_pt_id++;
-    new_pt->state = PT_STATE_READY;
+    new_pt->id = (uint8_t)(new_pt - ptPool + 1);
+    new_pt->flags = 0;
     new_pt->wakeup_time = 0;
     new_pt->wait_events = 0;
     new_pt->triggered_events = 0;
     new_pt->entry = entry;
     new_pt->arg = arg;
-    new_pt->next = NULL;
 
     // 复制名称
     if (name != NULL)
@@ -69,114 +177,151 @@ uint8_t osal_pt_create(osal_pt_scheduler_t *sched,
         snprintf(new_pt->name, sizeof(new_pt->name), "pt%d", new_pt->id);
     }
 
-    // 添加到链表
-    new_pt->next = sched->pt_list;
-    sched->pt_list = new_pt;
+    // 加入就绪队列
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    osalPtReadyPush(sched, new_pt);
+    HAL_EXIT_CRITICAL_SECTION(intState);
 
     // printf("Protothread created: %s (ID: %d)\n", new_pt->name, new_pt->id);
     return new_pt->id;
 }
 
 /**
- * @brief 调度所有协程
+ * @brief 按协程ID取得控制块
+ * @return 控制块指针，ID无效或协程已退出时返回NULL
+ */
+osal_pt_t *osal_pt_get(uint8_t id)
+{
+    if ((id == 0) || (id > OSAL_PT_MAX) || !(ptUsed & (1UL << (id - 1))))
+    {
+        return NULL;
+    }
+
+    return &ptPool[id - 1];
+}
+
+/**
+ * @brief 调度协程：唤醒延时到期的协程，再依次运行本轮开始时就绪的协程。
+ *        等待延时或事件的协程不在就绪队列中，不会被访问。
  */
 void osal_pt_schedule(osal_pt_scheduler_t *sched)
 {
+    halIntState_t intState;
+    osal_pt_t *run;
+    osal_pt_t *pt;
+    char result;
+
     if (sched == NULL)
         return;
 
     // 更新系统时间
     sched->system_time = osal_GetSystemClock();
 
-    osal_pt_t *pt = sched->pt_list;
-    osal_pt_t *prev = NULL;
+    // 延时队列按唤醒时间排序，只需检查队首
+    while ((sched->sleep_list != NULL) &&
+           ((int32_t)(sched->system_time - sched->sleep_list->wakeup_time) >= 0))
+    {
+        pt = sched->sleep_list;
+        sched->sleep_list = pt->next;
+        pt->flags &= ~PT_FLAG_DELAY;
+
+        HAL_ENTER_CRITICAL_SECTION(intState);
+        osalPtReadyPush(sched, pt);
+        HAL_EXIT_CRITICAL_SECTION(intState);
+    }
+
+    // 取下本轮的就绪队列，本轮中重新就绪的协程留到下一轮
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    run = sched->ready_head;
+    sched->ready_head = NULL;
+    sched->ready_tail = NULL;
+    HAL_EXIT_CRITICAL_SECTION(intState);
 
-    while (pt != NULL)
+    while (run != NULL)
     {
-        // 检查协程是否可运行
-        uint8_t can_run = 0;
+        pt = run;
+        run = run->next;
 
-        switch (pt->state)
+        sched->current_pt = pt;
+        pt->state = PT_STATE_RUNNING;
+
+        // 执行协程
+        result = pt->entry(pt, pt->arg);
+
+        sched->current_pt = NULL;
+
+        if (result >= PT_EXITED)
         {
-        case PT_STATE_READY:
-            can_run = 1;
-            break;
-
-        case PT_STATE_WAITING:
-            // 检查事件是否触发或延时是否到期
-            if ((pt->wait_events && (pt->triggered_events & pt->wait_events)) ||
-                (pt->wakeup_time && sched->system_time >= pt->wakeup_time))
-            {
-                can_run = 1;
-            }
-            break;
-
-        case PT_STATE_EXITED:
-            // 移除已退出的协程
-            osal_pt_t *to_remove = pt;
-            if (prev)
-            {
-                prev->next = pt->next;
-            }
-            else
-            {
-                sched->pt_list = pt->next;
-            }
-            pt = pt->next;
-
-            // printf("Protothread removed: %s\n", to_remove->name);
-            osal_mem_free(to_remove);
-            continue;
-
-        default:
-            break;
+            // 协程退出，控制块归还静态池
+            pt->state = PT_STATE_EXITED;
+            HAL_ENTER_CRITICAL_SECTION(intState);
+            ptUsed &= ~(1UL << (pt->id - 1));
+            HAL_EXIT_CRITICAL_SECTION(intState);
+            // printf("Protothread removed: %s\n", pt->name);
         }
-
-        if (can_run)
+        else if (pt->flags & PT_FLAG_DELAY)
         {
-            sched->current_pt = pt;
-            pt->state = PT_STATE_RUNNING;
-
-            // 执行协程
-            char result = pt->entry(pt, pt->arg);
-
-            if (result == 0)
-            {
-                // 协程主动让出
-                pt->state = PT_STATE_WAITING;
-            }
-            else if (result == 2)
-            {
-                // 协程退出
-                pt->state = PT_STATE_EXITED;
-            }
-            else
-            {
-                // 协程执行完成本次时间片
-                pt->state = PT_STATE_READY;
-            }
-
-            sched->current_pt = NULL;
+            // 等待延时
+            osalPtSleep(sched, pt);
+        }
+        else if (pt->wait_events)
+        {
+            // 等待事件
+            osalPtWait(sched, pt);
+        }
+        else
+        {
+            // 协程让出或等待其他条件，下一轮继续运行
+            HAL_ENTER_CRITICAL_SECTION(intState);
+            osalPtReadyPush(sched, pt);
+            HAL_EXIT_CRITICAL_SECTION(intState);
         }
-
-        prev = pt;
-        pt = pt->next;
     }
 }
 
 /**
- * @brief 设置协程事件
+ * @brief 设置协程事件，可在中断中调用
  */
 void osal_pt_set_event(osal_pt_t *pt, uint16_t events)
 {
+    halIntState_t intState;
+
     if (pt == NULL)
         return;
 
-    pt->triggered_events |= events;
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    osalPtTrigger(pt, events);
+    HAL_EXIT_CRITICAL_SECTION(intState);
 }
 
 /**
- * @brief 协程延时
+ * @brief 向所有正在等待events中任一事件的协程发送事件，可在中断中调用
+ */
+void osal_pt_broadcast(osal_pt_scheduler_t *sched, uint16_t events)
+{
+    halIntState_t intState;
+    uint32_t waiting = 0;
+    uint16_t bits = events;
+
+    if (sched == NULL)
+        return;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    while (bits)
+    {
+        waiting |= sched->wait_map[PT_LOWEST_BIT(bits)];
+        bits &= bits - 1;
+    }
+    while (waiting)
+    {
+        osalPtTrigger(&ptPool[PT_LOWEST_BIT(waiting)], events);
+        waiting &= waiting - 1;
+    }
+    HAL_EXIT_CRITICAL_SECTION(intState);
+}
+
+/**
+ * @brief 协程延时，协程返回后由调度器放入延时队列
  */
 void osal_pt_delay(osal_pt_t *pt, uint32_t ms)
 {
@@ -184,6 +329,7 @@ void osal_pt_delay(osal_pt_t *pt, uint32_t ms)
         return;
 
     pt->wakeup_time = pt->sched->system_time + ms;
+    pt->flags |= PT_FLAG_DELAY;
 }
 
 /**
@@ -191,16 +337,50 @@ void osal_pt_delay(osal_pt_t *pt, uint32_t ms)
  */
 uint8_t osal_pt_wait_event(osal_pt_t *pt, uint16_t event_mask)
 {
+    halIntState_t intState;
+
     if (pt == NULL)
         return 0;
 
+    HAL_ENTER_CRITICAL_SECTION(intState);
     pt->wait_events = event_mask;
     if (pt->triggered_events & event_mask)
     {
         pt->triggered_events &= ~event_mask;
         pt->wait_events = 0;
+        HAL_EXIT_CRITICAL_SECTION(intState);
         return 1; // 事件已就绪
     }
+    HAL_EXIT_CRITICAL_SECTION(intState);
 
     return 0; // 需要等待
-}
\ No newline at end of file
+}
+
+/**
+ * @brief 是否有就绪的协程，有则主循环不能睡眠
+ */
+uint8_t osal_pt_ready(osal_pt_scheduler_t *sched)
+{
+    return (sched->ready_head != NULL) ||
+           ((sched->sleep_list != NULL) &&
+            ((int32_t)(osal_GetSystemClock() - sched->sleep_list->wakeup_time) >= 0));
+}
+
+/**
+ * @brief 距最早的协程延时到期还有多少毫秒，供无滴答模式决定睡眠时长
+ * @return 毫秒数，已到期时返回1，没有延时中的协程时返回0
+ */
+uint32_t osal_pt_next_timeout(osal_pt_scheduler_t *sched)
+{
+    int32_t remain;
+
+    if (sched->sleep_list == NULL)
+    {
+        return 0;
+    }
+
+    remain = (int32_t)(sched->sleep_list->wakeup_time - osal_GetSystemClock());
+    return (remain > 0) ? (uint32_t)remain : 1;
+}
+
+#endif
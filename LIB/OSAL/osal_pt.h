@@ -6,6 +6,10 @@
 #include "type.h"
 #include "osal_event.h"
 
+#if !defined(OSAL_PT_MAX)
+#define OSAL_PT_MAX 8 // 协程控制块静态池大小，最大32
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -14,12 +18,14 @@ extern "C"
     // 协程状态定义
     typedef enum
     {
-        PT_STATE_READY = 0, // 就绪
+        PT_STATE_READY = 0, // 就绪，在就绪队列中
         PT_STATE_RUNNING,   // 运行中
-        PT_STATE_WAITING,   // 等待中
-        PT_STATE_EXITED     // 已退出
+        PT_STATE_WAITING,   // 等待中，在延时队列或事件等待表中
+        PT_STATE_EXITED     // 已退出，控制块已归还静态池
     } pt_state_t;
 
+#define PT_FLAG_DELAY 0x01 // 协程在延时队列中，到期后由调度器清除
+
     // 协程调度器前向声明
     typedef struct osal_pt_scheduler osal_pt_scheduler_t;
 
@@ -27,8 +33,9 @@ extern "C"
     typedef struct osal_pt
     {
         pt_t pt;                   // protothread上下文
-        uint8_t id;                // 协程ID
+        uint8_t id;                // 协程ID，即静态池下标加1
         uint8_t state;             // 状态
+        uint8_t flags;             // PT_FLAG_xxx
         uint32_t wakeup_time;      // 唤醒时间（用于延时）
         uint16_t wait_events;      // 等待的事件掩码
         uint16_t triggered_events; // 已触发的事件
@@ -38,18 +45,22 @@ extern "C"
         char (*entry)(struct osal_pt *pt, void *arg);
         void *arg; // 参数
 
-        struct osal_pt *next;       // 链表指针
+        struct osal_pt *next;       // 就绪队列或延时队列指针
         osal_pt_scheduler_t *sched; // 所属调度器
     } osal_pt_t;
 
     // 协程调度器
-    typedef struct
+    struct osal_pt_scheduler
     {
-        osal_pt_t *pt_list;    // 协程链表
+        osal_pt_t *ready_head; // 就绪队列(先进先出)
+        osal_pt_t *ready_tail;
+        osal_pt_t *sleep_list; // 延时队列，按唤醒时间升序排列
         osal_pt_t *current_pt; // 当前运行的协程
-        uint8_t next_pt_id;    // 下一个协程ID
+        uint32_t wait_map[16]; // 每个事件位一张等待表，第n位表示静态池中第n个协程在等待该事件
         uint32_t system_time;  // 系统时间
-    } osal_pt_scheduler_t;
+    };
+
+    extern osal_pt_scheduler_t osal_pt_sched; // osal_start_system()调度的协程调度器
 
     // API函数
     void osal_pt_scheduler_init(osal_pt_scheduler_t *sched);
@@ -57,10 +68,14 @@ extern "C"
                            char (*entry)(osal_pt_t *, void *),
                            void *arg,
                            const char *name);
+    osal_pt_t *osal_pt_get(uint8_t id);
     void osal_pt_schedule(osal_pt_scheduler_t *sched);
     void osal_pt_set_event(osal_pt_t *pt, uint16_t events);
+    void osal_pt_broadcast(osal_pt_scheduler_t *sched, uint16_t events);
     void osal_pt_delay(osal_pt_t *pt, uint32_t ms);
     uint8_t osal_pt_wait_event(osal_pt_t *pt, uint16_t event_mask);
+    uint8_t osal_pt_ready(osal_pt_scheduler_t *sched);
+    uint32_t osal_pt_next_timeout(osal_pt_scheduler_t *sched);
 
 // 简化宏定义
 #define PT_BEGIN_WRAPPER(pt) PT_BEGIN(&(pt)->pt)
@@ -68,7 +83,7 @@ extern "C"
 #define PT_YIELD_WRAPPER(pt) PT_YIELD(&(pt)->pt)
 #define PT_WAIT_UNTIL_WRAPPER(pt, cond) PT_WAIT_UNTIL(&(pt)->pt, cond)
 
-// 等待事件宏
+// 等待事件宏，协程挂在事件等待表中，事件到达前不会被调度
 #define PT_WAIT_EVENT(pt, event_mask)                                           \
     do                                                                          \
     {                                                                           \
@@ -78,16 +93,16 @@ extern "C"
         (pt)->wait_events = 0;                                                  \
     } while (0)
 
-// 延时宏
-#define PT_DELAY(pt, ms)                                                         \
-    do                                                                           \
-    {                                                                            \
-        (pt)->wakeup_time = (pt)->sched->system_time + (ms);                     \
-        PT_WAIT_UNTIL(&(pt)->pt, (pt)->sched->system_time >= (pt)->wakeup_time); \
+// 延时宏，协程挂在延时队列中，到期前不会被调度
+#define PT_DELAY(pt, ms)                                             \
+    do                                                               \
+    {                                                                \
+        osal_pt_delay((pt), (ms));                                   \
+        PT_WAIT_UNTIL(&(pt)->pt, !((pt)->flags & PT_FLAG_DELAY));    \
     } while (0)
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif /* OSAL_PT_H */
\ No newline at end of file
+#endif /* OSAL_PT_H */
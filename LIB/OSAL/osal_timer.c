@@ -1,21 +1,43 @@
 #include "osal_timer.h"
 #include "osal_memory.h"
 #include "osal_event.h"
+#include "osal.h"
+#include "osal_deadline.h"
 #include "type.h"
 
-typedef struct
+typedef struct osalTimerRec
 {
-    void *next;
+    struct osalTimerRec *next;
+#if OSAL_TIMER_WHEEL
+    struct osalTimerRec **pprev; // 指向上一节点next域(或槽头)的指针，用于O(1)摘除
+    struct osalTimerRec *hnext;  // 查找散列表中的下一节点
+    uint32 expires;              // 到期时刻(时间轮绝对刻度)
+#else
     uint16 timeout;       // 定时时间，每过一个系统时钟会自减
+#endif
     uint16 event_flag;    // 定时事件，定时时间减完产生任务事件
     uint8 task_id;        // 响应的任务ID
     uint16 reloadTimeout; // 重装定时时间
 } osalTimerRec_t;         // 任务定时器，链表结构
 
+#if OSAL_TIMER_WHEEL
+#define OSAL_TW_SLOTS (1 << OSAL_TW_LEVEL_BITS)                               // 每层槽数
+#define OSAL_TW_MASK (OSAL_TW_SLOTS - 1)                                       // 槽索引掩码
+#define OSAL_TW_RANGE ((uint32)1 << (OSAL_TW_LEVEL_BITS * OSAL_TW_LEVELS))     // 时间轮可直接表示的最大跨度
+#define OSAL_TW_HASH(task_id, event_flag) \
+    (((task_id) ^ (event_flag) ^ ((event_flag) >> 8)) & (OSAL_TW_HASH_SIZE - 1))
+
+#if (OSAL_TW_HASH_SIZE & (OSAL_TW_HASH_SIZE - 1))
+#error OSAL_TW_HASH_SIZE must be a power of two!
+#endif
+#endif
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
+#if !OSAL_TIMER_WHEEL
 osalTimerRec_t *timerHead; // 任务定时器链表头指针
+#endif
 uint8 tmr_decr_time;       // 任务定时器更新时自减的数值单位
 uint8 timerActive;         // 标识硬件定时器是否运行
 
@@ -24,6 +46,13 @@ uint8 timerActive;         // 标识硬件定时器是否运行
  */
 static uint32 osal_systemClock; // 记录系统时钟
 
+#if OSAL_TIMER_WHEEL
+static osalTimerRec_t *twSlots[OSAL_TW_LEVELS][OSAL_TW_SLOTS]; // 各层时间轮槽
+static osalTimerRec_t *twHash[OSAL_TW_HASH_SIZE];              // (任务ID, 事件)查找散列表
+static uint32 twNow;                                           // 时间轮当前刻度
+static uint8 twCount;                                          // 活动定时器数量
+#endif
+
 /*********************************************************************
  * LOCAL FUNCTION PROTOTYPES
  */
@@ -57,8 +86,21 @@ void osalTimerInit(void)
     timerActive = FALSE;
 
     osal_systemClock = 0;
+
+#if OSAL_TIMER_WHEEL
+    // 清空时间轮与查找表
+    osal_memset(twSlots, 0, sizeof(twSlots));
+    osal_memset(twHash, 0, sizeof(twHash));
+    twNow = 0;
+    twCount = 0;
+#endif
+
+#if OSAL_DEADLINE_TIMER
+    osal_deadline_init();
+#endif
 }
 
+#if !OSAL_TIMER_WHEEL
 /*********************************************************************
  * @fn osalAddTimer
  *
@@ -175,6 +217,349 @@ void osalDeleteTimer(osalTimerRec_t *rmTimer)
     }
 }
 
+#else /* OSAL_TIMER_WHEEL */
+/*********************************************************************
+ * @fn osalWheelLink
+ *
+ * @brief   按到期时刻把定时器挂入对应层的时间轮槽。
+ *          距到期不足一圈的放入第0层，否则按跨度放入更高层，
+ *          超出时间轮总跨度的先放入最高层最远的槽，下放时重新计算。
+ *          调用此函数前必须关闭中断。
+ *
+ * @param   tmr  定时器指针
+ *
+ * @return  none
+ */
+static void osalWheelLink(osalTimerRec_t *tmr)
+{
+    osalTimerRec_t **slot;
+    uint32 delta = tmr->expires - twNow;
+    uint32 when = tmr->expires;
+    uint8 level = 0;
+
+    if (delta >= OSAL_TW_RANGE)
+    {
+        delta = OSAL_TW_RANGE - 1;
+        when = twNow + delta;
+    }
+
+    while (delta >= ((uint32)OSAL_TW_SLOTS << (level * OSAL_TW_LEVEL_BITS)))
+    {
+        level++;
+    }
+
+    slot = &twSlots[level][(when >> (level * OSAL_TW_LEVEL_BITS)) & OSAL_TW_MASK];
+
+    tmr->next = *slot;
+    if (tmr->next)
+    {
+        tmr->next->pprev = &tmr->next;
+    }
+    tmr->pprev = slot;
+    *slot = tmr;
+}
+
+/*********************************************************************
+ * @fn osalWheelUnlink
+ *
+ * @brief   把定时器从所在的时间轮槽中摘除。
+ *          调用此函数前必须关闭中断。
+ *
+ * @param   tmr  定时器指针
+ *
+ * @return  none
+ */
+static void osalWheelUnlink(osalTimerRec_t *tmr)
+{
+    if (tmr->pprev)
+    {
+        *tmr->pprev = tmr->next;
+        if (tmr->next)
+        {
+            tmr->next->pprev = tmr->pprev;
+        }
+        tmr->next = NULL;
+        tmr->pprev = NULL;
+    }
+}
+
+/*********************************************************************
+ * @fn osalWheelCascade
+ *
+ * @brief   高层时间轮转到新槽时，把该槽中的定时器重新下放到低层。
+ *          调用此函数前必须关闭中断。
+ *
+ * @param   level  时间轮层号(>=1)
+ *
+ * @return  none
+ */
+static void osalWheelCascade(uint8 level)
+{
+    osalTimerRec_t **slot;
+    osalTimerRec_t *tmr;
+    osalTimerRec_t *next;
+
+    slot = &twSlots[level][(twNow >> (level * OSAL_TW_LEVEL_BITS)) & OSAL_TW_MASK];
+    tmr = *slot;
+    *slot = NULL;
+
+    while (tmr)
+    {
+        next = tmr->next;
+        osalWheelLink(tmr);
+        tmr = next;
+    }
+}
+
+/*********************************************************************
+ * @fn osalWheelNext
+ *
+ * @brief   计算距时间轮下一次需要处理(定时器到期或高层下放)的滴答数。
+ *          高层槽只能给出下放时刻，它不晚于槽内定时器的实际到期时刻。
+ *          调用此函数前必须关闭中断。
+ *
+ * @param   none
+ *
+ * @return  距下一次处理的滴答数，没有定时器时返回0
+ */
+static uint32 osalWheelNext(void)
+{
+    uint32 best = 0;
+    uint32 base;
+    uint32 dist;
+    uint16 i;
+    uint8 level;
+
+    if (twCount == 0)
+    {
+        return 0;
+    }
+
+    // 第0层当前槽已处理过，从下一个槽开始查找
+    for (i = 1; i < OSAL_TW_SLOTS; i++)
+    {
+        if (twSlots[0][(twNow + i) & OSAL_TW_MASK])
+        {
+            best = i;
+            break;
+        }
+    }
+
+    for (level = 1; level < OSAL_TW_LEVELS; level++)
+    {
+        base = twNow >> (level * OSAL_TW_LEVEL_BITS);
+        for (i = 1; i <= OSAL_TW_SLOTS; i++)
+        {
+            if (twSlots[level][(base + i) & OSAL_TW_MASK])
+            {
+                dist = ((base + i) << (level * OSAL_TW_LEVEL_BITS)) - twNow;
+                if ((best == 0) || (dist < best))
+                {
+                    best = dist;
+                }
+                break;
+            }
+        }
+    }
+
+    return best;
+}
+
+/*********************************************************************
+ * @fn osalWheelTick
+ *
+ * @brief   时间轮前进一格，并处理当前槽中所有到期的定时器。
+ *          每次只在关中断状态下摘除一个定时器，
+ *          事件通知与内存释放在开中断后进行。
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void osalWheelTick(void)
+{
+    halIntState_t intState;
+    osalTimerRec_t *tmr;
+    osalTimerRec_t *freeTimer;
+    uint16 event_flag;
+    uint8 task_id;
+    uint8 level = 1;
+
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
+
+    twNow++;
+
+    // 低层转完一圈时，由高到低依次下放
+    while ((level < OSAL_TW_LEVELS) &&
+           ((twNow & (((uint32)1 << (level * OSAL_TW_LEVEL_BITS)) - 1)) == 0))
+    {
+        level++;
+    }
+    while (--level > 0)
+    {
+        osalWheelCascade(level);
+    }
+
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+
+    while (1)
+    {
+        freeTimer = NULL;
+
+        HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
+
+        tmr = twSlots[0][twNow & OSAL_TW_MASK];
+        if (tmr == NULL)
+        {
+            HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+            break;
+        }
+
+        osalWheelUnlink(tmr);
+        task_id = tmr->task_id;
+        event_flag = tmr->event_flag;
+
+        if (tmr->reloadTimeout)
+        {
+            // 重载定时器超时值
+            tmr->expires = twNow + tmr->reloadTimeout;
+            osalWheelLink(tmr);
+        }
+        else
+        {
+            osalDeleteTimer(tmr);
+            freeTimer = tmr;
+        }
+
+        HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+
+        // 通知任务超时
+        osal_set_event(task_id, event_flag);
+
+        if (freeTimer)
+        {
+            osal_mem_free(freeTimer);
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn osalAddTimer
+ *
+ * @brief   向时间轮中添加一个定时器，已存在则重新设定其到期时刻。
+ *          调用此函数前必须关闭中断。
+ *
+ * @param   task_id      任务ID
+ * @param   event_flag   事件标志
+ * @param   timeout      超时时间(毫秒)
+ *
+ * @return  osalTimerRec_t * - 指向新创建定时器的指针
+ */
+osalTimerRec_t *osalAddTimer(uint8 task_id, uint16 event_flag, uint16 timeout)
+{
+    osalTimerRec_t *newTimer;
+    osalTimerRec_t **bucket;
+
+    // 先查找是否已存在相同定时器
+    newTimer = osalFindTimer(task_id, event_flag);
+    if (newTimer)
+    {
+        osalWheelUnlink(newTimer);
+    }
+    else
+    {
+        // 创建新的定时器
+        newTimer = osal_mem_alloc(sizeof(osalTimerRec_t));
+        if (newTimer == NULL)
+        {
+            return ((osalTimerRec_t *)NULL);
+        }
+
+        // 填充新定时器信息
+        newTimer->task_id = task_id;
+        newTimer->event_flag = event_flag;
+        newTimer->reloadTimeout = 0;
+        newTimer->next = NULL;
+        newTimer->pprev = NULL;
+
+        // 加入查找散列表
+        bucket = &twHash[OSAL_TW_HASH(task_id, event_flag)];
+        newTimer->hnext = *bucket;
+        *bucket = newTimer;
+        twCount++;
+    }
+
+    // 与链表实现一致，超时时间为0时在下一个滴答到期
+    newTimer->expires = twNow + (timeout ? timeout : 1);
+    osalWheelLink(newTimer);
+
+    return (newTimer);
+}
+
+/*********************************************************************
+ * @fn osalFindTimer
+ *
+ * @brief   在查找散列表中查找指定定时器。
+ *          调用此函数前必须关闭中断。
+ *
+ * @param   task_id      任务ID
+ * @param   event_flag   事件标志
+ *
+ * @return  osalTimerRec_t *
+ */
+osalTimerRec_t *osalFindTimer(uint8 task_id, uint16 event_flag)
+{
+    osalTimerRec_t *srchTimer;
+
+    srchTimer = twHash[OSAL_TW_HASH(task_id, event_flag)];
+
+    while (srchTimer)
+    {
+        if (srchTimer->event_flag == event_flag &&
+            srchTimer->task_id == task_id)
+            break;
+
+        srchTimer = srchTimer->hnext;
+    }
+
+    return (srchTimer);
+}
+
+/*********************************************************************
+ * @fn osalDeleteTimer
+ *
+ * @brief   把定时器从时间轮和查找散列表中立即摘除，
+ *          内存由调用者在开中断后释放。
+ *          调用此函数前必须关闭中断。
+ *
+ * @param   rmTimer  要删除的定时器指针
+ *
+ * @return  none
+ */
+void osalDeleteTimer(osalTimerRec_t *rmTimer)
+{
+    osalTimerRec_t **bucket;
+
+    // 检查定时器是否存在
+    if (rmTimer)
+    {
+        osalWheelUnlink(rmTimer);
+
+        bucket = &twHash[OSAL_TW_HASH(rmTimer->task_id, rmTimer->event_flag)];
+        while (*bucket && *bucket != rmTimer)
+        {
+            bucket = &(*bucket)->hnext;
+        }
+        if (*bucket)
+        {
+            *bucket = rmTimer->hnext;
+            twCount--;
+        }
+        rmTimer->hnext = NULL;
+    }
+}
+#endif /* OSAL_TIMER_WHEEL */
+
 /*********************************************************************
  * @fn osal_timer_activate
  *
@@ -231,9 +616,10 @@ void osal_timer_hw_setup(uint8 turn_on)
  */
 uint8 osal_start_timerEx(uint8 taskID, uint16 event_id, uint16 timeout_value)
 {
+    halIntState_t intState;
     osalTimerRec_t *newTimer;
 
-    HAL_ENTER_CRITICAL_SECTION(); // 关闭中断
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
 
     // 添加定时器
     newTimer = osalAddTimer(taskID, event_id, timeout_value);
@@ -247,7 +633,7 @@ uint8 osal_start_timerEx(uint8 taskID, uint16 event_id, uint16 timeout_value)
         }
     }
 
-    HAL_EXIT_CRITICAL_SECTION(); // 重新开启中断
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
 
     return ((newTimer != NULL) ? SUCCESS : NO_TIMER_AVAIL);
 }
@@ -268,9 +654,10 @@ uint8 osal_start_timerEx(uint8 taskID, uint16 event_id, uint16 timeout_value)
  */
 uint8 osal_start_reload_timer(uint8 taskID, uint16 event_id, uint16 timeout_value)
 {
+    halIntState_t intState;
     osalTimerRec_t *newTimer;
 
-    HAL_ENTER_CRITICAL_SECTION(); // 关闭中断
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
 
     // 添加定时器
     newTimer = osalAddTimer(taskID, event_id, timeout_value);
@@ -289,7 +676,7 @@ uint8 osal_start_reload_timer(uint8 taskID, uint16 event_id, uint16 timeout_valu
         }
     }
 
-    HAL_EXIT_CRITICAL_SECTION(); // 重新开启中断
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
 
     return ((newTimer != NULL) ? SUCCESS : NO_TIMER_AVAIL);
 }
@@ -309,9 +696,10 @@ uint8 osal_start_reload_timer(uint8 taskID, uint16 event_id, uint16 timeout_valu
  */
 uint8 osal_stop_timerEx(uint8 task_id, uint16 event_id)
 {
+    halIntState_t intState;
     osalTimerRec_t *foundTimer;
 
-    HAL_ENTER_CRITICAL_SECTION(); // 关闭中断
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
 
     // 查找要停止的定时器
     foundTimer = osalFindTimer(task_id, event_id);
@@ -320,7 +708,15 @@ uint8 osal_stop_timerEx(uint8 task_id, uint16 event_id)
         osalDeleteTimer(foundTimer);
     }
 
-    HAL_EXIT_CRITICAL_SECTION(); // 重新开启中断
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+
+#if OSAL_TIMER_WHEEL
+    // 时间轮中的定时器已被立即摘除，在开中断后释放
+    if (foundTimer)
+    {
+        osal_mem_free(foundTimer);
+    }
+#endif
 
     return ((foundTimer != NULL) ? SUCCESS : INVALID_EVENT_ID);
 }
@@ -339,19 +735,24 @@ uint8 osal_stop_timerEx(uint8 task_id, uint16 event_id)
  */
 uint16 osal_get_timeoutEx(uint8 task_id, uint16 event_id)
 {
+    halIntState_t intState;
     uint16 rtrn = 0;
     osalTimerRec_t *tmr;
 
-    HAL_ENTER_CRITICAL_SECTION(); // 关闭中断
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
 
     tmr = osalFindTimer(task_id, event_id);
 
     if (tmr)
     {
+#if OSAL_TIMER_WHEEL
+        rtrn = (uint16)(tmr->expires - twNow);
+#else
         rtrn = tmr->timeout;
+#endif
     }
 
-    HAL_EXIT_CRITICAL_SECTION(); // 重新开启中断
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
 
     return rtrn;
 }
@@ -367,10 +768,14 @@ uint16 osal_get_timeoutEx(uint8 task_id, uint16 event_id)
  */
 uint8 osal_timer_num_active(void)
 {
+#if OSAL_TIMER_WHEEL
+    return twCount;
+#else
+    halIntState_t intState;
     uint8 num_timers = 0;
     osalTimerRec_t *srchTimer;
 
-    HAL_ENTER_CRITICAL_SECTION(); // 关闭中断
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
 
     // 从链表头开始
     srchTimer = timerHead;
@@ -382,9 +787,10 @@ uint8 osal_timer_num_active(void)
         srchTimer = srchTimer->next;
     }
 
-    HAL_EXIT_CRITICAL_SECTION(); // 重新开启中断
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
 
     return num_timers;
+#endif
 }
 
 /*********************************************************************
@@ -396,15 +802,53 @@ uint8 osal_timer_num_active(void)
  *
  * @return  none
  *********************************************************************/
+#if OSAL_TIMER_WHEEL
+void osalTimerUpdate(uint16 updateTime)
+{
+    halIntState_t intState;
+    uint32 next;
+
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
+    // 更新系统时间
+    osal_systemClock += updateTime;
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+
+    // 每个滴答只处理当前槽，耗时与定时器总数无关
+    while (updateTime)
+    {
+        // 一次补偿多个滴答时(如无滴答睡眠后)，直接跳过中间无需处理的滴答
+        if (updateTime > 1)
+        {
+            HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
+            next = osalWheelNext();
+            if ((next == 0) || (next > updateTime))
+            {
+                next = updateTime;
+            }
+            twNow += next - 1;
+            updateTime -= (uint16)(next - 1);
+            HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+        }
+
+        osalWheelTick();
+        updateTime--;
+    }
+
+#if OSAL_DEADLINE_TIMER
+    osal_deadline_update();
+#endif
+}
+#else
 void osalTimerUpdate(uint16 updateTime)
 {
+    halIntState_t intState;
     osalTimerRec_t *srchTimer;
     osalTimerRec_t *prevTimer;
 
-    HAL_ENTER_CRITICAL_SECTION(); // 关闭中断
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
     // 更新系统时间
     osal_systemClock += updateTime;
-    HAL_EXIT_CRITICAL_SECTION(); // 重新开启中断
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
 
     // 检查定时器链表是否存在
     if (timerHead != NULL)
@@ -417,11 +861,14 @@ void osalTimerUpdate(uint16 updateTime)
         while (srchTimer)
         {
             osalTimerRec_t *freeTimer = NULL;
+            uint16 overrun = 0;
 
-            HAL_ENTER_CRITICAL_SECTION(); // 关闭中断
+            HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
 
             if (srchTimer->timeout <= updateTime)
             {
+                // 一次补偿多个滴答时(如无滴答睡眠后)，记下超过到期时刻的时间
+                overrun = updateTime - srchTimer->timeout;
                 srchTimer->timeout = 0;
             }
             else
@@ -435,8 +882,8 @@ void osalTimerUpdate(uint16 updateTime)
                 // 通知任务超时
                 osal_set_event(srchTimer->task_id, srchTimer->event_flag);
 
-                // 重载定时器超时值
-                srchTimer->timeout = srchTimer->reloadTimeout;
+                // 重载定时器超时值，扣除超过的时间，周期不随补偿漂移
+                srchTimer->timeout = srchTimer->reloadTimeout - (overrun % srchTimer->reloadTimeout);
             }
 
             // 当超时或被删除(event_flag == 0)
@@ -461,7 +908,7 @@ void osalTimerUpdate(uint16 updateTime)
                 srchTimer = srchTimer->next;
             }
 
-            HAL_EXIT_CRITICAL_SECTION(); // 重新开启中断
+            HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
 
             if (freeTimer)
             {
@@ -473,7 +920,127 @@ void osalTimerUpdate(uint16 updateTime)
             }
         }
     }
+
+#if OSAL_DEADLINE_TIMER
+    osal_deadline_update();
+#endif
+}
+#endif
+
+/*********************************************************************
+ * @fn osal_next_timeout
+ *
+ * @brief   计算距下一个定时器到期还有多少毫秒，供无滴答模式决定睡眠时长。
+ *
+ * @param   none
+ *
+ * @return  距下一个定时器到期的毫秒数，没有活动定时器时返回0
+ */
+uint32 osal_next_timeout(void)
+{
+    halIntState_t intState;
+    uint32 next = 0;
+#if !OSAL_TIMER_WHEEL
+    osalTimerRec_t *srchTimer;
+#endif
+#if OSAL_DEADLINE_TIMER
+    uint32 dlNext;
+#endif
+
+    HAL_ENTER_CRITICAL_SECTION(intState); // 关闭中断
+
+#if OSAL_TIMER_WHEEL
+    next = osalWheelNext();
+#else
+    for (srchTimer = timerHead; srchTimer != NULL; srchTimer = srchTimer->next)
+    {
+        // 跳过已删除的定时器，超时时间为0的在下一个滴答到期
+        if (srchTimer->event_flag)
+        {
+            uint32 timeout = srchTimer->timeout ? srchTimer->timeout : 1;
+            if ((next == 0) || (timeout < next))
+            {
+                next = timeout;
+            }
+        }
+    }
+#endif
+
+    HAL_EXIT_CRITICAL_SECTION(intState); // 重新开启中断
+
+#if OSAL_DEADLINE_TIMER
+    // 同时考虑绝对时刻定时器
+    dlNext = osal_deadline_next_timeout();
+    if ((dlNext != 0) && ((next == 0) || (dlNext < next)))
+    {
+        next = dlNext;
+    }
+#endif
+
+    return next;
+}
+
+#if OSAL_TICKLESS
+/*********************************************************************
+ * @fn osal_timer_idle
+ *
+ * @brief   无滴答空闲处理，由osal_start_system()在没有就绪任务时调用。
+ *          停止周期滴答，按最近的定时器到期时间编程单次定时后睡眠，
+ *          被定时器或其他中断唤醒后一次性补偿睡眠期间经过的时间。
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_timer_idle(void)
+{
+    halIntState_t intState;
+    uint32 next;
+    uint32 elapsed = 0;
+
+    // 用PRIMASK关闭全部中断：BASEPRI屏蔽的中断无法唤醒WFI
+    HAL_ENTER_CRITICAL_SECTION_ALL(intState);
+
+    // 关中断后再次确认没有就绪任务，避免漏掉刚由中断置位的事件
+#ifdef OSAL_PT_ENABLE
+    if ((osalNextActiveTask() == NULL) && !osal_pt_ready(&osal_pt_sched))
+    {
+        uint32 ptNext = osal_pt_next_timeout(&osal_pt_sched);
+
+        next = osal_next_timeout();
+        // 同时按最早的协程延时到期时间唤醒
+        if ((ptNext != 0) && ((next == 0) || (ptNext < next)))
+        {
+            next = ptNext;
+        }
+#else
+    if (osalNextActiveTask() == NULL)
+    {
+        next = osal_next_timeout();
+#endif
+        if (next == 1)
+        {
+            // 下一个滴答就到期，不必重新编程定时器
+            OSAL_TIMER_SLEEP();
+        }
+        else
+        {
+            OSAL_TIMER_ONESHOT(next);
+            OSAL_TIMER_SLEEP();
+            elapsed = OSAL_TIMER_RESUME();
+        }
+    }
+
+    // 补偿必须在关中断状态下完成：滴答恢复后SysTick中断同样调用osalTimerUpdate()，
+    // 两者交错执行会破坏定时器链表或时间轮
+    if (elapsed)
+    {
+        osalTimerUpdate((uint16)elapsed);
+    }
+
+    HAL_EXIT_CRITICAL_SECTION_ALL(intState); // 重新开启中断，挂起的中断在此处执行
 }
+#endif
 
 /*********************************************************************
  * @fn osal_GetSystemClock()
@@ -6,6 +6,26 @@
 
 #define TIMER_DECR_TIME       	1 	//任务定时器更新时自减的数值单位
 
+#if !defined(OSAL_TIMER_WHEEL)
+#define OSAL_TIMER_WHEEL        0   //定义为1则使用分层时间轮管理定时器，启停与到期均为O(1)，滴答耗时与定时器数量无关
+#endif
+
+#if !defined(OSAL_TICKLESS)
+#define OSAL_TICKLESS           0   //定义为1则开启无滴答模式，空闲时按最近的定时器到期时间单次定时并睡眠
+#endif
+
+#if OSAL_TIMER_WHEEL
+#if !defined(OSAL_TW_LEVEL_BITS)
+#define OSAL_TW_LEVEL_BITS      6   //每层时间轮槽数的位数，6即每层64个槽
+#endif
+#if !defined(OSAL_TW_LEVELS)
+#define OSAL_TW_LEVELS          3   //时间轮层数，64*64*64个滴答覆盖16位超时时间
+#endif
+#if !defined(OSAL_TW_HASH_SIZE)
+#define OSAL_TW_HASH_SIZE       16  //(任务ID, 事件)查找散列表大小，必须为2的幂
+#endif
+#endif
+
 extern void osalTimerInit(void);
 extern uint8 osal_start_timerEx(uint8 task_id, uint16 event_id, uint16 timeout_value);
 extern uint8 osal_start_reload_timer(uint8 taskID, uint16 event_id, uint16 timeout_value);
@@ -14,5 +34,10 @@ extern uint16 osal_get_timeoutEx(uint8 task_id, uint16 event_id);
 extern uint8 osal_timer_num_active(void);
 extern uint32 osal_GetSystemClock(void);
 extern void osal_update_timers(void);
+extern void osalTimerUpdate(uint16 updateTime);
+extern uint32 osal_next_timeout(void);
+#if OSAL_TICKLESS
+extern void osal_timer_idle(void);
+#endif
 
 #endif
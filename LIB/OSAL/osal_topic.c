@@ -0,0 +1,268 @@
+/****************************************************************************************
+ * 文件名  ：osal_topic.c
+ * 描述    ：主题发布/订阅，发布者把样本写入主题槽位一次，所有订阅任务收到事件后直接读取槽位，
+ *           每增加一个消费者不再增加一次复制
+ * 说明    ：每个主题只能有一个发布者。槽位按样本序号(generation)循环使用，订阅者自己保存读取位置，
+ *           读取落后超过depth个样本时跳过被覆盖的样本并计入lost。
+ *           发布者可能在读取过程中运行(中断、抢占任务)时，读取后用osal_topic_check()确认样本未被覆盖。
+ ***************************************************************************************/
+#include <string.h>
+#include "osal_topic.h"
+#include "osal_event.h"
+
+//第generation个样本所在的槽位
+static uint8 *osalTopicSlot(const osalTopic_t *topic, uint32 generation)
+{
+    return topic->slots + ((generation - 1) % topic->depth) * topic->size;
+}
+
+//最早一个未被覆盖(也没有正在被覆盖)的样本序号的前一个
+static uint32 osalTopicOldest(const osalTopic_t *topic, const osalTopicReader_t *reader)
+{
+    halIntState_t intState;
+    uint32 before;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    before = topic->claimed - topic->depth;
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    return ((int32)(before - reader->generation) > 0) ? before : reader->generation;
+}
+
+/*********************************************************************
+ * @fn osal_topic_init
+ *
+ * @brief   初始化主题，也可用OSAL_TOPIC_DEFINE()静态定义。
+ *
+ * @param   topic - 主题
+ * @param   slots - 槽位区，不小于depth * size字节
+ * @param   size  - 每个样本的字节数
+ * @param   depth - 槽位数，至少为1
+ *
+ * @return  none
+ */
+void osal_topic_init(osalTopic_t *topic, void *slots, uint16 size, uint16 depth)
+{
+    osal_memset(topic, 0, sizeof(osalTopic_t));
+    topic->slots = (uint8 *)slots;
+    topic->size = size;
+    topic->depth = depth;
+}
+
+/*********************************************************************
+ * @fn osal_topic_subscribe
+ *
+ * @brief   订阅主题，此后每次发布都给任务置位event_flag。同一任务重复订阅时合并事件。
+ *
+ * @param   topic      - 主题
+ * @param   task_id    - 订阅任务ID
+ * @param   event_flag - 发布时置位的事件
+ *
+ * @return  SUCCESS, INVALID_TASK, MSG_BUFFER_NOT_AVAIL(订阅任务数已达OSAL_TOPIC_SUBS)
+ */
+uint8 osal_topic_subscribe(osalTopic_t *topic, uint8 task_id, uint16 event_flag)
+{
+    halIntState_t intState;
+    uint8 i;
+    uint8 ret = MSG_BUFFER_NOT_AVAIL;
+
+    if (osalFindTask(task_id) == NULL)
+    {
+        return (INVALID_TASK);
+    }
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    for (i = 0; i < topic->subCnt; i++)
+    {
+        if (topic->subTask[i] == task_id)
+        {
+            topic->subEvent[i] |= event_flag;
+            ret = SUCCESS;
+            break;
+        }
+    }
+    if ((ret != SUCCESS) && (topic->subCnt < OSAL_TOPIC_SUBS))
+    {
+        topic->subTask[topic->subCnt] = task_id;
+        topic->subEvent[topic->subCnt] = event_flag;
+        topic->subCnt++;
+        ret = SUCCESS;
+    }
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    return (ret);
+}
+
+/*********************************************************************
+ * @fn osal_topic_claim
+ *
+ * @brief   取得下一个样本的槽位，发布者直接在槽位中填写样本后调用osal_topic_publish()。
+ *          槽位中原有的最旧样本从此刻起不可读。
+ *
+ * @param   topic - 主题
+ *
+ * @return  槽位指针
+ */
+void *osal_topic_claim(osalTopic_t *topic)
+{
+    halIntState_t intState;
+    uint32 claimed;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    claimed = topic->generation + 1;
+    topic->claimed = claimed;
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    return osalTopicSlot(topic, claimed);
+}
+
+/*********************************************************************
+ * @fn osal_topic_publish
+ *
+ * @brief   发布osal_topic_claim()取得的样本，并给所有订阅任务置位事件。
+ *
+ * @param   topic - 主题
+ *
+ * @return  none
+ */
+void osal_topic_publish(osalTopic_t *topic)
+{
+    halIntState_t intState;
+    uint8 i;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    if (topic->claimed == topic->generation)
+    {
+        // 没有取得槽位
+        HAL_EXIT_CRITICAL_SECTION(intState);
+        return;
+    }
+    topic->generation = topic->claimed;
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    for (i = 0; i < topic->subCnt; i++)
+    {
+        osal_set_event(topic->subTask[i], topic->subEvent[i]);
+    }
+}
+
+/*********************************************************************
+ * @fn osal_topic_write
+ *
+ * @brief   复制一个样本到槽位并发布，样本已在别处时使用。
+ *
+ * @param   topic - 主题
+ * @param   data  - 样本，topic->size字节
+ *
+ * @return  none
+ */
+void osal_topic_write(osalTopic_t *topic, const void *data)
+{
+    memcpy(osal_topic_claim(topic), data, topic->size);
+    osal_topic_publish(topic);
+}
+
+/*********************************************************************
+ * @fn osal_topic_reader_init
+ *
+ * @brief   初始化读取位置，只读取此后发布的样本。
+ *
+ * @param   topic  - 主题
+ * @param   reader - 读取位置
+ *
+ * @return  none
+ */
+void osal_topic_reader_init(const osalTopic_t *topic, osalTopicReader_t *reader)
+{
+    reader->generation = topic->generation;
+    reader->lost = 0;
+}
+
+/*********************************************************************
+ * @fn osal_topic_pending
+ *
+ * @brief   尚未读取且仍可读取的样本数。
+ *
+ * @param   topic  - 主题
+ * @param   reader - 读取位置
+ *
+ * @return  样本数
+ */
+uint32 osal_topic_pending(const osalTopic_t *topic, const osalTopicReader_t *reader)
+{
+    uint32 from = osalTopicOldest(topic, reader);
+    int32 pending = (int32)(topic->generation - from);
+
+    return (pending > 0) ? (uint32)pending : 0;
+}
+
+/*********************************************************************
+ * @fn osal_topic_read
+ *
+ * @brief   按发布顺序读取下一个样本，不复制。读取落后时跳过已被覆盖的样本，跳过数计入reader->lost。
+ *
+ * @param   topic  - 主题
+ * @param   reader - 读取位置
+ *
+ * @return  样本在槽位中的地址，没有新样本时返回NULL
+ */
+const void *osal_topic_read(const osalTopic_t *topic, osalTopicReader_t *reader)
+{
+    uint32 from = osalTopicOldest(topic, reader);
+
+    reader->lost += from - reader->generation;
+    reader->generation = from;
+
+    if ((int32)(topic->generation - from) <= 0)
+    {
+        return NULL;
+    }
+
+    reader->generation++;
+    return osalTopicSlot(topic, reader->generation);
+}
+
+/*********************************************************************
+ * @fn osal_topic_latest
+ *
+ * @brief   读取最新的样本，不复制。跳过的样本不计入reader->lost，适合只关心当前值的订阅者。
+ *
+ * @param   topic  - 主题
+ * @param   reader - 读取位置
+ *
+ * @return  样本在槽位中的地址，没有新样本时返回NULL
+ */
+const void *osal_topic_latest(const osalTopic_t *topic, osalTopicReader_t *reader)
+{
+    uint32 generation = topic->generation;
+
+    if (generation == reader->generation)
+    {
+        return NULL;
+    }
+
+    reader->generation = generation - 1;
+    return osal_topic_read(topic, reader);
+}
+
+/*********************************************************************
+ * @fn osal_topic_check
+ *
+ * @brief   确认刚读取的样本在读取过程中没有被发布者覆盖。
+ *          发布者与订阅者都是协作任务时不会发生覆盖，可不调用。
+ *
+ * @param   topic  - 主题
+ * @param   reader - 读取位置
+ *
+ * @return  TRUE：样本完整；FALSE：样本已被覆盖，计入reader->lost
+ */
+uint8 osal_topic_check(const osalTopic_t *topic, osalTopicReader_t *reader)
+{
+    if ((uint32)(topic->claimed - reader->generation) < topic->depth)
+    {
+        return TRUE;
+    }
+
+    reader->lost++;
+    return FALSE;
+}
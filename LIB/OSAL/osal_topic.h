@@ -0,0 +1,47 @@
+#ifndef OSAL_TOPIC_H
+#define OSAL_TOPIC_H
+
+#include "osal.h"
+#include "type.h"
+
+#if !defined(OSAL_TOPIC_SUBS)
+#define OSAL_TOPIC_SUBS             4       //每个主题的最大订阅任务数
+#endif
+
+// 主题：发布者把样本写入槽位一次，订阅任务收到事件后直接读取槽位，不再逐个复制
+typedef struct
+{
+    uint8 *slots;                           // 槽位区，depth * size字节
+    uint16 size;                            // 每个样本的字节数
+    uint16 depth;                           // 槽位数，保留最近depth个样本
+    volatile uint32 generation;             // 已发布的样本数，第g个样本在槽位(g-1)%depth
+    volatile uint32 claimed;                // 已开始写入的样本数，等于generation或generation+1
+    uint8 subCnt;                           // 订阅任务数
+    uint8 subTask[OSAL_TOPIC_SUBS];         // 订阅任务ID
+    uint16 subEvent[OSAL_TOPIC_SUBS];       // 发布时给订阅任务置位的事件
+} osalTopic_t;
+
+// 订阅者的读取位置，由订阅任务自己保存
+typedef struct
+{
+    uint32 generation;                      // 最近读取的样本序号
+    uint32 lost;                            // 读取前已被覆盖而丢失的样本数
+} osalTopicReader_t;
+
+// 定义主题及其槽位区，如 OSAL_TOPIC_DEFINE(imu_topic, sensor_data_t, 64);
+#define OSAL_TOPIC_DEFINE(name, type, depth)                                \
+    static type name##_slots[depth];                                        \
+    osalTopic_t name = {(uint8 *)name##_slots, sizeof(type), (depth), 0, 0, 0, {0}, {0}}
+
+extern void osal_topic_init(osalTopic_t *topic, void *slots, uint16 size, uint16 depth);
+extern uint8 osal_topic_subscribe(osalTopic_t *topic, uint8 task_id, uint16 event_flag);
+extern void *osal_topic_claim(osalTopic_t *topic);
+extern void osal_topic_publish(osalTopic_t *topic);
+extern void osal_topic_write(osalTopic_t *topic, const void *data);
+extern void osal_topic_reader_init(const osalTopic_t *topic, osalTopicReader_t *reader);
+extern uint32 osal_topic_pending(const osalTopic_t *topic, const osalTopicReader_t *reader);
+extern const void *osal_topic_read(const osalTopic_t *topic, osalTopicReader_t *reader);
+extern const void *osal_topic_latest(const osalTopic_t *topic, osalTopicReader_t *reader);
+extern uint8 osal_topic_check(const osalTopic_t *topic, osalTopicReader_t *reader);
+
+#endif
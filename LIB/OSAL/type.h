@@ -13,8 +13,12 @@
 
 typedef unsigned char       BOOL;
 
-//芯片硬件字长
+//芯片硬件字长，内存分配按此对齐，64位主机移植时须与指针等长
+#if defined(__SIZEOF_POINTER__) && (__SIZEOF_POINTER__ == 8)
+typedef unsigned long long  halDataAlign_t;
+#else
 typedef unsigned int        halDataAlign_t;
+#endif
 
 // Unsigned numbers
 typedef unsigned char       uint8;
@@ -76,9 +80,92 @@ typedef signed int          int32;
 
 #define HAL_ENABLE_INTERRUPTS()         SEI()       // Enable Interrupts
 #define HAL_DISABLE_INTERRUPTS()        CLI()       // Disable Interrupts
-#define HAL_INTERRUPTS_ARE_ENABLED()    SEI()       // Enable Interrupts
+#define HAL_INTERRUPTS_ARE_ENABLED()    (__get_PRIMASK() == 0)
+
+// 临界区：进入时保存中断屏蔽状态，退出时恢复，可以嵌套使用
+// halIntState_t intState;
+// HAL_ENTER_CRITICAL_SECTION(intState);
+// ...
+// HAL_EXIT_CRITICAL_SECTION(intState);
+typedef uint32 halIntState_t;
+
+#if !defined(HAL_CRITICAL_BASEPRI)
+#define HAL_CRITICAL_BASEPRI    0   //0：临界区屏蔽全部中断；非0：只屏蔽优先级数值>=该值的中断，更高优先级的中断中不能调用OSAL接口
+#endif
 
-#define HAL_ENTER_CRITICAL_SECTION()    CLI()
-#define HAL_EXIT_CRITICAL_SECTION()     SEI()
+#if HAL_CRITICAL_BASEPRI
+#define HAL_ENTER_CRITICAL_SECTION(s)   do { (s) = __get_BASEPRI(); \
+                                             __set_BASEPRI_MAX(HAL_CRITICAL_BASEPRI << (8 - __NVIC_PRIO_BITS)); \
+                                             __ISB(); } while(0)
+#define HAL_EXIT_CRITICAL_SECTION(s)    __set_BASEPRI(s)
+#else
+#define HAL_ENTER_CRITICAL_SECTION(s)   do { (s) = __get_PRIMASK(); CLI(); } while(0)
+#define HAL_EXIT_CRITICAL_SECTION(s)    __set_PRIMASK(s)
+#endif
+
+// 屏蔽全部中断的临界区，不受HAL_CRITICAL_BASEPRI影响。
+// 进入低功耗睡眠前使用：被BASEPRI屏蔽的中断不能唤醒WFI，而PRIMASK屏蔽的可以。
+#define HAL_ENTER_CRITICAL_SECTION_ALL(s)   do { (s) = __get_PRIMASK(); CLI(); } while(0)
+#define HAL_EXIT_CRITICAL_SECTION_ALL(s)    __set_PRIMASK(s)
+
+// 无锁原子操作，供中断中不关中断地修改共享字使用
+// Cortex-M3/M4使用LDREX/STREX；主机编译使用C11原子操作；其他内核退回临界区实现
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__) || \
+    defined(__TARGET_ARCH_7_M) || defined(__TARGET_ARCH_7E_M)
+typedef volatile uint32 halAtomic_t;
+
+static inline void halAtomicOr(halAtomic_t *p, uint32 v)
+{
+    uint32 old;
+    do
+    {
+        old = __LDREXW((volatile uint32_t *)p);
+    } while (__STREXW(old | v, (volatile uint32_t *)p));
+}
+
+static inline uint32 halAtomicXchg(halAtomic_t *p, uint32 v)
+{
+    uint32 old;
+    do
+    {
+        old = __LDREXW((volatile uint32_t *)p);
+    } while (__STREXW(v, (volatile uint32_t *)p));
+    return old;
+}
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+typedef _Atomic uint32 halAtomic_t;
+
+static inline void halAtomicOr(halAtomic_t *p, uint32 v)
+{
+    atomic_fetch_or_explicit(p, v, memory_order_release);
+}
+
+static inline uint32 halAtomicXchg(halAtomic_t *p, uint32 v)
+{
+    return atomic_exchange_explicit(p, v, memory_order_acquire);
+}
+#else
+typedef volatile uint32 halAtomic_t;
+
+static inline void halAtomicOr(halAtomic_t *p, uint32 v)
+{
+    halIntState_t s;
+    HAL_ENTER_CRITICAL_SECTION_ALL(s);
+    *p |= v;
+    HAL_EXIT_CRITICAL_SECTION_ALL(s);
+}
+
+static inline uint32 halAtomicXchg(halAtomic_t *p, uint32 v)
+{
+    halIntState_t s;
+    uint32 old;
+    HAL_ENTER_CRITICAL_SECTION_ALL(s);
+    old = *p;
+    *p = v;
+    HAL_EXIT_CRITICAL_SECTION_ALL(s);
+    return old;
+}
+#endif
 
 #endif
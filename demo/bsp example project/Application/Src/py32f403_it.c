@@ -128,6 +128,7 @@ void SysTick_Handler(void)
 /* For the available peripheral interrupt handler names,                      */
 /* please refer to the startup file.                                          */
 /******************************************************************************/
+/* DMA通道中断由py32_drivers的drv_dma.c定义，自定义处理用drv_dma_set_irq_handler()注册 */
 /**
  * @brief This function handles TIM2 global interrupt.
  */
@@ -135,15 +136,6 @@ void TIM2_IRQHandler(void)
 {
 }
 
-/**
- * @brief  外部声明dev_led_dma_transfer_complete函数
- * @retval None
- */
-
-void DMA2_Channel1_IRQHandler(void)
-{
-}
-
 /**
  * @brief  DMA传输完成回调函数
  * @param  hdma: DMA句柄
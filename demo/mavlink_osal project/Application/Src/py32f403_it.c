@@ -135,15 +135,6 @@ void TIM2_IRQHandler(void)
 {
 }
 
-/**
- * @brief  外部声明dev_led_dma_transfer_complete函数
- * @retval None
- */
-
-void DMA2_Channel1_IRQHandler(void)
-{
-}
-
 /**
  * @brief  DMA传输完成回调函数
  * @param  hdma: DMA句柄
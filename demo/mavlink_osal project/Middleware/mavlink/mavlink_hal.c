@@ -6,6 +6,7 @@ static mavlink_handl_t mav_handl;
 static uint8_t mavlink_system_id = 255;
 static uint8_t mavlink_component_id = 1;
 static void handle_mavlink_message(mavlink_message_t *msg);
+static void mavlink_tx_frame_release(uart_instance_t instance, const uint8_t *data, void *arg);
 
 extern uart_instance_t uart2_instance;
 // ʼMAVLink
@@ -36,14 +37,47 @@ void mavlink_receive_byte(uint8_t byte)
 // MAVLinkϢ
 void mavlink_send_message(const mavlink_message_t *msg)
 {
-    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
-    uint16_t len = mavlink_msg_to_send_buffer(buffer, msg);
-   
-    
-//    uart_send(uart2_instance, buffer, len, 100);
-uart_send(mav_handl.uart_instamce, buffer, len, 100);
-  
+    drv_irq_state_t state;
+    uint8_t i;
+    uint16_t len;
+    uart_err_t ret;
+
+    // һеķ֡ռã㿽ͣɺmavlink_tx_frame_releaseͷš
+    // жϻռеãռٽɣ߻ѡͬһ֡
+    DRV_ENTER_CRITICAL(state);
+    for (i = 0; i < MAVLINK_TX_FRAME_NUM; i++) {
+        if (!mav_handl.tx_frame_busy[i]) {
+            mav_handl.tx_frame_busy[i] = true;
+            break;
+        }
+    }
+    // ֡ڷʱϢ˻ػλͣ
+    // ·ʱλƴһܱ֡㿽֡м
+    if (i == MAVLINK_TX_FRAME_NUM) {
+        mav_handl.tx_drop++;
+        DRV_EXIT_CRITICAL(state);
+        return;
+    }
+    DRV_EXIT_CRITICAL(state);
 
+    // ռõֻ֡бд룬Ҫж
+    len = mavlink_msg_to_send_buffer(mav_handl.tx_frame[i], msg);
+
+    // uart_send_zero_copy()ֻһύߣߵύҲٽ
+    DRV_ENTER_CRITICAL(state);
+    ret = uart_send_zero_copy(mav_handl.uart_instamce, mav_handl.tx_frame[i], len,
+                              mavlink_tx_frame_release, (void *)&mav_handl.tx_frame_busy[i]);
+    if (ret != UART_OK) {
+        mav_handl.tx_frame_busy[i] = false;
+        mav_handl.tx_drop++;
+    }
+    DRV_EXIT_CRITICAL(state);
+}
+
+// жеã֡ʹ
+static void mavlink_tx_frame_release(uart_instance_t instance, const uint8_t *data, void *arg)
+{
+    *(volatile bool *)arg = false;
 }
 
 
@@ -7,12 +7,15 @@
 #include "mavlink_types.h"
 // 
 #define MAVLINK_RX_BUFFER_SIZE 512
-#define MAVLINK_TX_BUFFER_SIZE 512
+// ֡DMAֱӴӷ֡㿽ͣǰ֡д
+#define MAVLINK_TX_FRAME_NUM 4
 
 typedef struct {
     uart_instance_t uart_instamce;
     uint8_t rx_buffer[MAVLINK_RX_BUFFER_SIZE];
-    uint8_t tx_buffer[MAVLINK_TX_BUFFER_SIZE];
+    uint8_t tx_frame[MAVLINK_TX_FRAME_NUM][MAVLINK_MAX_PACKET_LEN];
+    volatile bool tx_frame_busy[MAVLINK_TX_FRAME_NUM];
+    uint32_t tx_drop;               // ֡ڷжϢ
     uint16_t rx_index;
     uint32_t last_heartbeat_ms; 
     mavlink_status_t status;
@@ -13,6 +13,7 @@ extern "C" {
 #define LED_PIN GET_PIN(B, 2)
 
 void board_init(void);
+void board_bench_done(void);
 
 
 
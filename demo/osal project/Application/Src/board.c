@@ -27,6 +27,11 @@ void board_init(void)
     MX_I2C2_Init();
 }
 
+// 基准测试结束，结果已通过日志串口输出
+void board_bench_done(void)
+{
+}
+
 /***********************************Printf重定向********************************************************/
 int fputc(int ch, FILE *f)
 {
@@ -2,6 +2,8 @@
 #include "board.h"
 #include "drv_include.h"
 #include "task_event.h"
+#include "osal_bench.h"
+#include "osal_cpu.h"
 
 void osal_main(void)
 {
@@ -18,11 +20,21 @@ void osal_main(void)
     // osal操作系统初始化
     osal_init_system();
 
+#if OSAL_BENCH
+    // 基准测试：只添加基准测试任务，结果通过日志串口输出
+    osal_bench_add_tasks(board_bench_done);
+#else
     // 添加任务
     osal_add_Task(led_task_init, led_task_event_process, 1);
     osal_add_Task(print_task_init, print_task_event_process, 1);
-    osal_add_Task(sensor_task_init, sensor_task_event_process, 1);
+    // 传感器采集任务优先级最高，开启OSAL_PREEMPT时在PendSV中运行，可抢占打印等耗时的事件处理
+    osal_add_Task(sensor_task_init, sensor_task_event_process, OSAL_PREEMPT_PRIO);
     // osal_add_Task(statistics_task_init, statistics_task_event_process, 2);
+#if OSAL_CPU_STATS
+    // 任务耗时统计输出，最低优先级
+    osal_add_Task(osal_cpu_dump_init, osal_cpu_dump_event_process, 0);
+#endif
+#endif
 
     // 添加的任务统一进行初始化
     osal_Task_init();
@@ -16,6 +16,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "py32f403_it.h"
+#include "osal_event.h"
 
 extern void osalTimerUpdate(unsigned short updateTime);
 /******************************************************************************/
@@ -107,6 +108,9 @@ void DebugMon_Handler(void)
  */
 void PendSV_Handler(void)
 {
+#if OSAL_PREEMPT
+  osal_preempt_run(); // OSAL抢占任务调度
+#endif
 }
 
 /**
@@ -128,6 +132,7 @@ void SysTick_Handler(void)
 /* For the available peripheral interrupt handler names,                      */
 /* please refer to the startup file.                                          */
 /******************************************************************************/
+/* DMA通道中断由py32_drivers的drv_dma.c定义，自定义处理用drv_dma_set_irq_handler()注册 */
 /**
  * @brief This function handles TIM2 global interrupt.
  */
@@ -135,15 +140,6 @@ void TIM2_IRQHandler(void)
 {
 }
 
-/**
- * @brief  外部声明dev_led_dma_transfer_complete函数
- * @retval None
- */
-
-void DMA2_Channel1_IRQHandler(void)
-{
-}
-
 /**
  * @brief  DMA传输完成回调函数
  * @param  hdma: DMA句柄
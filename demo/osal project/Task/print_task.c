@@ -8,15 +8,19 @@
 #include "qmi8658a_driver.h"
 #include "data_protocol.h"
 
-extern ring_buffer_t imu_ring_buffer;
 extern uart_instance_t log_uart_instance;
 
 uint8 print_task_id;
 static uint8 print_state = 0;
+static osalTopicReader_t imu_reader; // IMU主题读取位置
 
 static uint8_t uart_cmd_buffer[512]; // 命令缓冲区
 static uint16_t uart_cmd_index = 0;  // 命令缓冲区索引
 uint16_t accel_data[124] = {0};
+static char report_frame[256 + 1];        // 报告帧及结尾换行，DMA直接从这里发送
+static volatile bool report_frame_busy;   // 报告帧正在发送，发送完成前不能重写
+
+static void report_frame_release(uart_instance_t instance, const uint8_t *data, void *arg);
 
 void process_uart_command(const char *data, uint16_t length);
 static void send_single_data_via_uart(const sensor_data_t *data);
@@ -28,6 +32,10 @@ void print_task_init(uint8 task_id)
 {
     print_task_id = task_id;
 
+    // 订阅IMU数据
+    osal_topic_reader_init(&imu_topic, &imu_reader);
+    osal_topic_subscribe(&imu_topic, print_task_id, IMU_DATA_EVENT);
+
     // 启动定时器，每500ms触发一次测试 log 事件
     osal_start_reload_timer(print_task_id, CMD_PRINT_EVENT, 500);
 }
@@ -65,37 +73,45 @@ uint16 print_task_event_process(uint8 task_id, uint16 task_event)
         // }
         return task_event ^ CMD_PRINT_EVENT;
     }
+    if (task_event & IMU_DATA_EVENT)
+    {
+        // 积累到阈值后触发发送
+        if (osal_topic_pending(&imu_topic, &imu_reader) >= 64)
+        {
+            osal_set_event(print_task_id, DATA_SEND_EVENT);
+        }
+        return task_event ^ IMU_DATA_EVENT;
+    }
     if (task_event & DATA_SEND_EVENT)
     {
-        sensor_data_t data;
+        const sensor_data_t *data;
         uint16_t data_count = 0; // 数据计数器
         uint16_t sent_count = 0;
+        float temp = 0.0f;
 
-        data_count = ring_buffer_available(&imu_ring_buffer) / SENSOR_DATA_SIZE;
+        // 上一帧还在发送时不读取，样本留在主题中下次发送
+        data_count = report_frame_busy ? 0 : osal_topic_pending(&imu_topic, &imu_reader);
         if (data_count > 0)
         {
-            printf("Sending %d sensor data points via UART...\n", data_count);
+            printf("Sending %d sensor data points via UART, lost %lu...\n",
+                   data_count, (unsigned long)imu_reader.lost);
 
-            // 批量读取并发送数据
-            for (uint16_t i = 0; i < data_count; i++)
+            // 直接在主题槽位中批量读取，传感器任务可能抢占本任务，读取后确认数据未被覆盖
+            while ((sent_count < sizeof(accel_data) / sizeof(accel_data[0])) &&
+                   ((data = osal_topic_read(&imu_topic, &imu_reader)) != NULL))
             {
-                if (ring_buffer_get_multiple(&imu_ring_buffer, (uint8_t *)&data, SENSOR_DATA_SIZE) == SENSOR_DATA_SIZE)
-                {
-                    //                    send_single_data_via_uart(&data);
-
-                    float accel = sqrt((data.gyro[0] * data.gyro[0]) + (data.gyro[1] * data.gyro[1]) + (data.gyro[2] * data.gyro[2]));
-                    uint16_t accel_12bit = acceleration_to_12bit(accel, 4.0f);
-                    accel_data[sent_count] = accel_12bit;
+                //                    send_single_data_via_uart(data);
 
-                    sent_count++;
-                }
-                else
+                float accel = sqrt((data->gyro[0] * data->gyro[0]) + (data->gyro[1] * data->gyro[1]) + (data->gyro[2] * data->gyro[2]));
+                float sample_temp = data->temp;
+                if (osal_topic_check(&imu_topic, &imu_reader))
                 {
-                    break; // 读取失败，退出循环
+                    accel_data[sent_count] = acceleration_to_12bit(accel, 4.0f);
+                    temp = sample_temp;
+                    sent_count++;
                 }
             }
-            char rx_frame[256];
-            uint16_t temperature = temperature_to_12bit(data.temp);
+            uint16_t temperature = temperature_to_12bit(temp);
             report_data_decoded_t report = {.tag_id = {0x01, 0x02, 0x03, 0x04, 0x05},
                                             .start_hour = 10,
                                             .start_minute = 30,
@@ -106,15 +122,18 @@ uint16 print_task_event_process(uint8 task_id, uint16 task_event)
                                             .acceleration = accel_data,
                                             .accel_count = sent_count};
 
-            // 构建一个实际的报告消息
-            uint16_t rx_len = build_report_msg(rx_frame, sizeof(rx_frame), 1,
+            // 构建一个实际的报告消息，零拷贝发送，发送完成后在report_frame_release中释放
+            uint16_t rx_len = build_report_msg(report_frame, sizeof(report_frame) - 1, 1,
                                                MSG_REPORT_FIRST, &report);
             if (rx_len > 0)
             {
-
-                for (uint16_t i = 0; i < rx_len; i++)
-                    printf("%c", rx_frame[i]);
-                printf("\n");
+                report_frame[rx_len++] = '\n';
+                report_frame_busy = true;
+                if (uart_send_zero_copy(log_uart_instance, (const uint8_t *)report_frame, rx_len,
+                                        report_frame_release, NULL) != UART_OK)
+                {
+                    report_frame_busy = false;
+                }
             }
         }
         return task_event ^ DATA_SEND_EVENT;
@@ -144,25 +163,37 @@ static void send_single_data_via_uart(const sensor_data_t *data)
            data->temp);
 }
 
+// 报告帧发送完成(DMA发送完成中断中调用)
+static void report_frame_release(uart_instance_t instance, const uint8_t *data, void *arg)
+{
+    report_frame_busy = false;
+}
+
 static void process_uart_commands(void)
 {
-    uint8_t temp_buffer[64];
+    const uint8_t *rx_data;
     uint16_t bytes_read;
 
-    // 从DMA环形缓冲区读取数据
-    bytes_read = uart_read_from_ring_buffer(log_uart_instance, temp_buffer, sizeof(temp_buffer));
+    // 直接取得DMA环形缓冲区中的连续数据，不经过临时缓冲区
+    bytes_read = uart_rx_peek(log_uart_instance, &rx_data);
 
     if (bytes_read > 0)
     {
         // 将数据添加到命令缓冲区
         if (uart_cmd_index + bytes_read < sizeof(uart_cmd_buffer))
         {
-            memcpy(&uart_cmd_buffer[uart_cmd_index], temp_buffer, bytes_read);
+            memcpy(&uart_cmd_buffer[uart_cmd_index], rx_data, bytes_read);
+            if (!uart_rx_consume(log_uart_instance, bytes_read))
+            {
+                // 复制期间数据已被DMA覆盖，丢弃
+                return;
+            }
             uart_cmd_index += bytes_read;
         }
         else
         {
-            // 缓冲区溢出，清空缓冲区
+            // 缓冲区溢出，丢弃数据并清空缓冲区
+            uart_rx_consume(log_uart_instance, bytes_read);
             uart_cmd_index = 0;
             return;
         }
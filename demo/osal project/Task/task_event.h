@@ -6,6 +6,7 @@
 #include "osal_event.h"
 #include "osal_memory.h"
 #include "osal_msg.h"
+#include "osal_topic.h"
 
 // 全局变量声明
 /*****************************************************************************/
@@ -25,6 +26,9 @@ typedef struct
 extern uint8 led_task_id;
 extern uint8 mav_task_id;
 
+// IMU数据主题，传感器任务发布，打印等任务订阅
+extern osalTopic_t imu_topic;
+
 // 任务初始化函数声明
 void led_task_init(uint8 task_id);
 void print_task_init(uint8 task_id);
@@ -45,6 +49,7 @@ uint16 sensor_task_event_process(uint8 task_id, uint16 task_event);
 // print 任务的任务事件定义
 #define CMD_PRINT_EVENT 0x0001 // 日志打印事件
 #define DATA_SEND_EVENT 0x0002 // 数据发送事件
+#define IMU_DATA_EVENT 0x0004  // IMU主题有新数据
 
 // 传感器任务事件定义
 #define SENSOR_COLLECT_EVENT 0x0001 // 传感器采集
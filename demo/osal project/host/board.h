@@ -0,0 +1,22 @@
+/* 主机(POSIX)仿真用board.h，替代Application/Inc/board.h */
+#ifndef __BOARD_H
+#define __BOARD_H
+
+#include "py32f4xx_hal.h"
+#include "drv_gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 板载led
+#define LED_PIN GET_PIN(B, 2)
+
+void board_init(void);
+void board_bench_done(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BOARD_H */
@@ -0,0 +1,138 @@
+/*Info------------------------------------------------
+** File Name:               board_host.c
+** Descriptions:            主机(POSIX)仿真板级支持
+**                          LED翻转打印到终端，日志串口映射到标准输入输出，I2C总线上只有仿真的QMI8658A
+**--------------------------------------------------------------------------------------------------------
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "main.h"
+#include "board.h"
+#include "drv_include.h"
+
+uart_instance_t log_uart_instance = UART_INSTANCE_2;
+I2C_HandleTypeDef hi2c2;
+
+static uint8_t led_level; // 仿真LED电平
+
+void board_init(void)
+{
+    // 标准输出不缓冲，与串口逐字节发送的表现一致
+    setvbuf(stdout, NULL, _IONBF, 0);
+    // 标准输入设为非阻塞，模拟串口DMA接收缓冲区
+    fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+
+    gpio_init();
+    MX_I2C2_Init();
+}
+
+void APP_ErrorHandler(void)
+{
+    fprintf(stderr, "APP_ErrorHandler\n");
+    exit(1);
+}
+
+// 基准测试结束后退出进程，便于脚本采集结果
+void board_bench_done(void)
+{
+    exit(0);
+}
+
+/***********************************GPIO********************************************************/
+gpio_err_t gpio_init(void)
+{
+    led_level = 0;
+    return GPIO_OK;
+}
+
+gpio_err_t gpio_toggle(gpio_pin_t pin)
+{
+    led_level ^= 1;
+    if (pin == LED_PIN)
+    {
+        printf("\n[%u] LED %s\n", (unsigned)HAL_GetTick(), led_level ? "ON" : "OFF");
+    }
+    return GPIO_OK;
+}
+
+/***********************************UART********************************************************/
+uart_err_t uart_send(uart_instance_t instance, const uint8_t *data, uint16_t size, uint32_t timeout)
+{
+    if ((instance >= UART_INSTANCE_MAX) || (data == NULL))
+    {
+        return UART_ERROR_PARAM;
+    }
+    fwrite(data, 1, size, stdout);
+    return UART_OK;
+}
+
+uart_err_t uart_send_async(uart_instance_t instance, const uint8_t *data, uint16_t size)
+{
+    return uart_send(instance, data, size, 0);
+}
+
+// 主机上写入标准输出即发送完成，立即释放
+uart_err_t uart_send_zero_copy(uart_instance_t instance, const uint8_t *data, uint16_t size,
+                               uart_tx_release_callback_t release, void *arg)
+{
+    uart_err_t ret = uart_send(instance, data, size, 0);
+
+    if ((ret == UART_OK) && (release != NULL))
+    {
+        release(instance, data, arg);
+    }
+    return ret;
+}
+
+uint16_t uart_read_from_ring_buffer(uart_instance_t instance, uint8_t *buffer, uint16_t size)
+{
+    ssize_t len;
+
+    if ((instance != log_uart_instance) || (buffer == NULL))
+    {
+        return 0;
+    }
+    len = read(STDIN_FILENO, buffer, size);
+    return (len > 0) ? (uint16_t)len : 0;
+}
+
+static uint8_t uart_rx_data[64]; // 仿真接收缓冲区，保存已从标准输入读出、尚未释放的数据
+static uint16_t uart_rx_head, uart_rx_tail;
+
+uint16_t uart_rx_peek(uart_instance_t instance, const uint8_t **data)
+{
+    if ((instance != log_uart_instance) || (data == NULL))
+    {
+        return 0;
+    }
+    if (uart_rx_tail == uart_rx_head)
+    {
+        uart_rx_tail = 0;
+        uart_rx_head = uart_read_from_ring_buffer(instance, uart_rx_data, sizeof(uart_rx_data));
+    }
+    *data = &uart_rx_data[uart_rx_tail];
+    return uart_rx_head - uart_rx_tail;
+}
+
+bool uart_rx_consume(uart_instance_t instance, uint16_t size)
+{
+    if (instance != log_uart_instance)
+    {
+        return false;
+    }
+    uart_rx_tail = (size < uart_rx_head - uart_rx_tail) ? uart_rx_tail + size : uart_rx_head;
+    return true;
+}
+
+/***********************************I2C********************************************************/
+void MX_I2C2_Init(void)
+{
+    hi2c2.Instance = 2;
+}
+
+void I2C2_ScanDevices(void)
+{
+    printf("I2C2 scan: found device at 0x6B (QMI8658A, simulated)\n");
+}
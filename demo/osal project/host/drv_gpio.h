@@ -0,0 +1,26 @@
+/* 主机(POSIX)仿真用GPIO接口，LED状态输出到终端 */
+#ifndef __DRV_GPIO_H__
+#define __DRV_GPIO_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define GET_PIN(PORTx, PIN) (uint16_t)((16 * ((#PORTx)[0] - 'A')) + (PIN))
+
+    typedef int32_t gpio_err_t;
+    typedef uint16_t gpio_pin_t;
+
+#define GPIO_OK 0
+
+    gpio_err_t gpio_init(void);
+    gpio_err_t gpio_toggle(gpio_pin_t pin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DRV_GPIO_H__ */
@@ -0,0 +1,24 @@
+/* 主机(POSIX)仿真用I2C接口，总线上只挂仿真的QMI8658A */
+#ifndef __DRV_IIC_H
+#define __DRV_IIC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct
+    {
+        uint32_t Instance;
+    } I2C_HandleTypeDef;
+
+    void MX_I2C2_Init(void);
+    void I2C2_ScanDevices(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DRV_IIC_H */
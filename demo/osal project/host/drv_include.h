@@ -0,0 +1,10 @@
+/* 主机(POSIX)仿真用drv_include.h：外设驱动换成host目录下的仿真接口，环形缓冲区沿用sdk的drv_tool */
+#ifndef __DRV_INCLUDE_H__
+#define __DRV_INCLUDE_H__
+
+#include "drv_gpio.h"
+#include "drv_uart.h"
+#include "drv_i2c.h"
+#include "drv_tool.h"
+
+#endif /* __DRV_INCLUDE_H__ */
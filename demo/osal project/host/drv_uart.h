@@ -0,0 +1,44 @@
+/* 主机(POSIX)仿真用UART接口，收发映射到标准输入输出 */
+#ifndef __DRV_UART_H__
+#define __DRV_UART_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef enum
+    {
+        UART_OK = 0,
+        UART_ERROR = -1,
+        UART_ERROR_PARAM = -2,
+    } uart_err_t;
+
+    typedef enum
+    {
+        UART_INSTANCE_1 = 0,
+        UART_INSTANCE_2,
+        UART_INSTANCE_3,
+        UART_INSTANCE_4,
+        UART_INSTANCE_5,
+        UART_INSTANCE_MAX
+    } uart_instance_t;
+
+    typedef void (*uart_tx_release_callback_t)(uart_instance_t instance, const uint8_t *data, void *arg);
+
+    uart_err_t uart_send(uart_instance_t instance, const uint8_t *data, uint16_t size, uint32_t timeout);
+    uart_err_t uart_send_async(uart_instance_t instance, const uint8_t *data, uint16_t size);
+    uint16_t uart_read_from_ring_buffer(uart_instance_t instance, uint8_t *buffer, uint16_t size);
+    uint16_t uart_rx_peek(uart_instance_t instance, const uint8_t **data);
+    bool uart_rx_consume(uart_instance_t instance, uint16_t size);
+    uart_err_t uart_send_zero_copy(uart_instance_t instance, const uint8_t *data, uint16_t size,
+                                   uart_tx_release_callback_t release, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DRV_UART_H__ */
@@ -0,0 +1,17 @@
+/*Info------------------------------------------------
+** File Name:               main.c
+** Descriptions:            主机(POSIX)仿真入口
+**                          Task与osal_main.c原样编译，硬件由host目录下的仿真接口代替
+**--------------------------------------------------------------------------------------------------------
+*/
+#include "main.h"
+#include "task_event.h"
+
+int main(void)
+{
+    /* 记录HAL时基起点 */
+    HAL_Init();
+
+    osal_main();
+    return 0;
+}
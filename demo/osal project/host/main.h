@@ -0,0 +1,18 @@
+/* 主机(POSIX)仿真用main.h，替代Application/Inc/main.h */
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "py32f4xx_hal.h"
+#include <stdint.h>
+
+void APP_ErrorHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAIN_H */
@@ -0,0 +1,68 @@
+/*Info------------------------------------------------
+** File Name:               qmi8658a_host.c
+** Descriptions:            主机(POSIX)仿真的QMI8658A，按时间生成平缓变化的姿态数据
+**--------------------------------------------------------------------------------------------------------
+*/
+#include <math.h>
+#include <stddef.h>
+#include "qmi8658a_driver.h"
+
+static gyro_range_t sim_range = GYRO_RANGE_500DPS;
+static gyro_odr_t sim_odr = GYRO_ODR_400HZ;
+
+static int32_t sim_init(void *hardware_handle)
+{
+    return (hardware_handle != NULL) ? 0 : -1;
+}
+
+static int32_t sim_read_data(sensor_data_t *data)
+{
+    float t = (float)HAL_GetTick() / 1000.0f;
+
+    // 机体以0.5Hz绕Z轴摆动，重力沿Z轴
+    data->accel[0] = 0.3f * sinf(3.1415926f * t);
+    data->accel[1] = 0.3f * cosf(3.1415926f * t);
+    data->accel[2] = 9.81f;
+    data->gyro[0] = 0.05f * sinf(6.2831853f * t);
+    data->gyro[1] = 0.05f * cosf(6.2831853f * t);
+    data->gyro[2] = 1.57f * cosf(3.1415926f * t);
+    data->temp = 25.0f + 0.5f * sinf(0.1f * t);
+
+    return 0;
+}
+
+static int32_t sim_set_range(gyro_range_t range)
+{
+    sim_range = range;
+    return 0;
+}
+
+static int32_t sim_set_odr(gyro_odr_t odr)
+{
+    sim_odr = odr;
+    return 0;
+}
+
+static int32_t sim_sleep(void)
+{
+    return 0;
+}
+
+static int32_t sim_wakeup(void)
+{
+    return 0;
+}
+
+const gyro_device_t qmi8658a_device = {
+    .init = sim_init,
+    .read_data = sim_read_data,
+    .set_range = sim_set_range,
+    .set_odr = sim_set_odr,
+    .sleep = sim_sleep,
+    .wakeup = sim_wakeup,
+};
+
+int32_t qmi8658a_init(void *hardware_handle)
+{
+    return sim_init(hardware_handle);
+}
@@ -0,0 +1,69 @@
+-- 主机(POSIX)仿真工程：在PC上原样运行Task目录下的演示任务
+-- 构建：xmake -P "demo/osal project/host"，运行：xmake run -P "demo/osal project/host" osal_host
+add_rules("mode.debug", "mode.release")
+
+set_project("osal-host")
+set_version("1.0.0")
+
+option("bench")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Build the OSAL benchmark suite instead of the demo tasks")
+    add_defines("OSAL_BENCH=1")
+option_end()
+
+option("cpu_stats")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Enable per-task CPU time accounting and the periodic dump task")
+    add_defines("OSAL_CPU_STATS=1")
+option_end()
+
+option("preempt")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Run tasks at or above OSAL_PREEMPT_PRIO from PendSV so they preempt lower-priority handlers")
+    add_defines("OSAL_PREEMPT=1")
+option_end()
+
+target("osal_host")
+    add_options("bench")
+    add_options("cpu_stats")
+    add_options("preempt")
+    set_kind("binary")
+    set_targetdir("dist")
+
+    -- 仿真头文件必须最先搜索，覆盖Application/Inc与sdk中的同名头文件
+    add_files("*.c")
+    add_includedirs(".")
+    add_includedirs("../../../LIB/OSAL/hal/posix")
+
+    add_files("../Application/Src/osal_main.c")
+
+    add_files("../Task/*.c")
+    remove_files("../Task/protocol.c")
+    add_includedirs("../Task")
+
+    add_includedirs("../Sensor/QMI8658A")
+
+    add_files("../data_protocol/data_protocol.c")
+    add_includedirs("../data_protocol")
+
+    add_files("../../../sdk/py32_drivers/Src/drv_tool.c")
+    add_includedirs("../../../sdk/py32_drivers/Inc")
+
+    add_files("../../../LIB/OSAL/*.c")
+    add_files("../../../LIB/OSAL/hal/posix/*.c")
+    -- MemMang/heap_4.c依赖Event OS的Cortex-M移植层，OSAL与演示任务都不使用，主机工程不编译
+    add_includedirs("../../../LIB/OSAL")
+    add_includedirs("../../../LIB/OSAL/hal")
+    add_includedirs("../../../LIB/OSAL/Protothreads")
+
+    add_cflags("-Wall", "-Wno-unused-parameter", {force = true})
+    add_syslinks("pthread", "m")
+
+    if is_mode("debug") then
+        add_cflags("-O0", "-g", {force = true})
+    else
+        add_cflags("-O2", {force = true})
+    end
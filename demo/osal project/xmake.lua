@@ -10,7 +10,31 @@ set_toolchains("arm-none-eabi", {sdkdir = "D:/APP/path/arm-gcc-15.2"})
 
 add_moduledirs("../../sdk/scripts")
 
+option("bench")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Build the OSAL benchmark suite instead of the demo tasks")
+    add_defines("OSAL_BENCH=1")
+option_end()
+
+option("cpu_stats")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Enable per-task CPU time accounting and the periodic dump task")
+    add_defines("OSAL_CPU_STATS=1")
+option_end()
+
+option("preempt")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Run tasks at or above OSAL_PREEMPT_PRIO from PendSV so they preempt lower-priority handlers")
+    add_defines("OSAL_PREEMPT=1")
+option_end()
+
 target("osal")
+    add_options("bench")
+    add_options("cpu_stats")
+    add_options("preempt")
     set_kind("binary")
     set_filename("osal.elf")
     set_targetdir("dist")
@@ -42,7 +66,6 @@ target("osal")
     add_includedirs("../../sdk/py32_drivers/Inc")
 
     add_files("../../LIB/OSAL/*.c")
-    remove_files("../../LIB/OSAL/osal_pt.c")
     add_files("../../LIB/OSAL/hal/*.c")
     add_files("../../LIB/OSAL/MemMang/*.c")
     add_includedirs("../../LIB/OSAL")
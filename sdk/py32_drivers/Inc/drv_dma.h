@@ -0,0 +1,54 @@
+#ifndef __DRV_DMA_H__
+#define __DRV_DMA_H__
+
+#include "py32f4xx_hal.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 申请通道时默认的DMA中断优先级 */
+#ifndef DRV_DMA_IRQ_PRIORITY
+#define DRV_DMA_IRQ_PRIORITY 4
+#endif
+#ifndef DRV_DMA_IRQ_SUB_PRIORITY
+#define DRV_DMA_IRQ_SUB_PRIORITY 0
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* DMA1 7个通道，DMA2 5个通道，任意外设请求可以映射到任意通道 */
+#define DRV_DMA_CHANNEL_NUM 12
+
+    /* 错误码定义 */
+    typedef enum
+    {
+        DRV_DMA_OK = 0,
+        DRV_DMA_ERROR = -1,
+        DRV_DMA_ERROR_PARAM = -2,
+        DRV_DMA_ERROR_NO_CHANNEL = -3, /* 没有空闲通道 */
+        DRV_DMA_ERROR_CONFLICT = -4,   /* 指定的通道已被占用，或同一外设请求已映射到其它通道 */
+    } drv_dma_err_t;
+
+    /* 通道中断处理函数，NULL时使用HAL_DMA_IRQHandler */
+    typedef void (*drv_dma_irq_handler_t)(DMA_HandleTypeDef *hdma, void *arg);
+
+    /* ========================= DMA通道管理 =================================================== */
+    /* 用法：在HAL_DMA_Init之前申请通道，申请成功后hdma->Instance已设置、请求已映射、中断已开启
+     *     drv_dma_request(&hdma_tx, DMA_CHANNEL_MAP_USART1_WR, NULL);
+     *     HAL_DMA_Init(&hdma_tx);
+     */
+    drv_dma_err_t drv_dma_request(DMA_HandleTypeDef *hdma, uint32_t request, DMA_Channel_TypeDef *channel);
+    drv_dma_err_t drv_dma_release(DMA_HandleTypeDef *hdma);
+    drv_dma_err_t drv_dma_set_irq_handler(DMA_HandleTypeDef *hdma, drv_dma_irq_handler_t handler, void *arg);
+    drv_dma_err_t drv_dma_set_irq_priority(DMA_HandleTypeDef *hdma, uint8_t preempt_priority, uint8_t sub_priority);
+    uint8_t drv_dma_free_channels(void);
+    DMA_HandleTypeDef *drv_dma_find_owner(uint32_t request);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DRV_DMA_H__ */
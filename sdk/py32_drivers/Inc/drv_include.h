@@ -6,6 +6,7 @@
 #include "drv_uart_config.h"
 #include "drv_i2c.h"
 #include "drv_tool.h"
+#include "drv_dma.h"
 
 
 
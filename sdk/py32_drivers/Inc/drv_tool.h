@@ -1,24 +1,67 @@
 #ifndef __DRV_TOOL_H__
 #define __DRV_TOOL_H__
 
+#include "py32f4xx_hal.h"
+
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
 
+/* 临界区中断屏蔽优先级，0：屏蔽全部中断；非0：使用BASEPRI只屏蔽优先级数值>=该值的中断 */
+#ifndef DRV_CRITICAL_BASEPRI
+#define DRV_CRITICAL_BASEPRI 0
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+    /* ========================= 临界区 =================================================== */
+    /* 进入时保存中断屏蔽状态，退出时恢复，可嵌套使用：
+     *     drv_irq_state_t state;
+     *     DRV_ENTER_CRITICAL(state);
+     *     ...
+     *     DRV_EXIT_CRITICAL(state);
+     */
+    typedef uint32_t drv_irq_state_t;
+
+#if DRV_CRITICAL_BASEPRI
+#define DRV_ENTER_CRITICAL(s)                                                    \
+    do                                                                           \
+    {                                                                            \
+        (s) = __get_BASEPRI();                                                   \
+        __set_BASEPRI_MAX(DRV_CRITICAL_BASEPRI << (8 - __NVIC_PRIO_BITS));       \
+        __ISB();                                                                 \
+    } while (0)
+#define DRV_EXIT_CRITICAL(s) __set_BASEPRI(s)
+#else
+#define DRV_ENTER_CRITICAL(s)      \
+    do                             \
+    {                              \
+        (s) = __get_PRIMASK();     \
+        __disable_irq();           \
+    } while (0)
+#define DRV_EXIT_CRITICAL(s) __set_PRIMASK(s)
+#endif
+
+/* 内存屏障：无锁环形缓冲区在发布读写位置前保证数据已写入/读出 */
+#define DRV_MEMORY_BARRIER() __DMB()
+
     /* ========================= 环形缓冲区工具函数 =================================================== */
-    /* 环形缓冲区结构 */
+    /* 环形缓冲区结构
+     * 单生产者单消费者无锁实现：大小为2的幂，head只由写入方修改，tail只由读取方修改，
+     * 两者都是自由递增的计数，数据量为head - tail，读写两端都不需要关中断。
+     * 同一缓冲区只能有一个写入方(如DMA中断)和一个读取方(如任务)。
+     * 有多个可能互相抢占的写入方时(如不同优先级的两个中断)，由调用方在写入时加临界区。
+     */
     typedef struct
     {
-        uint8_t *buffer;         // 缓冲区指针
-        uint16_t size;           // 缓冲区总大小
-        volatile uint16_t head;  // 写入位置
-        volatile uint16_t tail;  // 读取位置
-        volatile uint16_t count; // 当前数据量
+        uint8_t *buffer;        // 缓冲区指针
+        uint16_t size;          // 缓冲区总大小，2的幂，最大32768
+        uint16_t mask;          // size - 1
+        volatile uint16_t head; // 已写入字节计数，只由写入方修改
+        volatile uint16_t tail; // 已读取字节计数，只由读取方修改
 
     } ring_buffer_t;
 
@@ -30,6 +73,16 @@ extern "C"
     uint16_t ring_buffer_get_multiple(ring_buffer_t *rb, uint8_t *data, uint16_t size);
     uint16_t ring_buffer_peek_multiple(const ring_buffer_t *rb, uint8_t *data, uint16_t size, uint16_t offset);
     void ring_buffer_skip(ring_buffer_t *rb, uint16_t size);
+
+    /* 零拷贝接口：直接访问缓冲区内的连续区域，回绕处分两次操作
+     * 写入方：ring_buffer_reserve取得可写区域，填写后ring_buffer_commit提交
+     * 读取方：ring_buffer_peek_contiguous取得可读区域，处理后ring_buffer_consume释放
+     */
+    uint16_t ring_buffer_reserve(ring_buffer_t *rb, uint8_t **data);
+    void ring_buffer_commit(ring_buffer_t *rb, uint16_t size);
+    uint16_t ring_buffer_peek_contiguous(const ring_buffer_t *rb, const uint8_t **data);
+    void ring_buffer_consume(ring_buffer_t *rb, uint16_t size);
+
     uint16_t ring_buffer_available(const ring_buffer_t *rb);
     uint16_t ring_buffer_free_space(const ring_buffer_t *rb);
     bool ring_buffer_is_empty(const ring_buffer_t *rb);
@@ -61,6 +61,8 @@ extern "C"
 
 #if (UART_USE_DMA == 1)
     typedef void (*uart_dma_idle_callback_t)(uart_instance_t instance, uint16_t data_size, void *arg);
+    /* 零拷贝发送完成回调，在DMA发送完成中断中调用，data所指缓冲区此后可由调用者释放或重用 */
+    typedef void (*uart_tx_release_callback_t)(uart_instance_t instance, const uint8_t *data, void *arg);
 #endif
     /* API函数声明 */
     /* 基础功能 */
@@ -88,6 +90,14 @@ extern "C"
     /* 新增DMA环形缓冲区操作 */
     uint16_t uart_read_from_ring_buffer(uart_instance_t instance, uint8_t *buffer, uint16_t size);
     uint16_t uart_write_to_ring_buffer(uart_instance_t instance, const uint8_t *data, uint16_t size);
+    uint16_t uart_rx_peek(uart_instance_t instance, const uint8_t **data);
+    bool uart_rx_consume(uart_instance_t instance, uint16_t size);
+
+    /* 零拷贝发送：DMA直接从调用者的缓冲区发送，发送完成后调用release释放缓冲区 */
+    uart_err_t uart_send_zero_copy(uart_instance_t instance, const uint8_t *data, uint16_t size,
+                                   uart_tx_release_callback_t release, void *arg);
+    uint16_t uart_tx_queue_free(uart_instance_t instance);
+    uint32_t uart_get_rx_overrun_count(uart_instance_t instance);
     uart_err_t uart_get_ring_buffer_stats(uart_instance_t instance, uint16_t *rx_available, uint16_t *tx_available, uint16_t *rx_free_space);
 #endif
 
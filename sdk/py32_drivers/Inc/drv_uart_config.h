@@ -10,8 +10,8 @@
 
 /* 缓冲区配置 */
 #define RING_BUFFER_ENABLED
-#define UART_RX_BUFFER_SIZE 256  /* 接收缓冲区大小 */
-#define UART_TX_BUFFER_SIZE 256  /* 发送缓冲区大小 */
+#define UART_RX_BUFFER_SIZE 256  /* 接收环形缓冲区大小，2的幂且不超过32768 */
+#define UART_TX_BUFFER_SIZE 256  /* 发送环形缓冲区大小，2的幂且不超过32768 */
 #define UART_DMA_BUFFER_SIZE 256 /* DMA缓冲区大小，建议为2的幂次方 */
 
 /* DMA配置 (仅在DMA模式下有效) */
@@ -19,6 +19,15 @@
 #define UART_DMA_RX_TIMEOUT_MS 10                    /* DMA接收超时时间(ms) */
 #define UART_DMA_DEFAULT_MODE UART_DMA_MODE_CIRCULAR /* 默认DMA模式 */
 
+/* DMA直接接收到环形缓冲区：0：DMA接收到dma_rx_buffer，中断中复制到接收环形缓冲区；
+ * 1：循环DMA直接以接收环形缓冲区为目标，写入位置由DMA剩余计数得出，不再有中断中的复制，
+ *    也不占用dma_rx_buffer。读取方落后超过UART_RX_BUFFER_SIZE字节时丢弃未读数据并计入溢出次数。
+ *    接收总是使用循环模式 */
+#define UART_DMA_RX_DIRECT 0
+
+/* 零拷贝发送描述符队列深度，每个实例最多排队的uart_send_zero_copy()数据块数，2的幂且不超过128 */
+#define UART_TX_DESC_NUM 8
+
 /* 中断优先级配置 */
 #define UART_IRQ_PRIORITY 1         /* UART中断优先级 */
 #define UART_IRQ_SUB_PRIORITY 0     /* UART中断子优先级 */
@@ -42,11 +51,13 @@
 #define UART2_RX_DMA_STREAM DMA1_Stream5
 // 其他UART实例的DMA映射...
 #elif defined(PY32F403xD)
+/* 通道由drv_dma.c统一分配，NULL表示使用任意空闲通道；需要固定通道时填写如DMA1_Channel1，
+ * 通道已被其它外设占用时uart_init()返回UART_ERROR_DMA */
 #define UART1_TX_DMA_CHANNEL NULL
 #define UART1_RX_DMA_CHANNEL NULL
 
-#define UART2_TX_DMA_CHANNEL DMA1_Channel1
-#define UART2_RX_DMA_CHANNEL DMA1_Channel2
+#define UART2_TX_DMA_CHANNEL NULL
+#define UART2_RX_DMA_CHANNEL NULL
 
 #define UART3_TX_DMA_CHANNEL NULL
 #define UART3_RX_DMA_CHANNEL NULL
@@ -70,6 +81,18 @@
 #warning "HAL DMA module not enabled. DMA mode may not work properly."
 #endif
 
+#if (UART_RX_BUFFER_SIZE == 0) || ((UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1)) != 0) || (UART_RX_BUFFER_SIZE > 32768)
+#error "UART_RX_BUFFER_SIZE must be a power of two no larger than 32768"
+#endif
+
+#if (UART_TX_BUFFER_SIZE == 0) || ((UART_TX_BUFFER_SIZE & (UART_TX_BUFFER_SIZE - 1)) != 0) || (UART_TX_BUFFER_SIZE > 32768)
+#error "UART_TX_BUFFER_SIZE must be a power of two no larger than 32768"
+#endif
+
+#if (UART_TX_DESC_NUM == 0) || ((UART_TX_DESC_NUM & (UART_TX_DESC_NUM - 1)) != 0) || (UART_TX_DESC_NUM > 128)
+#error "UART_TX_DESC_NUM must be a power of two no larger than 128"
+#endif
+
 /* 检查环形缓冲区支持 */
 #ifndef RING_BUFFER_ENABLED
 #warning "Ring buffer support not enabled. Please include drv_tool.h"
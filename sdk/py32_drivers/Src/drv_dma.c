@@ -0,0 +1,314 @@
+#include "drv_dma.h"
+#include "drv_tool.h"
+#include <string.h>
+
+/* ==================== 类型定义和全局变量 ============================================ */
+/* 通道占用信息 */
+typedef struct
+{
+    DMA_HandleTypeDef *hdma;       // 占用通道的句柄，NULL表示空闲
+    uint32_t request;              // 映射到通道的外设请求 DMA_CHANNEL_MAP_xxx
+    drv_dma_irq_handler_t handler; // 中断处理函数，NULL时使用HAL_DMA_IRQHandler
+    void *arg;
+} drv_dma_owner_t;
+
+static drv_dma_owner_t drv_dma_owners[DRV_DMA_CHANNEL_NUM];
+
+/* 通道寄存器映射 */
+static DMA_Channel_TypeDef *const drv_dma_channels[DRV_DMA_CHANNEL_NUM] = {
+    DMA1_Channel1, DMA1_Channel2, DMA1_Channel3, DMA1_Channel4, DMA1_Channel5, DMA1_Channel6, DMA1_Channel7,
+    DMA2_Channel1, DMA2_Channel2, DMA2_Channel3, DMA2_Channel4, DMA2_Channel5};
+
+/* 通道中断号映射，DMA2通道4、5共用一个中断 */
+static const IRQn_Type drv_dma_irqs[DRV_DMA_CHANNEL_NUM] = {
+    DMA1_Channel1_IRQn, DMA1_Channel2_IRQn, DMA1_Channel3_IRQn, DMA1_Channel4_IRQn,
+    DMA1_Channel5_IRQn, DMA1_Channel6_IRQn, DMA1_Channel7_IRQn,
+    DMA2_Channel1_IRQn, DMA2_Channel2_IRQn, DMA2_Channel3_IRQn, DMA2_Channel4_5_IRQn, DMA2_Channel4_5_IRQn};
+
+/* ==================== 工具函数 ==================== */
+/* 查找句柄占用的通道，没有时返回DRV_DMA_CHANNEL_NUM */
+static uint8_t drv_dma_find_channel(const DMA_HandleTypeDef *hdma)
+{
+    uint8_t i;
+
+    for (i = 0; i < DRV_DMA_CHANNEL_NUM; i++)
+    {
+        if (drv_dma_owners[i].hdma == hdma)
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+/* 通道中断分发 */
+static void drv_dma_irq_dispatch(uint8_t index)
+{
+    drv_dma_owner_t *owner = &drv_dma_owners[index];
+
+    if (owner->hdma == NULL)
+    {
+        return;
+    }
+    if (owner->handler != NULL)
+    {
+        owner->handler(owner->hdma, owner->arg);
+    }
+    else
+    {
+        HAL_DMA_IRQHandler(owner->hdma);
+    }
+}
+
+/* ==================== DMA通道管理 ==================== */
+/**
+ * @brief 为外设请求申请DMA通道，设置hdma->Instance、映射请求并开启通道中断
+ * @param hdma: DMA句柄，申请成功后再调用HAL_DMA_Init
+ * @param request: 外设请求 DMA_CHANNEL_MAP_xxx
+ * @param channel: 指定通道，NULL时分配任意空闲通道
+ * @return DRV_DMA_OK, DRV_DMA_ERROR_PARAM, DRV_DMA_ERROR_NO_CHANNEL, DRV_DMA_ERROR_CONFLICT
+ */
+drv_dma_err_t drv_dma_request(DMA_HandleTypeDef *hdma, uint32_t request, DMA_Channel_TypeDef *channel)
+{
+    drv_irq_state_t state;
+    drv_dma_err_t ret = DRV_DMA_OK;
+    uint8_t index = DRV_DMA_CHANNEL_NUM;
+    uint8_t i;
+
+    if (hdma == NULL || request >= DMA_CHANNEL_MAP_END)
+    {
+        return DRV_DMA_ERROR_PARAM;
+    }
+
+    DRV_ENTER_CRITICAL(state);
+    for (i = 0; i < DRV_DMA_CHANNEL_NUM; i++)
+    {
+        if (drv_dma_owners[i].hdma == hdma)
+        {
+            ret = DRV_DMA_ERROR_CONFLICT; // 句柄已占用通道，需先释放
+            break;
+        }
+        if (drv_dma_owners[i].hdma != NULL && drv_dma_owners[i].request == request)
+        {
+            ret = DRV_DMA_ERROR_CONFLICT; // 同一外设请求映射到两个通道时两个通道都会被触发
+            break;
+        }
+        if (channel != NULL ? (drv_dma_channels[i] == channel)
+                            : (drv_dma_owners[i].hdma == NULL && index == DRV_DMA_CHANNEL_NUM))
+        {
+            index = i;
+        }
+    }
+    if (ret == DRV_DMA_OK)
+    {
+        if (index == DRV_DMA_CHANNEL_NUM)
+        {
+            ret = (channel != NULL) ? DRV_DMA_ERROR_PARAM : DRV_DMA_ERROR_NO_CHANNEL;
+        }
+        else if (drv_dma_owners[index].hdma != NULL)
+        {
+            ret = DRV_DMA_ERROR_CONFLICT;
+        }
+        else
+        {
+            drv_dma_owners[index].hdma = hdma;
+            drv_dma_owners[index].request = request;
+            drv_dma_owners[index].handler = NULL;
+            drv_dma_owners[index].arg = NULL;
+        }
+    }
+    DRV_EXIT_CRITICAL(state);
+
+    if (ret != DRV_DMA_OK)
+    {
+        return ret;
+    }
+
+    if (index < 7)
+    {
+        __HAL_RCC_DMA1_CLK_ENABLE();
+    }
+    else
+    {
+        __HAL_RCC_DMA2_CLK_ENABLE();
+    }
+
+    hdma->Instance = drv_dma_channels[index];
+    HAL_DMA_ChannelMap(hdma, request);
+
+    HAL_NVIC_SetPriority(drv_dma_irqs[index], DRV_DMA_IRQ_PRIORITY, DRV_DMA_IRQ_SUB_PRIORITY);
+    HAL_NVIC_EnableIRQ(drv_dma_irqs[index]);
+
+    return DRV_DMA_OK;
+}
+
+/**
+ * @brief 释放句柄占用的DMA通道，调用前应先停止传输(HAL_DMA_DeInit)
+ * @param hdma: DMA句柄
+ * @return DRV_DMA_OK, DRV_DMA_ERROR_PARAM(句柄未占用通道)
+ */
+drv_dma_err_t drv_dma_release(DMA_HandleTypeDef *hdma)
+{
+    drv_irq_state_t state;
+    uint8_t index;
+    uint8_t i;
+    bool irq_shared = false;
+
+    DRV_ENTER_CRITICAL(state);
+    index = drv_dma_find_channel(hdma);
+    if (hdma == NULL || index == DRV_DMA_CHANNEL_NUM)
+    {
+        DRV_EXIT_CRITICAL(state);
+        return DRV_DMA_ERROR_PARAM;
+    }
+    memset(&drv_dma_owners[index], 0, sizeof(drv_dma_owner_t));
+
+    /* 共用中断的其它通道仍在使用时保持中断开启 */
+    for (i = 0; i < DRV_DMA_CHANNEL_NUM; i++)
+    {
+        if (drv_dma_owners[i].hdma != NULL && drv_dma_irqs[i] == drv_dma_irqs[index])
+        {
+            irq_shared = true;
+        }
+    }
+    if (!irq_shared)
+    {
+        HAL_NVIC_DisableIRQ(drv_dma_irqs[index]);
+    }
+    DRV_EXIT_CRITICAL(state);
+
+    return DRV_DMA_OK;
+}
+
+/**
+ * @brief 设置通道中断处理函数，替代默认的HAL_DMA_IRQHandler
+ *        DMA2通道4、5共用中断，处理函数需自行检查本通道的中断标志
+ * @param hdma: 已申请通道的DMA句柄
+ * @param handler: 中断处理函数，NULL恢复为HAL_DMA_IRQHandler
+ * @param arg: 传给处理函数的参数
+ * @return DRV_DMA_OK, DRV_DMA_ERROR_PARAM
+ */
+drv_dma_err_t drv_dma_set_irq_handler(DMA_HandleTypeDef *hdma, drv_dma_irq_handler_t handler, void *arg)
+{
+    drv_irq_state_t state;
+    uint8_t index;
+
+    DRV_ENTER_CRITICAL(state);
+    index = drv_dma_find_channel(hdma);
+    if (hdma != NULL && index < DRV_DMA_CHANNEL_NUM)
+    {
+        drv_dma_owners[index].handler = handler;
+        drv_dma_owners[index].arg = arg;
+    }
+    DRV_EXIT_CRITICAL(state);
+
+    return (hdma != NULL && index < DRV_DMA_CHANNEL_NUM) ? DRV_DMA_OK : DRV_DMA_ERROR_PARAM;
+}
+
+/**
+ * @brief 设置句柄所占通道的中断优先级
+ * @param hdma: 已申请通道的DMA句柄
+ * @param preempt_priority: 抢占优先级
+ * @param sub_priority: 子优先级
+ * @return DRV_DMA_OK, DRV_DMA_ERROR_PARAM
+ */
+drv_dma_err_t drv_dma_set_irq_priority(DMA_HandleTypeDef *hdma, uint8_t preempt_priority, uint8_t sub_priority)
+{
+    uint8_t index = drv_dma_find_channel(hdma);
+
+    if (hdma == NULL || index == DRV_DMA_CHANNEL_NUM)
+    {
+        return DRV_DMA_ERROR_PARAM;
+    }
+
+    HAL_NVIC_DisableIRQ(drv_dma_irqs[index]);
+    HAL_NVIC_SetPriority(drv_dma_irqs[index], preempt_priority, sub_priority);
+    HAL_NVIC_EnableIRQ(drv_dma_irqs[index]);
+
+    return DRV_DMA_OK;
+}
+
+/**
+ * @brief 获取空闲通道数
+ * @return 空闲通道数
+ */
+uint8_t drv_dma_free_channels(void)
+{
+    uint8_t count = 0;
+    uint8_t i;
+
+    for (i = 0; i < DRV_DMA_CHANNEL_NUM; i++)
+    {
+        if (drv_dma_owners[i].hdma == NULL)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 查找占用外设请求的句柄，用于定位通道冲突
+ * @param request: 外设请求 DMA_CHANNEL_MAP_xxx
+ * @return 占用请求的DMA句柄，未占用时返回NULL
+ */
+DMA_HandleTypeDef *drv_dma_find_owner(uint32_t request)
+{
+    uint8_t i;
+
+    for (i = 0; i < DRV_DMA_CHANNEL_NUM; i++)
+    {
+        if (drv_dma_owners[i].hdma != NULL && drv_dma_owners[i].request == request)
+        {
+            return drv_dma_owners[i].hdma;
+        }
+    }
+    return NULL;
+}
+
+/* ==================== 中断处理函数 ==================== */
+void DMA1_Channel1_IRQHandler(void)
+{
+    drv_dma_irq_dispatch(0);
+}
+void DMA1_Channel2_IRQHandler(void)
+{
+    drv_dma_irq_dispatch(1);
+}
+void DMA1_Channel3_IRQHandler(void)
+{
+    drv_dma_irq_dispatch(2);
+}
+void DMA1_Channel4_IRQHandler(void)
+{
+    drv_dma_irq_dispatch(3);
+}
+void DMA1_Channel5_IRQHandler(void)
+{
+    drv_dma_irq_dispatch(4);
+}
+void DMA1_Channel6_IRQHandler(void)
+{
+    drv_dma_irq_dispatch(5);
+}
+void DMA1_Channel7_IRQHandler(void)
+{
+    drv_dma_irq_dispatch(6);
+}
+void DMA2_Channel1_IRQHandler(void)
+{
+    drv_dma_irq_dispatch(7);
+}
+void DMA2_Channel2_IRQHandler(void)
+{
+    drv_dma_irq_dispatch(8);
+}
+void DMA2_Channel3_IRQHandler(void)
+{
+    drv_dma_irq_dispatch(9);
+}
+void DMA2_Channel4_5_IRQHandler(void)
+{
+    drv_dma_irq_dispatch(10);
+    drv_dma_irq_dispatch(11);
+}
@@ -2,71 +2,92 @@
 #include <string.h>
 
 /* ========================= 环形缓冲区工具函数 =================================================== */
+/* 从计数pos开始的len字节复制到data，回绕时分两段memcpy */
+static void ring_buffer_copy_out(const ring_buffer_t *rb, uint16_t pos, uint8_t *data, uint16_t len)
+{
+    uint16_t index = pos & rb->mask;
+    uint16_t first = rb->size - index; // 到缓冲区末尾的连续字节数
+
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(data, rb->buffer + index, first);
+    memcpy(data + first, rb->buffer, len - first);
+}
+
 /**
  * @brief 初始化环形缓冲区
  * @param rb: 环形缓冲区指针
  * @param buffer: 存储缓冲区指针
- * @param size: 缓冲区大小
+ * @param size: 缓冲区大小，必须是2的幂，最大32768
  * @return true: 成功, false: 失败
  */
 bool ring_buffer_init(ring_buffer_t *rb, uint8_t *buffer, uint16_t size)
 {
-    if (rb == NULL || buffer == NULL || size == 0)
+    if (rb == NULL || buffer == NULL || size == 0 || (size & (size - 1)) != 0 || size > 0x8000U)
     {
         return false;
     }
 
     rb->buffer = buffer;
     rb->size = size;
+    rb->mask = size - 1;
     rb->head = 0;
     rb->tail = 0;
-    rb->count = 0;
 
     return true;
 }
 
 /**
- * @brief 向环形缓冲区放入一个字节
+ * @brief 向环形缓冲区放入一个字节（写入方调用）
  * @param rb: 环形缓冲区指针
  * @param data: 要放入的数据
  * @return true: 成功, false: 缓冲区已满
  */
 bool ring_buffer_put(ring_buffer_t *rb, uint8_t data)
 {
+    uint16_t head;
+
     if (rb == NULL || ring_buffer_is_full(rb))
     {
         return false;
     }
 
-    rb->buffer[rb->head] = data;
-    rb->head = (rb->head + 1) % rb->size;
-    rb->count++;
+    head = rb->head;
+    rb->buffer[head & rb->mask] = data;
+    DRV_MEMORY_BARRIER(); // 数据写入后再发布写入位置
+    rb->head = head + 1;
 
     return true;
 }
 
 /**
- * @brief 从环形缓冲区取出一个字节
+ * @brief 从环形缓冲区取出一个字节（读取方调用）
  * @param rb: 环形缓冲区指针
  * @param data: 存储取出的数据
  * @return true: 成功, false: 缓冲区为空
  */
 bool ring_buffer_get(ring_buffer_t *rb, uint8_t *data)
 {
+    uint16_t tail;
+
     if (rb == NULL || data == NULL || ring_buffer_is_empty(rb))
     {
         return false;
     }
 
-    *data = rb->buffer[rb->tail];
-    rb->tail = (rb->tail + 1) % rb->size;
-    rb->count--;
+    tail = rb->tail;
+    DRV_MEMORY_BARRIER(); // 读到写入位置后再读数据
+    *data = rb->buffer[tail & rb->mask];
+    DRV_MEMORY_BARRIER(); // 数据读出后再释放空间
+    rb->tail = tail + 1;
 
     return true;
 }
 
 /**
- * @brief 向环形缓冲区放入多个字节
+ * @brief 向环形缓冲区放入多个字节（写入方调用）
  * @param rb: 环形缓冲区指针
  * @param data: 数据指针
  * @param size: 数据大小
@@ -79,21 +100,26 @@ uint16_t ring_buffer_put_multiple(ring_buffer_t *rb, const uint8_t *data, uint16
         return 0;
     }
 
+    uint16_t head = rb->head;
     uint16_t free_space = ring_buffer_free_space(rb);
     uint16_t bytes_to_write = (size > free_space) ? free_space : size;
+    uint16_t index = head & rb->mask;
+    uint16_t first = rb->size - index; // 到缓冲区末尾的连续空间
 
-    for (uint16_t i = 0; i < bytes_to_write; i++)
+    if (first > bytes_to_write)
     {
-        rb->buffer[rb->head] = data[i];
-        rb->head = (rb->head + 1) % rb->size;
+        first = bytes_to_write;
     }
+    memcpy(rb->buffer + index, data, first);
+    memcpy(rb->buffer, data + first, bytes_to_write - first);
 
-    rb->count += bytes_to_write;
+    DRV_MEMORY_BARRIER(); // 数据写入后再发布写入位置
+    rb->head = head + bytes_to_write;
     return bytes_to_write;
 }
 
 /**
- * @brief 从环形缓冲区取出多个字节
+ * @brief 从环形缓冲区取出多个字节（读取方调用）
  * @param rb: 环形缓冲区指针
  * @param data: 存储数据的指针
  * @param size: 要取出的字节数
@@ -106,21 +132,19 @@ uint16_t ring_buffer_get_multiple(ring_buffer_t *rb, uint8_t *data, uint16_t siz
         return 0;
     }
 
+    uint16_t tail = rb->tail;
     uint16_t available = ring_buffer_available(rb);
     uint16_t bytes_to_read = (size > available) ? available : size;
 
-    for (uint16_t i = 0; i < bytes_to_read; i++)
-    {
-        data[i] = rb->buffer[rb->tail];
-        rb->tail = (rb->tail + 1) % rb->size;
-    }
-
-    rb->count -= bytes_to_read;
+    DRV_MEMORY_BARRIER(); // 读到写入位置后再读数据
+    ring_buffer_copy_out(rb, tail, data, bytes_to_read);
+    DRV_MEMORY_BARRIER(); // 数据读出后再释放空间
+    rb->tail = tail + bytes_to_read;
     return bytes_to_read;
 }
 
 /**
- * @brief 查看环形缓冲区中的数据（不移除）
+ * @brief 查看环形缓冲区中的数据（不移除，读取方调用）
  * @param rb: 环形缓冲区指针
  * @param data: 存储数据的指针
  * @param size: 要查看的字节数
@@ -142,32 +166,101 @@ uint16_t ring_buffer_peek_multiple(const ring_buffer_t *rb, uint8_t *data, uint1
 
     uint16_t bytes_to_peek = (size > (available - offset)) ? (available - offset) : size;
 
-    for (uint16_t i = 0; i < bytes_to_peek; i++)
-    {
-        uint16_t index = (rb->tail + offset + i) % rb->size;
-        data[i] = rb->buffer[index];
-    }
+    DRV_MEMORY_BARRIER(); // 读到写入位置后再读数据
+    ring_buffer_copy_out(rb, rb->tail + offset, data, bytes_to_peek);
 
     return bytes_to_peek;
 }
 
 /**
- * @brief 跳过指定数量的字节
+ * @brief 跳过指定数量的字节（读取方调用）
  * @param rb: 环形缓冲区指针
  * @param size: 要跳过的字节数
  */
 void ring_buffer_skip(ring_buffer_t *rb, uint16_t size)
+{
+    ring_buffer_consume(rb, size);
+}
+
+/**
+ * @brief 取得从写入位置开始的连续可写区域（写入方调用），填写后用ring_buffer_commit提交
+ * @param rb: 环形缓冲区指针
+ * @param data: 输出可写区域的起始地址
+ * @return 连续可写的字节数，到缓冲区末尾为止，0表示已满
+ */
+uint16_t ring_buffer_reserve(ring_buffer_t *rb, uint8_t **data)
+{
+    if (rb == NULL || data == NULL)
+    {
+        return 0;
+    }
+
+    uint16_t index = rb->head & rb->mask;
+    uint16_t free_space = ring_buffer_free_space(rb);
+    uint16_t linear = rb->size - index;
+
+    *data = rb->buffer + index;
+    return (free_space < linear) ? free_space : linear;
+}
+
+/**
+ * @brief 提交ring_buffer_reserve取得的区域中已填写的字节（写入方调用）
+ * @param rb: 环形缓冲区指针
+ * @param size: 已填写的字节数，超过剩余空间时截断
+ */
+void ring_buffer_commit(ring_buffer_t *rb, uint16_t size)
 {
     if (rb == NULL || size == 0)
     {
         return;
     }
 
+    uint16_t free_space = ring_buffer_free_space(rb);
+    uint16_t bytes_to_commit = (size > free_space) ? free_space : size;
+
+    DRV_MEMORY_BARRIER(); // 数据写入后再发布写入位置
+    rb->head = rb->head + bytes_to_commit;
+}
+
+/**
+ * @brief 取得从读取位置开始的连续可读区域，不移除数据（读取方调用），处理后用ring_buffer_consume释放
+ * @param rb: 环形缓冲区指针
+ * @param data: 输出可读区域的起始地址
+ * @return 连续可读的字节数，到缓冲区末尾为止，0表示为空
+ */
+uint16_t ring_buffer_peek_contiguous(const ring_buffer_t *rb, const uint8_t **data)
+{
+    if (rb == NULL || data == NULL)
+    {
+        return 0;
+    }
+
+    uint16_t index = rb->tail & rb->mask;
     uint16_t available = ring_buffer_available(rb);
-    uint16_t bytes_to_skip = (size > available) ? available : size;
+    uint16_t linear = rb->size - index;
 
-    rb->tail = (rb->tail + bytes_to_skip) % rb->size;
-    rb->count -= bytes_to_skip;
+    DRV_MEMORY_BARRIER(); // 读到写入位置后再读数据
+    *data = rb->buffer + index;
+    return (available < linear) ? available : linear;
+}
+
+/**
+ * @brief 释放已读取的字节（读取方调用）
+ * @param rb: 环形缓冲区指针
+ * @param size: 释放的字节数，超过可用数据时截断
+ */
+void ring_buffer_consume(ring_buffer_t *rb, uint16_t size)
+{
+    if (rb == NULL || size == 0)
+    {
+        return;
+    }
+
+    uint16_t available = ring_buffer_available(rb);
+    uint16_t bytes_to_consume = (size > available) ? available : size;
+
+    DRV_MEMORY_BARRIER(); // 之前的读取完成后再释放空间
+    rb->tail = rb->tail + bytes_to_consume;
 }
 
 /**
@@ -177,7 +270,7 @@ void ring_buffer_skip(ring_buffer_t *rb, uint16_t size)
  */
 uint16_t ring_buffer_available(const ring_buffer_t *rb)
 {
-    return (rb != NULL) ? rb->count : 0;
+    return (rb != NULL) ? (uint16_t)(rb->head - rb->tail) : 0;
 }
 
 /**
@@ -187,7 +280,7 @@ uint16_t ring_buffer_available(const ring_buffer_t *rb)
  */
 uint16_t ring_buffer_free_space(const ring_buffer_t *rb)
 {
-    return (rb != NULL) ? (rb->size - rb->count) : 0;
+    return (rb != NULL) ? (uint16_t)(rb->size - ring_buffer_available(rb)) : 0;
 }
 
 /**
@@ -197,7 +290,7 @@ uint16_t ring_buffer_free_space(const ring_buffer_t *rb)
  */
 bool ring_buffer_is_empty(const ring_buffer_t *rb)
 {
-    return (rb == NULL) ? true : (rb->count == 0);
+    return (rb == NULL) ? true : (rb->head == rb->tail);
 }
 
 /**
@@ -207,19 +300,22 @@ bool ring_buffer_is_empty(const ring_buffer_t *rb)
  */
 bool ring_buffer_is_full(const ring_buffer_t *rb)
 {
-    return (rb == NULL) ? true : (rb->count >= rb->size);
+    return (rb == NULL) ? true : (ring_buffer_available(rb) >= rb->size);
 }
 
 /**
- * @brief 清空环形缓冲区
+ * @brief 清空环形缓冲区（读写两端都停止时调用，读取方单独丢弃数据用ring_buffer_skip）
  * @param rb: 环形缓冲区指针
  */
 void ring_buffer_clear(ring_buffer_t *rb)
 {
+    drv_irq_state_t state;
+
     if (rb != NULL)
     {
+        DRV_ENTER_CRITICAL(state);
         rb->head = 0;
         rb->tail = 0;
-        rb->count = 0;
+        DRV_EXIT_CRITICAL(state);
     }
-}
\ No newline at end of file
+}
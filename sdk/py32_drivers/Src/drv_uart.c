@@ -1,8 +1,20 @@
 #include "drv_uart.h"
 #include "drv_tool.h"
+#include "drv_dma.h"
 #include <string.h>
 
 /* ==================== 类型定义和全局变量 ============================================ */
+#if (UART_USE_DMA == 1)
+/* 零拷贝发送描述符，指向调用者的缓冲区 */
+typedef struct
+{
+    const uint8_t *data;
+    uint16_t size;
+    uart_tx_release_callback_t release;
+    void *arg;
+} uart_tx_desc_t;
+#endif
+
 /* UART设备结构 */
 typedef struct
 {
@@ -43,7 +55,9 @@ typedef struct
     DMA_HandleTypeDef hdma_tx;
     DMA_HandleTypeDef hdma_rx;
 
+#if (UART_DMA_RX_DIRECT == 0)
     uint8_t dma_rx_buffer[UART_DMA_BUFFER_SIZE]; /* DMA接收缓冲区 */
+#endif
     uint8_t dma_tx_buffer[UART_DMA_BUFFER_SIZE]; /* DMA发送缓冲区 */
 
     /* DMA接收状态管理 */
@@ -53,13 +67,22 @@ typedef struct
     volatile bool dma_rx_full_handled;      /* 全满中断已处理标志 */
     bool dma_rx_circular_mode;              /* 循环模式标志 */
     bool dma_tx_busy;                       /* DMA发送忙标志 */
+    uint16_t dma_tx_ring_size;              /* 正在直接从发送环形缓冲区发送的字节数，发送完成后释放 */
+    bool dma_tx_desc_active;                /* 正在发送描述符队列头部的数据块 */
     bool dma_rx_busy;                       /* DMA接收忙标志 */
+    volatile bool dma_rx_overrun;           /* 中断中发现读取方落后一圈以上，由读取方处理 */
+    uint32_t rx_overrun_count;              /* 接收溢出次数 */
 
     /* 环形缓冲区 */
     ring_buffer_t rx_ring_buffer;
     ring_buffer_t tx_ring_buffer;
     uint8_t rx_software_buffer[UART_RX_BUFFER_SIZE];
     uint8_t tx_software_buffer[UART_TX_BUFFER_SIZE];
+
+    /* 零拷贝发送描述符队列：任务中提交(写入tx_desc_head)，发送完成中断中释放(写入tx_desc_tail) */
+    uart_tx_desc_t tx_desc[UART_TX_DESC_NUM];
+    volatile uint8_t tx_desc_head;
+    volatile uint8_t tx_desc_tail;
 #endif
 
 } uart_device_t;
@@ -94,7 +117,7 @@ static const uint32_t uart_dma_rx_channel_map[UART_INSTANCE_MAX] = {
     DMA_CHANNEL_MAP_USART4_RD,
     DMA_CHANNEL_MAP_USART5_RD};
 
-/* DMA通道映射数组定义 */
+/* 指定的DMA通道，NULL时由drv_dma分配空闲通道 */
 static const DMA_Channel_TypeDef *const uart_dma_tx_channels[UART_INSTANCE_MAX] = {
     UART1_TX_DMA_CHANNEL,
     UART2_TX_DMA_CHANNEL,
@@ -115,10 +138,16 @@ static uart_err_t uart_configure_irq_priority(uart_instance_t instance);
 /* DMA相关静态函数 */
 static uart_err_t uart_dma_init(uart_instance_t instance);
 static uart_err_t uart_dma_deinit(uart_instance_t instance);
+#if (UART_DMA_RX_DIRECT == 1)
+static uint16_t uart_dma_rx_sync(uart_device_t *dev);
+static bool uart_dma_rx_check_overrun(uart_device_t *dev, uint16_t tail);
+#else
 static void uart_dma_process_half_data(uart_instance_t instance);
 static void uart_dma_process_full_data(uart_instance_t instance);
 static uint16_t uart_dma_process_idle_data(uart_instance_t instance);
+#endif
 static uart_err_t uart_start_tx_from_ring_buffer(uart_instance_t instance);
+static bool uart_start_tx_from_desc_queue(uart_device_t *dev);
 #endif
 
 /* ==================== 工具函数 ==================== */
@@ -246,11 +275,22 @@ static uart_err_t uart_dma_init(uart_instance_t instance)
         return UART_ERROR_PARAM;
     }
 
-    __HAL_RCC_DMA1_CLK_ENABLE();
+    /* 申请DMA通道并映射请求，通道已被占用时返回错误 */
+    memset(&dev->hdma_tx, 0, sizeof(DMA_HandleTypeDef));
+    memset(&dev->hdma_rx, 0, sizeof(DMA_HandleTypeDef));
+    if (drv_dma_request(&dev->hdma_tx, uart_dma_tx_channel_map[instance],
+                        (DMA_Channel_TypeDef *)uart_dma_tx_channels[instance]) != DRV_DMA_OK)
+    {
+        return UART_ERROR_DMA;
+    }
+    if (drv_dma_request(&dev->hdma_rx, uart_dma_rx_channel_map[instance],
+                        (DMA_Channel_TypeDef *)uart_dma_rx_channels[instance]) != DRV_DMA_OK)
+    {
+        drv_dma_release(&dev->hdma_tx);
+        return UART_ERROR_DMA;
+    }
 
     /* 初始化TX DMA */
-    memset(&dev->hdma_tx, 0, sizeof(DMA_HandleTypeDef));
-    dev->hdma_tx.Instance = (DMA_Channel_TypeDef *)uart_dma_tx_channels[instance]; // 根据实例动态设置
     dev->hdma_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
     dev->hdma_tx.Init.PeriphInc = DMA_PINC_DISABLE;
     dev->hdma_tx.Init.MemInc = DMA_MINC_ENABLE;
@@ -261,6 +301,8 @@ static uart_err_t uart_dma_init(uart_instance_t instance)
 
     if (HAL_DMA_Init(&dev->hdma_tx) != HAL_OK)
     {
+        drv_dma_release(&dev->hdma_tx);
+        drv_dma_release(&dev->hdma_rx);
         return UART_ERROR_DMA;
     }
 
@@ -268,8 +310,6 @@ static uart_err_t uart_dma_init(uart_instance_t instance)
     __HAL_LINKDMA(&dev->huart, hdmatx, dev->hdma_tx);
 
     /* 初始化RX DMA - 配置为循环模式并开启中断 */
-    memset(&dev->hdma_rx, 0, sizeof(DMA_HandleTypeDef));
-    dev->hdma_rx.Instance = (DMA_Channel_TypeDef *)uart_dma_rx_channels[instance]; // 根据实例动态设置
     dev->hdma_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
     dev->hdma_rx.Init.PeriphInc = DMA_PINC_DISABLE;
     dev->hdma_rx.Init.MemInc = DMA_MINC_ENABLE;
@@ -281,24 +321,28 @@ static uart_err_t uart_dma_init(uart_instance_t instance)
     if (HAL_DMA_Init(&dev->hdma_rx) != HAL_OK)
     {
         HAL_DMA_DeInit(&dev->hdma_tx);
+        drv_dma_release(&dev->hdma_tx);
+        drv_dma_release(&dev->hdma_rx);
         return UART_ERROR_DMA;
     }
 
     __HAL_LINKDMA(&dev->huart, hdmarx, dev->hdma_rx);
 
-    /* 设置DMA映射请求 */
-    if (instance < UART_INSTANCE_MAX)
+    /* 初始化环形缓冲区 */
+    if (!ring_buffer_init(&dev->rx_ring_buffer, dev->rx_software_buffer, UART_RX_BUFFER_SIZE) ||
+        !ring_buffer_init(&dev->tx_ring_buffer, dev->tx_software_buffer, UART_TX_BUFFER_SIZE))
     {
-        HAL_DMA_ChannelMap(&dev->hdma_tx, uart_dma_tx_channel_map[instance]);
-        HAL_DMA_ChannelMap(&dev->hdma_rx, uart_dma_rx_channel_map[instance]);
+        HAL_DMA_DeInit(&dev->hdma_rx);
+        HAL_DMA_DeInit(&dev->hdma_tx);
+        drv_dma_release(&dev->hdma_tx);
+        drv_dma_release(&dev->hdma_rx);
+        return UART_ERROR_BUFFER;
     }
 
-    /* 初始化环形缓冲区 */
-    ring_buffer_init(&dev->rx_ring_buffer, dev->rx_software_buffer, UART_RX_BUFFER_SIZE);
-    ring_buffer_init(&dev->tx_ring_buffer, dev->tx_software_buffer, UART_TX_BUFFER_SIZE);
-
     /* 初始化DMA缓冲区 */
+#if (UART_DMA_RX_DIRECT == 0)
     memset(dev->dma_rx_buffer, 0, UART_DMA_BUFFER_SIZE);
+#endif
     memset(dev->dma_tx_buffer, 0, UART_DMA_BUFFER_SIZE);
 
     /* 初始化DMA接收状态 */
@@ -308,7 +352,13 @@ static uart_err_t uart_dma_init(uart_instance_t instance)
     dev->dma_rx_full_handled = false;
     dev->dma_rx_circular_mode = true;
     dev->dma_tx_busy = false;
+    dev->dma_tx_ring_size = 0;
+    dev->dma_tx_desc_active = false;
+    dev->tx_desc_head = 0;
+    dev->tx_desc_tail = 0;
     dev->dma_rx_busy = false;
+    dev->dma_rx_overrun = false;
+    dev->rx_overrun_count = 0;
 
     return UART_OK;
 }
@@ -329,6 +379,10 @@ static uart_err_t uart_dma_deinit(uart_instance_t instance)
     HAL_DMA_DeInit(&dev->hdma_tx);
     HAL_DMA_DeInit(&dev->hdma_rx);
 
+    /* 释放DMA通道 */
+    drv_dma_release(&dev->hdma_tx);
+    drv_dma_release(&dev->hdma_rx);
+
     return UART_OK;
 }
 
@@ -351,8 +405,13 @@ uart_err_t uart_dma_start_rx(uart_instance_t instance, uart_dma_mode_t mode)
     /* 停止之前的DMA接收 */
     HAL_UART_DMAStop(&dev->huart);
 
-    /* 配置DMA模式 */
+    /* 配置DMA模式，直接接收到环形缓冲区时总是循环模式 */
+#if (UART_DMA_RX_DIRECT == 1)
+    (void)mode;
+    dev->dma_rx_circular_mode = true;
+#else
     dev->dma_rx_circular_mode = (mode == UART_DMA_MODE_CIRCULAR);
+#endif
     dev->hdma_rx.Init.Mode = dev->dma_rx_circular_mode ? DMA_CIRCULAR : DMA_NORMAL;
 
     /* 重新初始化DMA */
@@ -368,6 +427,20 @@ uart_err_t uart_dma_start_rx(uart_instance_t instance, uart_dma_mode_t mode)
     dev->dma_rx_half_handled = false;
     dev->dma_rx_full_handled = false;
 
+#if (UART_DMA_RX_DIRECT == 1)
+    /* DMA已停止，从环形缓冲区起点重新接收 */
+    ring_buffer_clear(&dev->rx_ring_buffer);
+    dev->dma_rx_overrun = false;
+
+    /* 开启串口空闲中断 */
+    __HAL_UART_ENABLE_IT(&dev->huart, UART_IT_IDLE);
+
+    /* 启动DMA接收，直接写入接收环形缓冲区 */
+    if (HAL_UART_Receive_DMA(&dev->huart, dev->rx_software_buffer, UART_RX_BUFFER_SIZE) != HAL_OK)
+    {
+        return UART_ERROR_DMA;
+    }
+#else
     /* 清除DMA缓冲区 */
     memset(dev->dma_rx_buffer, 0, UART_DMA_BUFFER_SIZE);
 
@@ -379,6 +452,7 @@ uart_err_t uart_dma_start_rx(uart_instance_t instance, uart_dma_mode_t mode)
     {
         return UART_ERROR_DMA;
     }
+#endif
 
     dev->dma_rx_busy = true;
     return UART_OK;
@@ -410,15 +484,88 @@ uart_err_t uart_dma_stop_rx(uart_instance_t instance)
     return UART_OK;
 }
 
+#if (UART_DMA_RX_DIRECT == 1)
+/* DMA已写入接收环形缓冲区的字节计数，与head同样自由递增，包含尚未在中断中同步的部分 */
+static uint16_t uart_dma_rx_written(const uart_device_t *dev)
+{
+    const ring_buffer_t *rb = &dev->rx_ring_buffer;
+    uint16_t head = rb->head;
+    uint16_t pos;
+
+    /* 先读head再读DMA计数：读取之间中断同步了head时，pos只会领先旧的head，
+     * 反过来读则旧的pos会落后于新的head，相减后被当作领先了将近一圈 */
+    DRV_MEMORY_BARRIER();
+    pos = UART_RX_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(dev->huart.hdmarx);
+
+    /* 剩余计数在回绕时重装为UART_RX_BUFFER_SIZE，pos与head同为掩码后比较 */
+    return head + ((pos - head) & rb->mask);
+}
+
+/**
+ * @brief 把DMA写入位置同步为接收环形缓冲区的head（中断中调用），返回新接收的字节数
+ *        半满、全满中断保证两次同步之间DMA写入不超过一圈
+ */
+static uint16_t uart_dma_rx_sync(uart_device_t *dev)
+{
+    ring_buffer_t *rb = &dev->rx_ring_buffer;
+    drv_irq_state_t state;
+    uint16_t written;
+    uint16_t received;
+
+    /* 空闲中断与DMA半满/全满中断优先级不同，读改写head期间不能被另一方打断，否则会写回旧的head */
+    DRV_ENTER_CRITICAL(state);
+    written = uart_dma_rx_written(dev);
+    received = written - rb->head;
+
+    if (received != 0)
+    {
+        /* DMA已写入数据，直接发布写入位置，不经过ring_buffer_commit的剩余空间限制 */
+        DRV_MEMORY_BARRIER();
+        rb->head = written;
+        if ((uint16_t)(written - rb->tail) > UART_RX_BUFFER_SIZE)
+        {
+            dev->dma_rx_overrun = true;
+        }
+
+        dev->rx_total += received;
+    }
+    DRV_EXIT_CRITICAL(state);
+
+    return received;
+}
+
+/**
+ * @brief 检查读取位置tail之后的数据是否已被DMA覆盖（读取方调用）
+ *        已覆盖时丢弃全部未读数据、计入溢出次数并返回true，之后从DMA当前位置继续接收
+ */
+static bool uart_dma_rx_check_overrun(uart_device_t *dev, uint16_t tail)
+{
+    ring_buffer_t *rb = &dev->rx_ring_buffer;
+
+    if (!dev->dma_rx_overrun && (uint16_t)(uart_dma_rx_written(dev) - tail) <= UART_RX_BUFFER_SIZE)
+    {
+        return false;
+    }
+
+    dev->dma_rx_overrun = false;
+    dev->rx_overrun_count++;
+    ring_buffer_consume(rb, ring_buffer_available(rb));
+    return true;
+}
+#else
 /**
  * @brief 处理DMA半满中断数据
  */
 static void uart_dma_process_half_data(uart_instance_t instance)
 {
     uart_device_t *dev = &uart_devices[instance];
+    drv_irq_state_t state;
 
+    /* 空闲中断优先级更高，可能打断本函数写入接收环形缓冲区，两者互斥执行 */
+    DRV_ENTER_CRITICAL(state);
     if (dev->dma_rx_half_handled)
     {
+        DRV_EXIT_CRITICAL(state);
         return; // 已经处理过，避免重复处理
     }
 
@@ -433,6 +580,7 @@ static void uart_dma_process_half_data(uart_instance_t instance)
 
     /* 更新统计信息 */
     dev->rx_total += written;
+    DRV_EXIT_CRITICAL(state);
 }
 
 /**
@@ -441,9 +589,13 @@ static void uart_dma_process_half_data(uart_instance_t instance)
 static void uart_dma_process_full_data(uart_instance_t instance)
 {
     uart_device_t *dev = &uart_devices[instance];
+    drv_irq_state_t state;
 
+    /* 与半满处理相同，和空闲中断互斥执行 */
+    DRV_ENTER_CRITICAL(state);
     if (dev->dma_rx_full_handled)
     {
+        DRV_EXIT_CRITICAL(state);
         return; // 已经处理过，避免重复处理
     }
 
@@ -458,6 +610,7 @@ static void uart_dma_process_full_data(uart_instance_t instance)
 
     /* 更新统计信息 */
     dev->rx_total += written;
+    DRV_EXIT_CRITICAL(state);
 }
 
 /**
@@ -466,6 +619,10 @@ static void uart_dma_process_full_data(uart_instance_t instance)
 static uint16_t uart_dma_process_idle_data(uart_instance_t instance)
 {
     uart_device_t *dev = &uart_devices[instance];
+    drv_irq_state_t state;
+
+    /* 与半满、全满处理互斥执行，两者在不同优先级的中断中写入同一个接收环形缓冲区 */
+    DRV_ENTER_CRITICAL(state);
     uint16_t current_pos = sizeof(dev->dma_rx_buffer) - __HAL_DMA_GET_COUNTER(dev->huart.hdmarx);
     dev->dma_rx_current_pos = current_pos;
     uint16_t half_size = UART_DMA_BUFFER_SIZE / 2;
@@ -555,11 +712,14 @@ static uint16_t uart_dma_process_idle_data(uart_instance_t instance)
             dev->dma_rx_half_handled = false; // 前半部分有新数据，重置半满标志
         }
 
+        DRV_EXIT_CRITICAL(state);
         return written;
     }
 
+    DRV_EXIT_CRITICAL(state);
     return 0;
 }
+#endif
 /**
  * @brief 从环形缓冲区读取数据
  */
@@ -576,7 +736,80 @@ uint16_t uart_read_from_ring_buffer(uart_instance_t instance, uint8_t *buffer, u
     {
         return UART_ERROR_MODE;
     }
+#if (UART_DMA_RX_DIRECT == 1)
+    /* 复制前后各检查一次，复制过程中被DMA覆盖的数据也丢弃 */
+    uint16_t tail = dev->rx_ring_buffer.tail;
+    if (uart_dma_rx_check_overrun(dev, tail))
+    {
+        return 0;
+    }
+    uint16_t bytes_read = ring_buffer_peek_multiple(&dev->rx_ring_buffer, buffer, size, 0);
+    if (uart_dma_rx_check_overrun(dev, tail))
+    {
+        return 0;
+    }
+    ring_buffer_consume(&dev->rx_ring_buffer, bytes_read);
+    return bytes_read;
+#else
     return ring_buffer_get_multiple(&dev->rx_ring_buffer, buffer, size);
+#endif
+}
+
+/**
+ * @brief 取得接收环形缓冲区中的连续数据，不复制，返回连续字节数，处理后调用uart_rx_consume释放
+ *        数据在缓冲区末尾回绕时，释放后再调用一次取得剩余部分
+ */
+uint16_t uart_rx_peek(uart_instance_t instance, const uint8_t **data)
+{
+    if (!is_uart_initialized(instance) || data == NULL)
+    {
+        return 0;
+    }
+
+    uart_device_t *dev = &uart_devices[instance];
+    if (dev->mode != UART_MODE_DMA)
+    {
+        return 0;
+    }
+#if (UART_DMA_RX_DIRECT == 1)
+    uart_dma_rx_check_overrun(dev, dev->rx_ring_buffer.tail);
+#endif
+    return ring_buffer_peek_contiguous(&dev->rx_ring_buffer, data);
+}
+
+/**
+ * @brief 释放uart_rx_peek取得的已处理数据
+ *        返回false表示处理期间数据已被DMA覆盖(仅UART_DMA_RX_DIRECT)，处理结果应丢弃
+ */
+bool uart_rx_consume(uart_instance_t instance, uint16_t size)
+{
+    if (!is_uart_initialized(instance))
+    {
+        return false;
+    }
+
+    uart_device_t *dev = &uart_devices[instance];
+#if (UART_DMA_RX_DIRECT == 1)
+    if (uart_dma_rx_check_overrun(dev, dev->rx_ring_buffer.tail))
+    {
+        return false;
+    }
+#endif
+    ring_buffer_consume(&dev->rx_ring_buffer, size);
+    return true;
+}
+
+/**
+ * @brief 获取接收溢出次数(仅UART_DMA_RX_DIRECT时计数)
+ */
+uint32_t uart_get_rx_overrun_count(uart_instance_t instance)
+{
+    if (!is_uart_initialized(instance))
+    {
+        return 0;
+    }
+
+    return uart_devices[instance].rx_overrun_count;
 }
 
 /**
@@ -597,8 +830,8 @@ uint16_t uart_write_to_ring_buffer(uart_instance_t instance, const uint8_t *data
     }
     uint16_t written = ring_buffer_put_multiple(&dev->tx_ring_buffer, data, size);
 
-    /* 如果DMA发送空闲，自动启动发送 */
-    if (!dev->dma_tx_busy && written > 0)
+    /* 如果DMA发送空闲，自动启动发送，忙标志在启动函数的临界区内检查 */
+    if (written > 0)
     {
         uart_start_tx_from_ring_buffer(instance);
     }
@@ -606,6 +839,26 @@ uint16_t uart_write_to_ring_buffer(uart_instance_t instance, const uint8_t *data
     return written;
 }
 
+/**
+ * @brief 设置发送状态并启动DMA发送，ring_size为发送完成后需从环形缓冲区释放的字节数
+ *        状态在启动前设置，DMA立即完成时发送完成中断也能看到本次发送；调用方需持有临界区
+ */
+static bool uart_dma_tx_begin(uart_device_t *dev, const uint8_t *data, uint16_t size, uint16_t ring_size)
+{
+    dev->dma_tx_ring_size = ring_size;
+    dev->dma_tx_busy = true;
+    dev->tx_busy = true;
+
+    if (HAL_UART_Transmit_DMA(&dev->huart, (uint8_t *)data, size) != HAL_OK)
+    {
+        dev->dma_tx_ring_size = 0;
+        dev->dma_tx_busy = false;
+        dev->tx_busy = false;
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief 从环形缓冲区启动DMA发送
  */
@@ -622,36 +875,109 @@ static uart_err_t uart_start_tx_from_ring_buffer(uart_instance_t instance)
     {
         return UART_ERROR_MODE;
     }
-    /* 检查环形缓冲区是否为空 */
+
+    /* 与发送完成中断互斥，检查忙标志到启动DMA之间不能被其打断 */
+    drv_irq_state_t state;
+    uart_err_t ret = UART_OK;
+    DRV_ENTER_CRITICAL(state);
     if (dev->dma_tx_busy)
     {
-        return UART_ERROR_BUSY;
+        ret = UART_ERROR_BUSY;
     }
+    else
+    {
+        /* 取得环形缓冲区中的连续数据，DMA直接从环形缓冲区发送，回绕部分在发送完成后继续发送 */
+        const uint8_t *send_data;
+        uint16_t send_size = ring_buffer_peek_contiguous(&dev->tx_ring_buffer, &send_data);
+        if (send_size > 0 && !uart_dma_tx_begin(dev, send_data, send_size, send_size))
+        {
+            ret = UART_ERROR;
+        }
+    }
+    DRV_EXIT_CRITICAL(state);
+
+    return ret;
+}
 
-    /* 获取环形缓冲区中的数据量 */
-    uint16_t available_data = ring_buffer_available(&dev->tx_ring_buffer);
-    if (available_data == 0)
+/**
+ * @brief DMA发送空闲时发送描述符队列头部的数据块，返回是否已启动发送；调用方需持有临界区
+ */
+static bool uart_start_tx_from_desc_queue(uart_device_t *dev)
+{
+    if (dev->dma_tx_busy || dev->tx_desc_tail == dev->tx_desc_head)
     {
-        return UART_OK; // 没有数据可发送
+        return false;
     }
 
-    /* 计算实际发送大小（不超过DMA缓冲区大小） */
-    uint16_t send_size = (available_data > UART_DMA_BUFFER_SIZE) ? UART_DMA_BUFFER_SIZE : available_data;
+    DRV_MEMORY_BARRIER(); // 读到提交位置后再读描述符
+    const uart_tx_desc_t *desc = &dev->tx_desc[dev->tx_desc_tail & (UART_TX_DESC_NUM - 1)];
+    dev->dma_tx_desc_active = true;
+    if (!uart_dma_tx_begin(dev, desc->data, desc->size, 0))
+    {
+        dev->dma_tx_desc_active = false;
+        return false;
+    }
+    return true;
+}
 
-    /* 从环形缓冲区读取数据到DMA发送缓冲区 */
-    ring_buffer_peek_multiple(&dev->tx_ring_buffer, dev->dma_tx_buffer, send_size, 0);
+/**
+ * @brief 零拷贝发送，DMA直接从data发送，不受DMA缓冲区大小限制
+ *        data在release被调用前必须保持有效且不被修改，release在发送完成中断中调用，可以为NULL。
+ *        同一实例只能由一个任务提交；与环形缓冲区发送的数据之间不保证先后顺序，描述符队列优先。
+ * @return UART_OK, UART_ERROR_BUFFER(描述符队列已满)
+ */
+uart_err_t uart_send_zero_copy(uart_instance_t instance, const uint8_t *data, uint16_t size,
+                               uart_tx_release_callback_t release, void *arg)
+{
+    if (!is_uart_initialized(instance) || data == NULL || size == 0)
+    {
+        return UART_ERROR_PARAM;
+    }
 
-    /* 启动DMA发送 */
-    if (HAL_UART_Transmit_DMA(&dev->huart, dev->dma_tx_buffer, send_size) != HAL_OK)
+    uart_device_t *dev = &uart_devices[instance];
+    if (dev->mode != UART_MODE_DMA)
     {
-        return UART_ERROR;
+        return UART_ERROR_MODE;
     }
 
-    dev->dma_tx_busy = true;
-    dev->tx_busy = true;
+    uint8_t head = dev->tx_desc_head;
+    if ((uint8_t)(head - dev->tx_desc_tail) >= UART_TX_DESC_NUM)
+    {
+        return UART_ERROR_BUFFER;
+    }
+
+    uart_tx_desc_t *desc = &dev->tx_desc[head & (UART_TX_DESC_NUM - 1)];
+    desc->data = data;
+    desc->size = size;
+    desc->release = release;
+    desc->arg = arg;
+    DRV_MEMORY_BARRIER(); // 描述符写入后再提交
+    dev->tx_desc_head = head + 1;
+    dev->tx_total += size;
+
+    /* DMA空闲时立即启动，与发送完成中断互斥 */
+    drv_irq_state_t state;
+    DRV_ENTER_CRITICAL(state);
+    uart_start_tx_from_desc_queue(dev);
+    DRV_EXIT_CRITICAL(state);
+
     return UART_OK;
 }
 
+/**
+ * @brief 获取零拷贝发送描述符队列的剩余数量
+ */
+uint16_t uart_tx_queue_free(uart_instance_t instance)
+{
+    if (!is_uart_initialized(instance))
+    {
+        return 0;
+    }
+
+    uart_device_t *dev = &uart_devices[instance];
+    return UART_TX_DESC_NUM - (uint8_t)(dev->tx_desc_head - dev->tx_desc_tail);
+}
+
 /**
  * @brief 启动DMA发送
  */
@@ -668,8 +994,13 @@ uart_err_t uart_dma_start_tx(uart_instance_t instance, const uint8_t *data, uint
     {
         return UART_ERROR_MODE;
     }
+
+    /* 与发送完成中断互斥，剩余数据在中断接着发送环形缓冲区之前放入 */
+    drv_irq_state_t state;
+    DRV_ENTER_CRITICAL(state);
     if (dev->dma_tx_busy)
     {
+        DRV_EXIT_CRITICAL(state);
         return UART_ERROR_BUSY;
     }
 
@@ -680,13 +1011,11 @@ uart_err_t uart_dma_start_tx(uart_instance_t instance, const uint8_t *data, uint
     memcpy(dev->dma_tx_buffer, data, send_size);
 
     /* 启动DMA发送 */
-    if (HAL_UART_Transmit_DMA(&dev->huart, dev->dma_tx_buffer, send_size) != HAL_OK)
+    if (!uart_dma_tx_begin(dev, dev->dma_tx_buffer, send_size, 0))
     {
+        DRV_EXIT_CRITICAL(state);
         return UART_ERROR;
     }
-
-    dev->dma_tx_busy = true;
-    dev->tx_busy = true;
     dev->tx_total += send_size;
 
     /* 如果还有剩余数据，放入环形缓冲区 */
@@ -694,6 +1023,7 @@ uart_err_t uart_dma_start_tx(uart_instance_t instance, const uint8_t *data, uint
     {
         ring_buffer_put_multiple(&dev->tx_ring_buffer, data + send_size, size - send_size);
     }
+    DRV_EXIT_CRITICAL(state);
 
     return UART_OK;
 }
@@ -710,10 +1040,12 @@ uart_err_t uart_dma_stop_tx(uart_instance_t instance)
 
     uart_device_t *dev = &uart_devices[instance];
 
-    /* 停止DMA发送 */
+    /* 停止DMA发送，未发送完的环形缓冲区数据保留，下次从头发送 */
     HAL_UART_DMAStop(&dev->huart);
 
     dev->dma_tx_busy = false;
+    dev->dma_tx_ring_size = 0;
+    dev->dma_tx_desc_active = false;
     dev->tx_busy = false;
 
     return UART_OK;
@@ -793,10 +1125,8 @@ static uart_err_t uart_configure_irq_priority(uart_instance_t instance)
     uart_device_t *dev = &uart_devices[instance];
     if (dev->mode == UART_MODE_DMA)
     {
-        HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, UART_DMA_IRQ_PRIORITY, UART_DMA_IRQ_SUB_PRIORITY);
-        HAL_NVIC_SetPriority(DMA1_Channel2_IRQn, UART_DMA_IRQ_PRIORITY, UART_DMA_IRQ_SUB_PRIORITY);
-        HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
-        HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+        drv_dma_set_irq_priority(&dev->hdma_tx, UART_DMA_IRQ_PRIORITY, UART_DMA_IRQ_SUB_PRIORITY);
+        drv_dma_set_irq_priority(&dev->hdma_rx, UART_DMA_IRQ_PRIORITY, UART_DMA_IRQ_SUB_PRIORITY);
     }
     __HAL_UART_ENABLE_IT(&dev->huart, UART_IT_IDLE);
 #endif
@@ -839,15 +1169,13 @@ uart_err_t uart_set_dma_irq_priority(uart_instance_t instance, uint8_t preempt_p
         return UART_ERROR_PARAM;
     }
 
+    uart_device_t *dev = &uart_devices[instance];
+
     /* 设置TX DMA中断优先级 */
-    HAL_NVIC_DisableIRQ(DMA1_Channel1_IRQn);
-    HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, preempt_priority, sub_priority);
-    HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+    drv_dma_set_irq_priority(&dev->hdma_tx, preempt_priority, sub_priority);
 
     /* 设置RX DMA中断优先级 */
-    HAL_NVIC_DisableIRQ(DMA1_Channel2_IRQn);
-    HAL_NVIC_SetPriority(DMA1_Channel2_IRQn, preempt_priority, sub_priority);
-    HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+    drv_dma_set_irq_priority(&dev->hdma_rx, preempt_priority, sub_priority);
 
     return UART_OK;
 #else
@@ -996,33 +1324,17 @@ uart_err_t uart_send(uart_instance_t instance, const uint8_t *data, uint16_t siz
     case UART_MODE_DMA:
 
 #if (UART_USE_DMA == 1)
-        /* DMA模式 */
-        if (dev->dma_tx_busy)
-        {
-            /* 如果DMA忙，将数据写入环形缓冲区 */
-            uint16_t written = uart_write_to_ring_buffer(instance, data, size);
-            return (written == size) ? UART_OK : UART_ERROR_BUFFER;
-        }
-        else
+        /* DMA模式，DMA空闲时直接发送，忙标志在临界区内检查 */
         {
-            /* DMA空闲，直接发送 */
-            uint16_t send_size = (size > UART_DMA_BUFFER_SIZE) ? UART_DMA_BUFFER_SIZE : size;
-
-            /* 复制数据到DMA发送缓冲区 */
-            memcpy(dev->dma_tx_buffer, data, send_size);
-
-            HAL_StatusTypeDef status = HAL_UART_Transmit_DMA(&dev->huart, dev->dma_tx_buffer, send_size);
-            if (status == HAL_OK)
+            uart_err_t ret = uart_dma_start_tx(instance, data, size);
+            if (ret == UART_ERROR_BUSY)
+            {
+                /* 如果DMA忙，将数据写入环形缓冲区 */
+                uint16_t written = uart_write_to_ring_buffer(instance, data, size);
+                return (written == size) ? UART_OK : UART_ERROR_BUFFER;
+            }
+            if (ret == UART_OK)
             {
-                dev->tx_busy = true;
-                dev->dma_tx_busy = true;
-                dev->tx_total += send_size;
-
-                /* 如果还有剩余数据，放入环形缓冲区 */
-                if (size > send_size)
-                {
-                    ring_buffer_put_multiple(&dev->tx_ring_buffer, data + send_size, size - send_size);
-                }
                 return UART_OK;
             }
         }
@@ -1275,20 +1587,27 @@ const char *uart_get_instance_name(uart_instance_t instance)
 
 /* ====================================== HAL回调处理 ============================================ */
 
+/* DMA通道中断由drv_dma.c分发到各自的句柄 */
+void USART1_IRQHandler(void)
+{
+    HAL_UART_IRQHandler(&uart_devices[0].huart);
+}
 void USART2_IRQHandler(void)
 {
     HAL_UART_IRQHandler(&uart_devices[1].huart);
 }
-#if (UART_USE_DMA == 1)
-void DMA1_Channel1_IRQHandler(void)
+void USART3_IRQHandler(void)
 {
-    HAL_DMA_IRQHandler(uart_devices[1].huart.hdmatx);
+    HAL_UART_IRQHandler(&uart_devices[2].huart);
 }
-void DMA1_Channel2_IRQHandler(void)
+void USART4_IRQHandler(void)
 {
-    HAL_DMA_IRQHandler(uart_devices[1].huart.hdmarx);
+    HAL_UART_IRQHandler(&uart_devices[3].huart);
+}
+void USART5_IRQHandler(void)
+{
+    HAL_UART_IRQHandler(&uart_devices[4].huart);
 }
-#endif
 
 /* 发送完成回调 */
 void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
@@ -1303,15 +1622,34 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
 #if (UART_USE_DMA == 1)
             dev->dma_tx_busy = false;
 
-            /* 从环形缓冲区中移除已发送的数据 */
-            uint16_t sent_size = huart->TxXferSize;
-            ring_buffer_skip(&dev->tx_ring_buffer, sent_size);
+            /* 从环形缓冲区中释放已发送的数据，直接发送的数据不在环形缓冲区中 */
+            ring_buffer_consume(&dev->tx_ring_buffer, dev->dma_tx_ring_size);
+            dev->dma_tx_ring_size = 0;
+
+            /* 释放已发送的零拷贝数据块 */
+            if (dev->dma_tx_desc_active)
+            {
+                const uart_tx_desc_t *desc = &dev->tx_desc[dev->tx_desc_tail & (UART_TX_DESC_NUM - 1)];
+                uart_tx_release_callback_t release = desc->release;
+                const uint8_t *data = desc->data;
+                void *arg = desc->arg;
+
+                dev->dma_tx_desc_active = false;
+                dev->tx_desc_tail = dev->tx_desc_tail + 1;
+                if (release != NULL)
+                {
+                    release((uart_instance_t)i, data, arg);
+                }
+            }
 
-            /* 如果环形缓冲区中还有数据，继续发送 */
-            if (ring_buffer_available(&dev->tx_ring_buffer) > 0)
+            /* 接着发送下一个数据块，没有时发送环形缓冲区中的数据；更高优先级的中断也可能提交发送 */
+            drv_irq_state_t state;
+            DRV_ENTER_CRITICAL(state);
+            if (!uart_start_tx_from_desc_queue(dev) && ring_buffer_available(&dev->tx_ring_buffer) > 0)
             {
                 uart_start_tx_from_ring_buffer((uart_instance_t)i);
             }
+            DRV_EXIT_CRITICAL(state);
 #endif
 
             if (dev->tx_complete_callback != NULL)
@@ -1336,7 +1674,11 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
             dev->dma_rx_busy = false;
 
             /* 处理全满数据 */
+#if (UART_DMA_RX_DIRECT == 1)
+            uart_dma_rx_sync(dev);
+#else
             uart_dma_process_full_data((uart_instance_t)i);
+#endif
 #endif
 
             if (dev->rx_complete_callback != NULL)
@@ -1359,7 +1701,11 @@ void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef *huart)
 
 #if (UART_USE_DMA == 1)
             /* 处理半满数据 */
+#if (UART_DMA_RX_DIRECT == 1)
+            uart_dma_rx_sync(dev);
+#else
             uart_dma_process_half_data((uart_instance_t)i);
+#endif
 #endif
 
             if (dev->rx_half_complete_callback != NULL)
@@ -1385,6 +1731,8 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 
 #if (UART_USE_DMA == 1)
             dev->dma_tx_busy = false;
+            dev->dma_tx_ring_size = 0;
+            dev->dma_tx_desc_active = false;
             dev->dma_rx_busy = false;
 #endif
 
@@ -1408,7 +1756,11 @@ void HAL_UART_IdleFrameDetectCpltCallback(UART_HandleTypeDef *huart)
             uart_device_t *dev = &uart_devices[i];
 
             /* 计算空闲期间接收的数据量 */
+#if (UART_DMA_RX_DIRECT == 1)
+            uint16_t idle_data_size = uart_dma_rx_sync(dev);
+#else
             uint16_t idle_data_size = uart_dma_process_idle_data((uart_instance_t)i);
+#endif
 
             if (dev->dma_idle_callback != NULL && idle_data_size > 0)
             {
@@ -0,0 +1,18 @@
+#ifndef __PY32F4XX_HAL_H
+#define __PY32F4XX_HAL_H
+
+/* 主机端工具使用的py32f4xx_hal.h替身：无中断，临界区为空，只提供drv_tool.h用到的内核函数 */
+#include <stdint.h>
+
+#define __NVIC_PRIO_BITS 4
+
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t primask) { (void)primask; }
+static inline void __disable_irq(void) {}
+static inline uint32_t __get_BASEPRI(void) { return 0; }
+static inline void __set_BASEPRI(uint32_t basepri) { (void)basepri; }
+static inline void __set_BASEPRI_MAX(uint32_t basepri) { (void)basepri; }
+static inline void __ISB(void) {}
+static inline void __DMB(void) { __atomic_thread_fence(__ATOMIC_ACQ_REL); }
+
+#endif
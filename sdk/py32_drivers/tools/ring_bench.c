@@ -0,0 +1,185 @@
+/**
+ * @file ring_bench.c
+ * @brief 主机端drv_tool.c环形缓冲区性能测试，用法见说明.txt
+ *        gcc -O2 -Itools/host -IInc tools/ring_bench.c Src/drv_tool.c -lpthread -o ring_bench
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include "drv_tool.h"
+
+#define BENCH_SIZE 256U      // 缓冲区大小，与UART_RX_BUFFER_SIZE一致
+#define BENCH_BYTES 64000000U // 单项测试传递的字节数
+#define BENCH_CHUNK_MAX 128U
+
+static uint8_t bench_buf[BENCH_SIZE];
+static uint8_t bench_in[BENCH_CHUNK_MAX];
+static uint8_t bench_out[BENCH_CHUNK_MAX];
+static ring_buffer_t bench_rb;
+static volatile uint32_t bench_sink;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief 单线程交替写入、读取，每次chunk字节，chunk为1时使用单字节接口
+ * @return 每字节的纳秒数
+ */
+static double run_chunk(uint16_t chunk)
+{
+    uint32_t n;
+    uint16_t i;
+    uint8_t data;
+    double start;
+
+    ring_buffer_init(&bench_rb, bench_buf, BENCH_SIZE);
+    ring_buffer_put_multiple(&bench_rb, bench_in, 37); // 错开起点，让批量复制经常跨越缓冲区末尾
+
+    start = now_ns();
+    for (n = 0; n < BENCH_BYTES; n += chunk)
+    {
+        if (chunk == 1)
+        {
+            ring_buffer_put(&bench_rb, (uint8_t)n);
+            ring_buffer_get(&bench_rb, &data);
+            bench_sink += data;
+        }
+        else
+        {
+            ring_buffer_put_multiple(&bench_rb, bench_in, chunk);
+            ring_buffer_get_multiple(&bench_rb, bench_out, chunk);
+            bench_sink += bench_out[0];
+        }
+    }
+    for (i = 0; i < chunk && chunk > 1; i++)
+    {
+        bench_sink += bench_out[i];
+    }
+
+    return (now_ns() - start) / BENCH_BYTES;
+}
+
+/**
+ * @brief drv_uart.c发送路径：peek到DMA缓冲区后在发送完成时skip
+ * @return 每字节的纳秒数
+ */
+static double run_peek_skip(uint16_t chunk)
+{
+    uint32_t n;
+    double start;
+
+    ring_buffer_init(&bench_rb, bench_buf, BENCH_SIZE);
+    ring_buffer_put_multiple(&bench_rb, bench_in, 37);
+
+    start = now_ns();
+    for (n = 0; n < BENCH_BYTES; n += chunk)
+    {
+        ring_buffer_put_multiple(&bench_rb, bench_in, chunk);
+        ring_buffer_peek_multiple(&bench_rb, bench_out, chunk, 0);
+        ring_buffer_skip(&bench_rb, chunk);
+        bench_sink += bench_out[0];
+    }
+
+    return (now_ns() - start) / BENCH_BYTES;
+}
+
+#ifndef RING_BENCH_NO_THREADS
+/* 写入线程：按递增序列写入，模拟DMA中断 */
+static void *producer(void *arg)
+{
+    uint32_t seq = 0;
+    uint8_t chunk[48];
+    uint16_t len, i;
+
+    (void)arg;
+    while (seq < BENCH_BYTES / 8)
+    {
+        len = (uint16_t)(1 + seq % sizeof(chunk));
+        for (i = 0; i < len; i++)
+        {
+            chunk[i] = (uint8_t)(seq + i);
+        }
+        len = ring_buffer_put_multiple(&bench_rb, chunk, len);
+        seq += len;
+        if (len == 0)
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 写入、读取各一个线程，检查读出的字节顺序
+ * @return 顺序错误数
+ */
+static uint32_t run_threads(double *ns)
+{
+    pthread_t thread;
+    uint32_t seq = 0;
+    uint32_t errors = 0;
+    uint16_t len, i;
+    double start;
+
+    ring_buffer_init(&bench_rb, bench_buf, BENCH_SIZE);
+
+    start = now_ns();
+    pthread_create(&thread, NULL, producer, NULL);
+    while (seq < BENCH_BYTES / 8)
+    {
+        len = ring_buffer_get_multiple(&bench_rb, bench_out, (uint16_t)(1 + seq % 61));
+        for (i = 0; i < len; i++)
+        {
+            if (bench_out[i] != (uint8_t)(seq + i))
+            {
+                errors++;
+            }
+        }
+        seq += len;
+        if (len == 0)
+        {
+            sched_yield();
+        }
+    }
+    pthread_join(thread, NULL);
+    *ns = (now_ns() - start) / (BENCH_BYTES / 8);
+
+    return errors;
+}
+#endif
+
+int main(void)
+{
+    static const uint16_t chunks[] = {1, 4, 16, 64, 128};
+#ifndef RING_BENCH_NO_THREADS
+    uint32_t errors;
+    double ns;
+#endif
+    uint16_t i;
+
+    for (i = 0; i < sizeof(bench_in); i++)
+    {
+        bench_in[i] = (uint8_t)i;
+    }
+
+    for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++)
+    {
+        printf("{\"test\":\"put_get\",\"chunk\":%u,\"ns_per_byte\":%.3f}\n", chunks[i], run_chunk(chunks[i]));
+    }
+    printf("{\"test\":\"peek_skip\",\"chunk\":64,\"ns_per_byte\":%.3f}\n", run_peek_skip(64));
+
+#ifndef RING_BENCH_NO_THREADS
+    errors = run_threads(&ns);
+    printf("{\"test\":\"threads\",\"ns_per_byte\":%.3f,\"order_errors\":%lu}\n", ns, (unsigned long)errors);
+#endif
+    printf("{\"sink\":%lu}\n", (unsigned long)bench_sink);
+
+    return 0;
+}